@@ -26,6 +26,7 @@
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
 #include "base/plugins.h"
+#include "base/videoBenchmark.h"
 #include "base/version.h"
 
 #include "common/config-manager.h"
@@ -72,6 +73,9 @@ static const char HELP_STRING[] =
 	"  --gui-theme=THEME        Select GUI theme\n"
 	"  --themepath=PATH         Path to where GUI themes are stored\n"
 	"  --list-themes            Display list of all usable GUI themes\n"
+	"  --benchmark-video=PATH   Decode the video file, or the video files in the\n"
+	"                           directory (PATH) as fast as possible and display\n"
+	"                           the decoding speed\n"
 	"  -e, --music-driver=MODE  Select music driver (see README for details)\n"
 	"  -q, --language=LANG      Select language (en,de,fr,it,pt,es,jp,zh,kr,se,gb,\n"
 	"                           hb,ru,cz)\n"
@@ -506,6 +510,10 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_COMMAND("list-themes")
 			END_OPTION
 
+			DO_LONG_OPTION("benchmark-video")
+				return "benchmark-video";
+			END_OPTION
+
 			DO_LONG_OPTION("target-md5")
 			END_OPTION
 
@@ -901,6 +909,8 @@ Common::Error processSettings(Common::String &command, Common::StringMap &settin
 	} else if (command == "list-themes") {
 		listThemes();
 		return Common::kNoError;
+	} else if (command == "benchmark-video") {
+		return runVideoBenchmark(settings["benchmark-video"]);
 	} else if (command == "version") {
 		printf("%s\n", gScummVMFullVersion);
 		printf("Features compiled in: %s\n", gScummVMFeatures);
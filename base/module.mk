@@ -4,7 +4,8 @@ MODULE_OBJS := \
 	main.o \
 	commandLine.o \
 	plugins.o \
-	version.o
+	version.o \
+	videoBenchmark.o
 
 # Include common rules
 include $(srcdir)/rules.mk
@@ -0,0 +1,278 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+
+#include "base/videoBenchmark.h"
+
+#include "common/algorithm.h"
+#include "common/array.h"
+#include "common/fs.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/system.h"
+#include "common/debug.h"
+
+#include "audio/mixer_intern.h"
+
+#include "graphics/surface.h"
+
+#include "video/avi_decoder.h"
+#include "video/coktel_decoder.h"
+#include "video/dxa_decoder.h"
+#include "video/flic_decoder.h"
+#include "video/qt_decoder.h"
+#include "video/smk_decoder.h"
+
+#if defined(UNIX)
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+namespace Base {
+
+enum {
+	kAudioRate = 22050,
+	// The audio is mixed in steps of 10ms after each frame, up to the time
+	// the next frame is due, but never more than 100ms per frame
+	kAudioStep = kAudioRate / 100,
+	kMaxAudioSteps = 10
+};
+
+/** A timer with microsecond resolution, where available. */
+static uint32 getMicros() {
+#if defined(UNIX)
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+	return g_system->getMillis() * 1000;
+#endif
+}
+
+/** The peak memory usage of the process in KB, or 0 if it's unknown. */
+static uint32 getPeakMemory() {
+#if defined(UNIX)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#if defined(MACOSX)
+	// Given in bytes, instead of KB
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#else
+	return 0;
+#endif
+}
+
+static Video::VideoDecoder *createDecoder(const Common::String &fileName, Audio::Mixer *mixer, const char *&type) {
+	Common::String name = fileName;
+	name.toLowercase();
+
+	if (name.hasSuffix(".avi")) {
+		type = "AVI";
+		return new Video::AviDecoder(mixer);
+	} else if (name.hasSuffix(".dxa")) {
+		type = "DXA";
+		return new Video::DXADecoder();
+	} else if (name.hasSuffix(".fli") || name.hasSuffix(".flc")) {
+		type = "FLIC";
+		return new Video::FlicDecoder();
+	} else if (name.hasSuffix(".mov") || name.hasSuffix(".qt")) {
+		type = "QuickTime";
+		return new Video::QuickTimeDecoder(mixer);
+	} else if (name.hasSuffix(".smk")) {
+		type = "Smacker";
+		return new Video::SmackerDecoder(mixer);
+	}
+#if defined(ENABLE_GOB) || defined(ENABLE_SCI32) || defined(DYNAMIC_MODULES)
+	else if (name.hasSuffix(".imd")) {
+		type = "IMD";
+		return new Video::IMDDecoder(mixer);
+	} else if (name.hasSuffix(".vmd")) {
+		type = "VMD";
+		return new Video::VMDDecoder(mixer);
+	}
+#endif
+
+	return 0;
+}
+
+/** Compute the MD5 checksum of the visible part of a surface. */
+static void checksumSurface(const Graphics::Surface &surface, Common::Array<byte> &buffer, uint8 digest[16]) {
+	const uint32 lineSize = surface.w * surface.bytesPerPixel;
+
+	buffer.resize(lineSize * surface.h);
+	for (int y = 0; y < surface.h; y++)
+		memcpy(&buffer[y * lineSize], surface.getBasePtr(0, y), lineSize);
+
+	Common::MemoryReadStream stream(buffer.begin(), buffer.size());
+	Common::computeStreamMD5(stream, digest);
+}
+
+static Common::String digestToString(const uint8 digest[16]) {
+	Common::String str;
+	for (int i = 0; i < 16; i++)
+		str += Common::String::format("%02x", digest[i]);
+	return str;
+}
+
+/** The frame time at the given percentile, in milliseconds. */
+static double getPercentile(const Common::Array<uint32> &sortedTimes, uint percent) {
+	if (sortedTimes.empty())
+		return 0.0;
+
+	const uint index = MIN<uint>((sortedTimes.size() * percent) / 100, sortedTimes.size() - 1);
+	return sortedTimes[index] / 1000.0;
+}
+
+struct BenchmarkTotals {
+	uint videos;
+	uint32 frames;
+	uint32 decodeTime;
+};
+
+static void benchmarkVideo(const Common::FSNode &node, Audio::MixerImpl &mixer, BenchmarkTotals &totals) {
+	const char *type = 0;
+	Video::VideoDecoder *decoder = createDecoder(node.getName(), &mixer, type);
+	if (!decoder)
+		return;
+
+	printf("%s (%s)\n", node.getPath().c_str(), type);
+
+	uint32 startTime = getMicros();
+
+	Common::SeekableReadStream *stream = node.createReadStream();
+	if (!stream || !decoder->loadStream(stream)) {
+		printf("  Could not load the video\n");
+		delete decoder;
+		return;
+	}
+
+	const uint32 loadTime = getMicros() - startTime;
+
+	const int frameCount = decoder->getFrameCount();
+	Common::Array<uint32> frameTimes;
+	Common::Array<byte> frameDigests;
+	Common::Array<byte> buffer;
+	int16 audio[2 * kAudioStep];
+
+	uint32 decodeTime = 0;
+
+	// Some decoders only end once their audio did, so stop after the last
+	// frame ourselves
+	while (!decoder->endOfVideo() && decoder->getCurFrame() + 1 < frameCount) {
+		startTime = getMicros();
+		const Graphics::Surface *surface = decoder->decodeNextFrame();
+		const uint32 frameTime = getMicros() - startTime;
+
+		frameTimes.push_back(frameTime);
+		decodeTime += frameTime;
+
+		uint8 digest[16];
+		if (surface)
+			checksumSurface(*surface, buffer, digest);
+		else
+			memset(digest, 0, sizeof(digest));
+
+		debug(1, "  Frame %d: %.2f ms, %s", decoder->getCurFrame(), frameTime / 1000.0, digestToString(digest).c_str());
+
+		for (int i = 0; i < 16; i++)
+			frameDigests.push_back(digest[i]);
+
+		if (decoder->hasDirtyPalette()) {
+			const byte *palette = decoder->getPalette();
+			if (palette)
+				for (int i = 0; i < 256 * 3; i++)
+					frameDigests.push_back(palette[i]);
+		}
+
+		// Let the audio play up to the next frame
+		for (int i = 0; i < kMaxAudioSteps && decoder->getTimeToNextFrame() > 0; i++)
+			mixer.mixCallback((byte *)audio, sizeof(audio));
+	}
+
+	Common::sort(frameTimes.begin(), frameTimes.end());
+
+	Common::String checksum;
+	if (!frameDigests.empty()) {
+		Common::MemoryReadStream digestStream(frameDigests.begin(), frameDigests.size());
+		checksum = Common::computeStreamMD5AsString(digestStream);
+	}
+
+	printf("  %dx%d, %d bpp, %u of %d frames decoded\n", decoder->getWidth(), decoder->getHeight(),
+	       decoder->getPixelFormat().bytesPerPixel * 8, frameTimes.size(), frameCount);
+	printf("  Loading: %.2f ms, decoding: %.2f ms, %.1f fps\n", loadTime / 1000.0, decodeTime / 1000.0,
+	       decodeTime ? frameTimes.size() * 1000000.0 / decodeTime : 0.0);
+	printf("  Frame times: median %.2f ms, 95%% %.2f ms, 99%% %.2f ms, max %.2f ms\n",
+	       getPercentile(frameTimes, 50), getPercentile(frameTimes, 95), getPercentile(frameTimes, 99), getPercentile(frameTimes, 100));
+	printf("  Peak memory: %u KB\n", getPeakMemory());
+	printf("  Checksum: %s\n", checksum.c_str());
+
+	delete decoder;
+
+	totals.videos++;
+	totals.frames += frameTimes.size();
+	totals.decodeTime += decodeTime;
+}
+
+Common::Error runVideoBenchmark(const Common::String &path) {
+	Common::FSNode node(path);
+	if (!node.exists()) {
+		printf("'%s' does not exist\n", path.c_str());
+		return Common::kPathDoesNotExist;
+	}
+
+	Common::FSList files;
+	if (node.isDirectory()) {
+		if (!node.getChildren(files, Common::FSNode::kListFilesOnly))
+			return Common::kReadingFailed;
+		Common::sort(files.begin(), files.end());
+	} else {
+		files.push_back(node);
+	}
+
+	Audio::MixerImpl mixer(g_system, kAudioRate);
+	mixer.setReady(true);
+
+	BenchmarkTotals totals;
+	memset(&totals, 0, sizeof(totals));
+
+	for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file)
+		benchmarkVideo(*file, mixer, totals);
+
+	if (totals.videos == 0) {
+		printf("No supported videos found in '%s'\n", path.c_str());
+		return Common::kNoGameDataFoundError;
+	}
+
+	printf("%u videos, %u frames decoded in %.2f ms, %.1f fps\n", totals.videos, totals.frames, totals.decodeTime / 1000.0,
+	       totals.decodeTime ? totals.frames * 1000000.0 / totals.decodeTime : 0.0);
+
+	return Common::kNoError;
+}
+
+} // End of namespace Base
@@ -0,0 +1,49 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+
+#ifndef BASE_VIDEOBENCHMARK_H
+#define BASE_VIDEOBENCHMARK_H
+
+#include "common/str.h"
+#include "common/error.h"
+
+namespace Base {
+
+/**
+ * Decode a video file, or all the video files in a directory, as fast as
+ * possible. For each video, the decoding speed, the time taken by the
+ * frames, the peak memory usage and a checksum of all the frames is
+ * printed, so that changes in the decoders can be measured and checked
+ * for regressions.
+ *
+ * The decoders get a mixer of their own, which isn't connected to the
+ * audio output, so that no backend has to be initialized.
+ */
+Common::Error runVideoBenchmark(const Common::String &path);
+
+} // End of namespace Base
+
+#endif
@@ -48,6 +48,56 @@ bool uncompress(byte *dst, unsigned long *dstLen, const byte *src, unsigned long
 	return Z_OK == ::uncompress(dst, dstLen, src, srcLen);
 }
 
+Inflater::Inflater() {
+	_stream = new z_stream;
+
+	_stream->zalloc = Z_NULL;
+	_stream->zfree = Z_NULL;
+	_stream->opaque = Z_NULL;
+	_stream->next_in = Z_NULL;
+	_stream->avail_in = 0;
+
+	_initialized = (inflateInit(_stream) == Z_OK);
+}
+
+Inflater::~Inflater() {
+	if (_initialized)
+		inflateEnd(_stream);
+
+	delete _stream;
+}
+
+bool Inflater::decompress(byte *dst, unsigned long *dstLen, ReadStream &src, uint32 srcLen) {
+	if (!_initialized || inflateReset(_stream) != Z_OK) {
+		*dstLen = 0;
+		return false;
+	}
+
+	_stream->next_in = _buffer;
+	_stream->avail_in = 0;
+	_stream->next_out = dst;
+	_stream->avail_out = *dstLen;
+
+	int err = Z_OK;
+	while (err == Z_OK) {
+		// Feed the next piece of the compressed data
+		if (_stream->avail_in == 0) {
+			uint32 len = src.read(_buffer, MIN<uint32>(srcLen, kBufferSize));
+			if (len == 0)
+				break;
+
+			srcLen -= len;
+			_stream->next_in = _buffer;
+			_stream->avail_in = len;
+		}
+
+		err = inflate(_stream, Z_NO_FLUSH);
+	}
+
+	*dstLen = _stream->total_out;
+	return err == Z_STREAM_END;
+}
+
 /**
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other SeekableReadStream and will then provide on-the-fly decompression support.
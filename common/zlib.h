@@ -27,9 +27,15 @@
 #define COMMON_ZLIB_H
 
 #include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+#if defined(USE_ZLIB)
+struct z_stream_s;
+#endif
 
 namespace Common {
 
+class ReadStream;
 class SeekableReadStream;
 class WriteStream;
 
@@ -44,6 +50,39 @@ class WriteStream;
  */
 bool uncompress(byte *dst, unsigned long *dstLen, const byte *src, unsigned long srcLen);
 
+/**
+ * A zlib decompressor, which can be used for many compressed blocks in a
+ * row without setting up zlib again each time. The compressed data is read
+ * from a stream in small pieces, so it never has to be buffered whole.
+ */
+class Inflater : NonCopyable {
+public:
+	Inflater();
+	~Inflater();
+
+	/**
+	 * Decompress a block of zlib compressed data.
+	 *
+	 * @param dst     the buffer to decompress into
+	 * @param dstLen  the size of the buffer, set to the number of bytes
+	 *                decompressed
+	 * @param src     the stream to read the compressed data from
+	 * @param srcLen  the size of the compressed data. At most that much is
+	 *                read from the stream.
+	 * @return true if the whole block was decompressed, false otherwise
+	 */
+	bool decompress(byte *dst, unsigned long *dstLen, ReadStream &src, uint32 srcLen);
+
+private:
+	enum {
+		kBufferSize = 4096
+	};
+
+	z_stream_s *_stream;
+	bool _initialized;
+	byte _buffer[kBufferSize];
+};
+
 #endif
 
 /**
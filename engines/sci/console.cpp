@@ -61,6 +61,7 @@
 #endif
 
 #include "common/file.h"
+#include "common/memstream.h"
 #include "common/savefile.h"
 
 #include "engines/util.h"
@@ -75,7 +76,7 @@ bool g_debug_track_mouse_clicks = false;
 static int parse_reg_t(EngineState *s, const char *str, reg_t *dest, bool mayBeValue);
 
 Console::Console(SciEngine *engine) : GUI::Debugger(),
-	_engine(engine), _debugState(engine->_debugState) {
+	_engine(engine), _debugState(engine->_debugState), _snapshot(0) {
 
 	// Variables
 	DVar_Register("sleeptime_factor",	&g_debug_sleeptime_factor, DVAR_INT, 0);
@@ -91,6 +92,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("opcodes",			WRAP_METHOD(Console, cmdOpcodes));
 	DCmd_Register("selector",			WRAP_METHOD(Console, cmdSelector));
 	DCmd_Register("selectors",			WRAP_METHOD(Console, cmdSelectors));
+	DCmd_Register("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
 	DCmd_Register("functions",			WRAP_METHOD(Console, cmdKernelFunctions));
 	DCmd_Register("class_table",		WRAP_METHOD(Console, cmdClassTable));
 	// Parser
@@ -108,12 +110,15 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	DCmd_Register("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	DCmd_Register("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	DCmd_Register("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	DCmd_Register("list",				WRAP_METHOD(Console, cmdList));
 	DCmd_Register("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	DCmd_Register("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
 	// Game
 	DCmd_Register("save_game",			WRAP_METHOD(Console, cmdSaveGame));
 	DCmd_Register("restore_game",		WRAP_METHOD(Console, cmdRestoreGame));
+	DCmd_Register("snapshot",			WRAP_METHOD(Console, cmdSnapshot));
+	DCmd_Register("restore_snapshot",	WRAP_METHOD(Console, cmdRestoreSnapshot));
 	DCmd_Register("restart_game",		WRAP_METHOD(Console, cmdRestartGame));
 	DCmd_Register("version",			WRAP_METHOD(Console, cmdGetVersion));
 	DCmd_Register("room",				WRAP_METHOD(Console, cmdRoomNumber));
@@ -124,6 +129,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("set_palette",		WRAP_METHOD(Console, cmdSetPalette));
 	DCmd_Register("draw_pic",			WRAP_METHOD(Console, cmdDrawPic));
 	DCmd_Register("draw_cel",			WRAP_METHOD(Console, cmdDrawCel));
+	DCmd_Register("cel_cache",			WRAP_METHOD(Console, cmdCelCache));
 	DCmd_Register("undither",           WRAP_METHOD(Console, cmdUndither));
 	DCmd_Register("pic_visualize",		WRAP_METHOD(Console, cmdPicVisualize));
 	DCmd_Register("play_video",         WRAP_METHOD(Console, cmdPlayVideo));
@@ -140,6 +146,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("segkill",			WRAP_METHOD(Console, cmdKillSegment));			// alias
 	// Garbage collection
 	DCmd_Register("gc",					WRAP_METHOD(Console, cmdGCInvoke));
+	DCmd_Register("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	DCmd_Register("gc_objects",			WRAP_METHOD(Console, cmdGCObjects));
 	DCmd_Register("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	DCmd_Register("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
@@ -226,6 +233,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 }
 
 Console::~Console() {
+	delete _snapshot;
 }
 
 void Console::preEnter() {
@@ -323,6 +331,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" opcodes - Lists the opcode names\n");
 	DebugPrintf(" selectors - Lists the selector names\n");
 	DebugPrintf(" selector - Attempts to find the requested selector by name\n");
+	DebugPrintf(" selector_cache - Shows the hit rate of the selector lookup cache\n");
 	DebugPrintf(" functions - Lists the kernel functions\n");
 	DebugPrintf(" class_table - Shows the available classes\n");
 	DebugPrintf("\n");
@@ -342,6 +351,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	DebugPrintf(" resource_info - Shows info about a resource\n");
 	DebugPrintf(" resource_types - Shows the valid resource types\n");
+	DebugPrintf(" resource_cache - Shows the statistics of the resource cache, or changes its size\n");
 	DebugPrintf(" list - Lists all the resources of a given type\n");
 	DebugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	DebugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
@@ -349,6 +359,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf("Game:\n");
 	DebugPrintf(" save_game - Saves the current game state to the hard disk\n");
 	DebugPrintf(" restore_game - Restores a saved game from the hard disk\n");
+	DebugPrintf(" snapshot - Saves the current game state in memory\n");
+	DebugPrintf(" restore_snapshot - Restores the game state saved with snapshot\n");
 	DebugPrintf(" list_saves - List all saved games including filenames\n");
 	DebugPrintf(" restart_game - Restarts the game\n");
 	DebugPrintf(" version - Shows the resource and interpreter versions\n");
@@ -360,6 +372,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" set_palette - Sets a palette resource\n");
 	DebugPrintf(" draw_pic - Draws a pic resource\n");
 	DebugPrintf(" draw_cel - Draws a cel from a view resource\n");
+	DebugPrintf(" cel_cache - Shows the statistics of the decoded cel cache, or changes its size\n");
 	DebugPrintf(" pic_visualize - Enables visualization of the drawing process of EGA pictures\n");
 	DebugPrintf(" undither - Enable/disable undithering\n");
 	DebugPrintf(" play_video - Plays a SEQ, AVI, VMD, RBT or DUK video\n");
@@ -372,6 +385,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf("\n");
 	DebugPrintf("Garbage collection:\n");
 	DebugPrintf(" gc - Invokes the garbage collector\n");
+	DebugPrintf(" gc_stats - Shows how long the garbage collector took, and how much it freed\n");
 	DebugPrintf(" gc_objects - Lists all reachable objects, normalized\n");
 	DebugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	DebugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
@@ -530,6 +544,30 @@ bool Console::cmdSelector(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+		DebugPrintf("Shows the hit rate of the selector lookup cache\n");
+		DebugPrintf("Usage: %s [reset]\n", argv[0]);
+		DebugPrintf("With \"reset\", the counters are set back to zero\n");
+		return true;
+	}
+
+	SegManager *segMan = _engine->_gamestate->_segMan;
+
+	const uint32 hits = segMan->_selectorLookupHits;
+	const uint32 lookups = hits + segMan->_selectorLookupMisses;
+
+	DebugPrintf("%u lookups, %u found in the cache (%.1f%%), %u cached selectors\n", lookups, hits,
+	            lookups ? hits * 100.0 / lookups : 0.0, segMan->_selectorLookups.size());
+
+	if (argc == 2) {
+		segMan->_selectorLookupHits = 0;
+		segMan->_selectorLookupMisses = 0;
+	}
+
+	return true;
+}
+
 bool Console::cmdSelectors(int argc, const char **argv) {
 	DebugPrintf("Selector names in numeric order:\n");
 	Common::String selectorName;
@@ -781,6 +819,37 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	if (argc > 3 || (argc == 2 && strcmp(argv[1], "reset")) || (argc == 3 && strcmp(argv[1], "size"))) {
+		DebugPrintf("Shows the statistics of the resource cache, or changes its size\n");
+		DebugPrintf("Usage: %s [reset | size <kilobytes>]\n", argv[0]);
+		DebugPrintf("With \"reset\", the counters are set back to zero\n");
+		return true;
+	}
+
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc == 3) {
+		resMan->setMaxMemoryLRU(strtol(argv[2], NULL, 10) * 1024);
+		return true;
+	}
+
+	const ResourceManager::CacheStats &stats = resMan->getCacheStats();
+	const uint32 lookups = stats.hits + stats.misses;
+
+	DebugPrintf("%u lookups, %u found in memory (%.1f%%), %u loaded (%u bytes)\n", lookups, stats.hits,
+	            lookups ? stats.hits * 100.0 / lookups : 0.0, stats.misses, stats.bytesDecompressed);
+	DebugPrintf("%u freed, %u prefetched (room prefetching is %s)\n", stats.evictions, stats.prefetches,
+	            resMan->getRoomPrefetching() ? "on" : "off");
+	DebugPrintf("Cached: %d of %d bytes, locked: %d bytes\n", resMan->getMemoryLRU(),
+	            resMan->getMaxMemoryLRU(), resMan->getMemoryLocked());
+
+	if (argc == 2)
+		resMan->resetCacheStats();
+
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		DebugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -1214,6 +1283,52 @@ bool Console::cmdRestoreGame(int argc, const char **argv) {
 	return Cmd_Exit(0, 0);
 }
 
+bool Console::cmdSnapshot(int argc, const char **argv) {
+	if (argc != 1) {
+		DebugPrintf("Saves the current game state in memory, replacing the previous snapshot\n");
+		DebugPrintf("Usage: %s\n", argv[0]);
+		return true;
+	}
+
+	Common::MemoryWriteStreamDynamic *snapshot = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+	uint32 startTime = g_system->getMillis();
+
+	if (!gamestate_snapshot(_engine->_gamestate, snapshot)) {
+		DebugPrintf("Taking the snapshot failed\n");
+		delete snapshot;
+		return true;
+	}
+
+	delete _snapshot;
+	_snapshot = snapshot;
+	DebugPrintf("Snapshot taken: %d bytes in %d ms\n", _snapshot->size(), g_system->getMillis() - startTime);
+
+	return true;
+}
+
+bool Console::cmdRestoreSnapshot(int argc, const char **argv) {
+	if (argc != 1) {
+		DebugPrintf("Restores the game state saved with snapshot\n");
+		DebugPrintf("Usage: %s\n", argv[0]);
+		return true;
+	}
+
+	if (!_snapshot) {
+		DebugPrintf("No snapshot has been taken\n");
+		return true;
+	}
+
+	Common::MemoryReadStream in(_snapshot->getData(), _snapshot->size());
+	gamestate_restore(_engine->_gamestate, &in);
+
+	if (_engine->_gamestate->r_acc == make_reg(0, 1)) {
+		DebugPrintf("Restoring the snapshot failed.\n");
+		return true;
+	}
+
+	return Cmd_Exit(0, 0);
+}
+
 bool Console::cmdRestartGame(int argc, const char **argv) {
 	_engine->_gamestate->abortScriptProcessing = kAbortRestartGame;
 
@@ -1524,6 +1639,38 @@ bool Console::cmdDrawCel(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdCelCache(int argc, const char **argv) {
+	if (argc > 3 || (argc == 2 && strcmp(argv[1], "reset")) || (argc == 3 && strcmp(argv[1], "size"))) {
+		DebugPrintf("Shows the statistics of the decoded cel cache, or changes its size\n");
+		DebugPrintf("Usage: %s [reset | size <kilobytes>]\n", argv[0]);
+		DebugPrintf("With \"reset\", the counters are set back to zero\n");
+		return true;
+	}
+
+	GfxCache *cache = _engine->_gfxCache;
+
+	if (argc == 3) {
+		cache->setMaxCelMemory(strtol(argv[2], NULL, 10) * 1024);
+		return true;
+	}
+
+	const GfxCache::CelCacheStats &stats = cache->getCelCacheStats();
+	const uint32 lookups = stats.hits + stats.misses;
+	const uint32 scaledLookups = stats.scaledHits + stats.scaledMisses;
+
+	DebugPrintf("%u cel lookups, %u already decoded (%.1f%%)\n", lookups, stats.hits,
+	            lookups ? stats.hits * 100.0 / lookups : 0.0);
+	DebugPrintf("%u scaled cel lookups, %u already scaled (%.1f%%)\n", scaledLookups, stats.scaledHits,
+	            scaledLookups ? stats.scaledHits * 100.0 / scaledLookups : 0.0);
+	DebugPrintf("%u freed, cached: %u cels, %u of %u bytes\n", stats.evictions, cache->getCelCount(),
+	            cache->getCelMemory(), cache->getMaxCelMemory());
+
+	if (argc == 2)
+		cache->resetCelCacheStats();
+
+	return true;
+}
+
 bool Console::cmdUndither(int argc, const char **argv) {
 	if (argc != 2) {
 		DebugPrintf("Enable/disable undithering.\n");
@@ -1993,6 +2140,32 @@ bool Console::cmdGCInvoke(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+		DebugPrintf("Shows how long the garbage collector took, and how much it freed\n");
+		DebugPrintf("Usage: %s [reset]\n", argv[0]);
+		DebugPrintf("With \"reset\", the counters are set back to zero\n");
+		return true;
+	}
+
+	GCState &gc = _engine->_gamestate->_gcState;
+
+	DebugPrintf("%u collections, %u reachable addresses in the last one, %u addresses freed\n",
+	            gc.collections, gc.lastReachable, gc.freed);
+	DebugPrintf("Marking: last %u ms, max %u ms, total %u ms\n", gc.lastMarkTime, gc.maxMarkTime, gc.totalMarkTime);
+	DebugPrintf("Freeing: last %u ms, max %u ms, total %u ms in %u steps\n", gc.lastSweepTime, gc.maxSweepTime,
+	            gc.totalSweepTime, gc.sweepSteps);
+	if (gc.maxPause)
+		DebugPrintf("Time limit: %u ms, %u addresses waiting to be freed\n", gc.maxPause, gc.pendingGarbage.size());
+	else
+		DebugPrintf("No time limit\n");
+
+	if (argc == 2)
+		gc.resetStats();
+
+	return true;
+}
+
 bool Console::cmdGCObjects(int argc, const char **argv) {
 	AddrSet *use_map = findAllActiveReferences(_engine->_gamestate);
 
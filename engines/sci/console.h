@@ -31,6 +31,10 @@
 #include "gui/debugger.h"
 #include "sci/engine/vm.h"
 
+namespace Common {
+class MemoryWriteStreamDynamic;
+}
+
 namespace Sci {
 
 class SciEngine;
@@ -58,6 +62,7 @@ private:
 	bool cmdOpcodes(int argc, const char **argv);
 	bool cmdSelector(int argc, const char **argv);
 	bool cmdSelectors(int argc, const char **argv);
+	bool cmdSelectorCache(int argc, const char **argv);
 	bool cmdKernelFunctions(int argc, const char **argv);
 	bool cmdClassTable(int argc, const char **argv);
 	// Parser
@@ -75,12 +80,15 @@ private:
 	bool cmdResourceId(int argc, const char **argv);
 	bool cmdResourceInfo(int argc, const char **argv);
 	bool cmdResourceTypes(int argc, const char **argv);
+	bool cmdResourceCache(int argc, const char **argv);
 	bool cmdList(int argc, const char **argv);
 	bool cmdHexgrep(int argc, const char **argv);
 	bool cmdVerifyScripts(int argc, const char **argv);
 	// Game
 	bool cmdSaveGame(int argc, const char **argv);
 	bool cmdRestoreGame(int argc, const char **argv);
+	bool cmdSnapshot(int argc, const char **argv);
+	bool cmdRestoreSnapshot(int argc, const char **argv);
 	bool cmdRestartGame(int argc, const char **argv);
 	bool cmdGetVersion(int argc, const char **argv);
 	bool cmdRoomNumber(int argc, const char **argv);
@@ -92,6 +100,7 @@ private:
 	bool cmdSetPalette(int argc, const char **argv);
 	bool cmdDrawPic(int argc, const char **argv);
 	bool cmdDrawCel(int argc, const char **argv);
+	bool cmdCelCache(int argc, const char **argv);
 	bool cmdUndither(int argc, const char **argv);
 	bool cmdPicVisualize(int argc, const char **argv);
 	bool cmdPlayVideo(int argc, const char **argv);
@@ -103,6 +112,7 @@ private:
 	bool cmdKillSegment(int argc, const char **argv);
 	// Garbage collection
 	bool cmdGCInvoke(int argc, const char **argv);
+	bool cmdGCStats(int argc, const char **argv);
 	bool cmdGCObjects(int argc, const char **argv);
 	bool cmdGCShowReachable(int argc, const char **argv);
 	bool cmdGCShowFreeable(int argc, const char **argv);
@@ -177,6 +187,7 @@ private:
 	bool _mouseVisible;
 	Common::String _videoFile;
 	int _videoFrameDelay;
+	Common::MemoryWriteStreamDynamic *_snapshot; ///< Game state saved by the snapshot command
 };
 
 } // End of namespace Sci
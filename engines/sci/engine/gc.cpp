@@ -25,6 +25,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 namespace Sci {
@@ -163,8 +164,54 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
-void run_gc(EngineState *s) {
+/**
+ * Frees the pending garbage of the last collection.
+ * @param s				The state in which we should gc
+ * @param pauseStart	The time when the current pause of the VM started
+ * @param limitPause	If set, stop early and leave the rest for later once
+ *						the time limit of the garbage collector is reached
+ */
+static void freePendingGarbage(EngineState *s, uint32 pauseStart, bool limitPause) {
 	SegManager *segMan = s->_segMan;
+	GCState &gc = s->_gcState;
+
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	const uint32 startTime = g_system->getMillis();
+	uint freed = 0;
+
+	// Free from the back, so that the array doesn't have to be shifted
+	while (!gc.pendingGarbage.empty()) {
+		// Only check the time every 64 addresses, freeing one is cheap
+		if (limitPause && gc.maxPause && (freed & 0x3F) == 0x3F && g_system->getMillis() - pauseStart >= gc.maxPause)
+			break;
+
+		const reg_t addr = gc.pendingGarbage.back();
+		gc.pendingGarbage.pop_back();
+
+		// Skip addresses whose segment is gone, e.g. because freeing another
+		// address deallocated its whole segment (dynmem), and addresses whose
+		// segment id has been reused for another segment in the meantime
+		if (addr.segment >= heap.size() || !heap[addr.segment] ||
+			segMan->getSegmentSerial(addr.segment) != gc.segmentSerials[addr.segment])
+			continue;
+
+		heap[addr.segment]->freeAtAddress(segMan, addr);
+		debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+		freed++;
+	}
+
+	const uint32 sweepTime = g_system->getMillis() - startTime;
+	gc.freed += freed;
+	gc.sweepSteps++;
+	gc.lastSweepTime = sweepTime;
+	gc.totalSweepTime += sweepTime;
+	if (sweepTime > gc.maxSweepTime)
+		gc.maxSweepTime = sweepTime;
+}
+
+void run_gc(EngineState *s, bool limitPause) {
+	SegManager *segMan = s->_segMan;
+	GCState &gc = s->_gcState;
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
@@ -175,14 +222,20 @@ void run_gc(EngineState *s) {
 	memset(segcount, 0, sizeof(segcount));
 #endif
 
-	// Compute the set of all segments references currently in use.
+	uint32 startTime = g_system->getMillis();
+
+	// Compute the set of all segments references currently in use. This
+	// supersedes whatever the previous collection hasn't freed yet.
 	AddrSet *activeRefs = findAllActiveReferences(s);
+	gc.pendingGarbage.clear();
+	gc.segmentSerials.resize(segMan->getSegments().size());
 
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
 	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
 	for (uint seg = 1; seg < heap.size(); seg++) {
 		SegmentObj *mobj = heap[seg];
+		gc.segmentSerials[seg] = segMan->getSegmentSerial(seg);
 
 		if (mobj != NULL) {
 #ifdef GC_DEBUG_CODE
@@ -191,14 +244,23 @@ void run_gc(EngineState *s) {
 #endif
 
 			// Get a list of all deallocatable objects in this segment,
-			// then free any which are not referenced from somewhere.
+			// and remember any which are not referenced from somewhere.
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
 				const reg_t addr = *it;
 				if (!activeRefs->contains(addr)) {
-					// Not found -> we can free it
-					mobj->freeAtAddress(segMan, addr);
-					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+					// Not found -> we can free it. Scripts are freed right
+					// away: a script that is marked as deleted can be
+					// reloaded into the same segment without changing its
+					// serial, and marked as deleted again
+					// while it is running, so a pending address might free
+					// a script that is in use by then.
+					if (mobj->getType() == SEG_TYPE_SCRIPT) {
+						mobj->freeAtAddress(segMan, addr);
+						gc.freed++;
+					} else {
+						gc.pendingGarbage.push_back(addr);
+					}
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
 #endif
@@ -208,8 +270,21 @@ void run_gc(EngineState *s) {
 		}
 	}
 
+	gc.collections++;
+	gc.lastReachable = activeRefs->size();
 	delete activeRefs;
 
+	const uint32 markTime = g_system->getMillis() - startTime;
+	gc.lastMarkTime = markTime;
+	gc.totalMarkTime += markTime;
+	if (markTime > gc.maxMarkTime)
+		gc.maxMarkTime = markTime;
+
+	// Garbage stays garbage, as nothing references it anymore. Thus, if the
+	// marking already used up the time limit, freeing it can be done later.
+	if (!limitPause || !gc.maxPause || markTime < gc.maxPause)
+		freePendingGarbage(s, startTime, limitPause);
+
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
@@ -219,4 +294,9 @@ void run_gc(EngineState *s) {
 #endif
 }
 
+void continue_gc(EngineState *s) {
+	if (!s->_gcState.pendingGarbage.empty())
+		freePendingGarbage(s, g_system->getMillis(), true);
+}
+
 } // End of namespace Sci
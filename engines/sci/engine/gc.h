@@ -54,9 +54,19 @@ AddrSet *findAllActiveReferences(EngineState *s);
 
 /**
  * Runs garbage collection on the current system state
+ * @param s				The state in which we should gc
+ * @param limitPause	If set, and the garbage collector has a time limit
+ *						(GCState::maxPause), the garbage which can't be freed
+ *						in time is left for continue_gc()
+ */
+void run_gc(EngineState *s, bool limitPause = false);
+
+/**
+ * Frees more of the garbage which the last time limited garbage collection
+ * left behind, again within the time limit
  * @param s The state in which we should gc
  */
-void run_gc(EngineState *s);
+void continue_gc(EngineState *s);
 
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
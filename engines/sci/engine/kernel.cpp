@@ -37,7 +37,7 @@
 namespace Sci {
 
 Kernel::Kernel(ResourceManager *resMan, SegManager *segMan)
-	: _resMan(resMan), _segMan(segMan), _invalid("<invalid>") {
+	: _resMan(resMan), _segMan(segMan), _invalid("<invalid>"), _validateCallsOnce(false) {
 	loadSelectorNames();
 	mapSelectors();      // Map a few special selectors for later use
 }
@@ -486,7 +486,9 @@ bool Kernel::signatureMatch(const uint16 *sig, int argc, const reg_t *argv) {
 	uint16 curSig = nextSig;
 	while (nextSig && argc) {
 		curSig = nextSig;
-		int type = findRegType(*argv);
+		// Plain integers are the most common arguments, so don't bother
+		// calling findRegType() for them
+		int type = argv->segment ? findRegType(*argv) : (SIG_TYPE_INTEGER | (argv->offset ? 0 : SIG_TYPE_NULL));
 
 		if ((type & SIG_IS_INVALID) && (!(curSig & SIG_IS_INVALID)))
 			return false; // pointer is invalid and signature doesn't allow that?
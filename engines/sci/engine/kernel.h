@@ -172,6 +172,13 @@ public:
 	typedef Common::Array<KernelFunction> KernelFunctionArray;
 	KernelFunctionArray _kernelFuncs; /**< Table of kernel functions. */
 
+	/**
+	 * If set, the signature of a kernel call is only checked the first time
+	 * it's done from a specific call site with a specific argument count.
+	 * Set by the "sci_validate_kernel_calls_once" option.
+	 */
+	bool _validateCallsOnce;
+
 	/**
 	 * Determines whether a list of registers matches a given signature.
 	 * If no signature is given (i.e., if sig is NULL), this is always
@@ -95,23 +95,25 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// A* set membership
+	bool inOpenSet;
+	bool inClosedSet;
+
+	// Index into AvoidPathVisibility::points, or -1 for vertices added
+	// for the start and end points
+	int visibilityIndex;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		inOpenSet = false;
+		inClosedSet = false;
+		visibilityIndex = -1;
 	}
 };
 
-class VertexList: public Common::List<Vertex *> {
-public:
-	bool contains(Vertex *v) {
-		for (iterator it = begin(); it != end(); ++it) {
-			if (v == *it)
-				return true;
-		}
-		return false;
-	}
-};
+typedef Common::Array<Vertex *> VertexArray;
 
 /* Circular list definitions. */
 
@@ -236,6 +238,9 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Cached visibility of the polygon vertices, or NULL
+	AvoidPathVisibility *_visibility;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = NULL;
 		vertex_end = NULL;
@@ -243,6 +248,7 @@ struct PathfindingState {
 		_prependPoint = NULL;
 		_appendPoint = NULL;
 		vertices = 0;
+		_visibility = NULL;
 	}
 
 	~PathfindingState() {
@@ -639,45 +645,68 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 }
 
 /**
- * Returns a list of all vertices that are visible from a particular vertex.
+ * Determines if a vertex is visible from another vertex.
  * @param s				the pathfinding state
- * @param vertex_cur	the vertex
- * @return list of vertices that are visible from vert
+ * @param vertex_cur	the vertex to look from
+ * @param vertex		the vertex to look at
+ * @return true if vertex is visible from vertex_cur, false otherwise
  */
-static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
-	VertexList *visVerts = new VertexList();
+static bool vertex_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
 
-	for (int i = 0; i < s->vertices; i++) {
-		Vertex *vertex = s->vertex_index[i];
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
 
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
+	return true;
+}
+
+/**
+ * Finds all vertices that are visible from a particular vertex.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex
+ * @param visVerts		receives the vertices that are visible from vertex_cur,
+ *						in reverse vertex_index order
+ */
+static void visible_vertices(PathfindingState *s, Vertex *vertex_cur, VertexArray &visVerts) {
+	AvoidPathVisibility *visibility = s->_visibility;
+
+	visVerts.clear();
+
+	for (int i = s->vertices - 1; i >= 0; i--) {
+		Vertex *vertex = s->vertex_index[i];
+		bool visible;
+
+		// Visibility between the polygon vertices doesn't depend on the
+		// start and end points, so it may be known from an earlier call
+		if (visibility && vertex_cur->visibilityIndex != -1 && vertex->visibilityIndex != -1) {
+			byte &known = visibility->visible[vertex_cur->visibilityIndex * visibility->points.size() + vertex->visibilityIndex];
+			if (!known)
+				known = vertex_visible(s, vertex_cur, vertex) ? AvoidPathVisibility::kVisible : AvoidPathVisibility::kNotVisible;
+			visible = (known == AvoidPathVisibility::kVisible);
+		} else {
+			visible = vertex_visible(s, vertex_cur, vertex);
 		}
 
-		if (j == s->vertices)
-			visVerts->push_front(vertex);
+		if (visible)
+			visVerts.push_back(vertex);
 	}
-
-	return visVerts;
 }
 
 /**
@@ -1076,6 +1105,65 @@ static Vertex *merge_point(PathfindingState *s, const Common::Point &v) {
 	return v_new;
 }
 
+/**
+ * Finds the cached visibility of the polygon set, or adds an empty entry for
+ * it to the cache, and numbers the vertices accordingly. This has to be done
+ * before the start and end points are merged into the polygon set.
+ * @param s				the game state
+ * @param pf_s			the pathfinding state
+ */
+static void find_polygon_visibility(EngineState *s, PathfindingState *pf_s) {
+	// Number of polygon sets to keep around: usually there's only one per
+	// room, but some rooms switch between a few of them
+	const uint kMaxCachedPolygonSets = 4;
+
+	Common::Array<Common::Point> points;
+	Common::Array<uint16> polygonSizes;
+	uint32 hash = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+		Vertex *vertex;
+		uint16 size = 0;
+
+		CLIST_FOREACH(vertex, &(*it)->vertices) {
+			vertex->visibilityIndex = points.size();
+			points.push_back(vertex->v);
+			hash = hash * 33 + (uint16)vertex->v.x;
+			hash = hash * 33 + (uint16)vertex->v.y;
+			size++;
+		}
+
+		polygonSizes.push_back(size);
+		hash = hash * 33 + size;
+	}
+
+	Common::List<AvoidPathVisibility> &cache = s->_avoidPathVisibility;
+
+	for (Common::List<AvoidPathVisibility>::iterator it = cache.begin(); it != cache.end(); ++it) {
+		if (it->hash == hash && it->points == points && it->polygonSizes == polygonSizes) {
+			// Move it to the front, so that it's thrown out last
+			if (it != cache.begin()) {
+				cache.push_front(*it);
+				cache.erase(it);
+			}
+			pf_s->_visibility = &cache.front();
+			return;
+		}
+	}
+
+	if (cache.size() >= kMaxCachedPolygonSets)
+		cache.pop_back();
+
+	cache.push_front(AvoidPathVisibility());
+	AvoidPathVisibility &visibility = cache.front();
+	visibility.hash = hash;
+	visibility.points = points;
+	visibility.polygonSizes = polygonSizes;
+	visibility.visible.resize(points.size() * points.size());
+	memset(visibility.visible.begin(), 0, visibility.visible.size());
+	pf_s->_visibility = &visibility;
+}
+
 /**
  * Converts an SCI polygon into a Polygon
  * Parameters: (EngineState *) s: The game state
@@ -1216,6 +1304,8 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 			return NULL;
 		}
 
+		find_polygon_visibility(s, pf_s);
+
 		if (err == PF_OK) {
 			// Intersection was found, prepend original start position after pathfinding
 			pf_s->_prependPoint = new Common::Point(start);
@@ -1252,6 +1342,8 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 			new_start = new Common::Point(77, 107);
 		}
 
+		find_polygon_visibility(s, pf_s);
+
 		// Merge start and end points into polygon set
 		pf_s->vertex_start = merge_point(pf_s, *new_start);
 		pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1260,6 +1352,12 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		delete new_end;
 	}
 
+	// If the start or end point split an edge, the polygon set is different
+	// from the cached one
+	if ((pf_s->vertex_start->visibilityIndex == -1 && VERTEX_HAS_EDGES(pf_s->vertex_start))
+			|| (pf_s->vertex_end->visibilityIndex == -1 && VERTEX_HAS_EDGES(pf_s->vertex_end)))
+		pf_s->_visibility = NULL;
+
 	// Allocate and build vertex index
 	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
 
@@ -1287,27 +1385,28 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
  * Parameters: (PathfindingState *) s: The pathfinding state
  */
 static void AStar(PathfindingState *s) {
-	// Vertices of which the shortest path is known
-	VertexList closedSet;
-
-	// The remaining vertices
-	VertexList openSet;
+	// The vertices which still have to be checked, the ones of which the
+	// shortest path is known are marked as being in the closed set
+	VertexArray openSet;
+	VertexArray visVerts;
 
-	openSet.push_front(s->vertex_start);
+	openSet.push_back(s->vertex_start);
+	s->vertex_start->inOpenSet = true;
 	s->vertex_start->costG = 0;
 	s->vertex_start->costF = (uint32)sqrt((float)s->vertex_start->v.sqrDist(s->vertex_end->v));
 
 	while (!openSet.empty()) {
-		// Find vertex in open set with lowest F cost
-		VertexList::iterator vertex_min_it = openSet.end();
+		// Find vertex in open set with lowest F cost. Of several ones with
+		// the same cost, the one added last wins.
+		int vertex_min_idx = -1;
 		Vertex *vertex_min = 0;
 		uint32 min = HUGE_DISTANCE;
 
-		for (VertexList::iterator it = openSet.begin(); it != openSet.end(); ++it) {
-			Vertex *vertex = *it;
+		for (int i = openSet.size() - 1; i >= 0; i--) {
+			Vertex *vertex = openSet[i];
 			if (vertex->costF < min) {
-				vertex_min_it = it;
-				vertex_min = *vertex_min_it;
+				vertex_min_idx = i;
+				vertex_min = vertex;
 				min = vertex->costF;
 			}
 		}
@@ -1319,20 +1418,23 @@ static void AStar(PathfindingState *s) {
 			break;
 
 		// Move vertex from set open to set closed
-		closedSet.push_front(vertex_min);
-		openSet.erase(vertex_min_it);
+		vertex_min->inClosedSet = true;
+		vertex_min->inOpenSet = false;
+		openSet.remove_at(vertex_min_idx);
 
-		VertexList *visVerts = visible_vertices(s, vertex_min);
+		visible_vertices(s, vertex_min, visVerts);
 
-		for (VertexList::iterator it = visVerts->begin(); it != visVerts->end(); ++it) {
+		for (VertexArray::iterator it = visVerts.begin(); it != visVerts.end(); ++it) {
 			uint32 new_dist;
 			Vertex *vertex = *it;
 
-			if (closedSet.contains(vertex))
+			if (vertex->inClosedSet)
 				continue;
 
-			if (!openSet.contains(vertex))
-				openSet.push_front(vertex);
+			if (!vertex->inOpenSet) {
+				openSet.push_back(vertex);
+				vertex->inOpenSet = true;
+			}
 
 			new_dist = vertex_min->costG + (uint32)sqrt((float)vertex_min->v.sqrDist(vertex->v));
 
@@ -1352,8 +1454,6 @@ static void AStar(PathfindingState *s) {
 				vertex->path_prev = vertex_min;
 			}
 		}
-
-		delete visVerts;
 	}
 
 	if (openSet.empty())
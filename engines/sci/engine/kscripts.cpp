@@ -213,6 +213,11 @@ reg_t kScriptID(EngineState *s, int argc, reg_t *argv) {
 	if (argv[0].segment)
 		return argv[0];
 
+	// Games switch rooms by loading the new room's script here, so this is
+	// the earliest point where the room's other resources can be read in
+	if (!s->_segMan->getScriptSegment(script))
+		g_sci->getResMan()->prefetchRoom(script);
+
 	SegmentId scriptSeg = s->_segMan->getScriptSegment(script, SCRIPT_GET_LOAD);
 
 	if (!scriptSeg)
@@ -34,6 +34,7 @@
 #include "video/qt_decoder.h"
 #include "sci/video/seq_decoder.h"
 #ifdef ENABLE_SCI32
+#include "sci/graphics/frameout.h"
 #include "video/coktel_decoder.h"
 #endif
 
@@ -115,6 +116,12 @@ void playVideo(Video::VideoDecoder *videoDecoder, VideoState videoState) {
 
 	delete[] scaleBuffer;
 	delete videoDecoder;
+
+#ifdef ENABLE_SCI32
+	// Show everything again on the next frame, the video went past GfxFrameout
+	if (g_sci->_gfxFrameout)
+		g_sci->_gfxFrameout->forceFullRedraw();
+#endif
 }
 
 reg_t kShowMovie(EngineState *s, int argc, reg_t *argv) {
@@ -26,6 +26,7 @@
 #include "common/stream.h"
 #include "common/system.h"
 #include "common/func.h"
+#include "common/memstream.h"
 #include "common/serializer.h"
 #include "graphics/thumbnail.h"
 
@@ -122,6 +123,50 @@ void syncWithSerializer(Common::Serializer &s, reg_t &obj) {
 	s.syncAsUint16LE(obj.offset);
 }
 
+/**
+ * Syncs a block of reg_t values in one go, instead of going through the
+ * serializer for every single value. The on-disk format is the same as
+ * syncing each value with syncWithSerializer().
+ */
+static void syncRegBlock(Common::Serializer &s, reg_t *regs, uint count) {
+	if (!count)
+		return;
+
+	byte *buf = (byte *)malloc(count * 4);
+	byte *ptr = buf;
+
+	if (s.isSaving()) {
+		for (uint i = 0; i < count; i++, ptr += 4) {
+			WRITE_LE_UINT16(ptr, regs[i].segment);
+			WRITE_LE_UINT16(ptr + 2, regs[i].offset);
+		}
+	}
+
+	s.syncBytes(buf, count * 4);
+
+	if (s.isLoading()) {
+		for (uint i = 0; i < count; i++, ptr += 4) {
+			regs[i].segment = READ_LE_UINT16(ptr);
+			regs[i].offset = READ_LE_UINT16(ptr + 2);
+		}
+	}
+
+	free(buf);
+}
+
+// Arrays of reg_t (locals, object variables) are synced as a single block
+template <>
+void syncArray<reg_t>(Common::Serializer &s, Common::Array<reg_t> &arr) {
+	uint len = arr.size();
+	s.syncAsUint32LE(len);
+
+	if (s.isLoading())
+		arr.resize(len);
+
+	if (len)
+		syncRegBlock(s, &arr[0], len);
+}
+
 template <>
 void syncWithSerializer(Common::Serializer &s, synonym_t &obj) {
 	s.syncAsUint16LE(obj.replaceant);
@@ -217,6 +262,13 @@ void SegManager::saveLoadWithSerializer(Common::Serializer &s) {
 		}
 	}
 
+	if (s.isLoading()) {
+		// The loaded segments replace whatever was at their ids before
+		_segmentSerials.resize(_heap.size());
+		for (uint i = 0; i < _heap.size(); i++)
+			_segmentSerials[i] = ++_nextSegmentSerial;
+	}
+
 	s.syncAsSint32LE(_clonesSegId);
 	s.syncAsSint32LE(_listsSegId);
 	s.syncAsSint32LE(_nodesSegId);
@@ -376,17 +428,7 @@ void syncWithSerializer(Common::Serializer &s, SegmentObjTable<SciArray<reg_t> >
 		obj.setSize(size);
 	}
 
-	for (uint32 i = 0; i < size; i++) {
-		reg_t value;
-
-		if (s.isSaving())
-			value = obj.getValue(i);
-
-		syncWithSerializer(s, value);
-
-		if (s.isLoading())
-			obj.setValue(i, value);
-	}
+	syncRegBlock(s, obj.getRawData(), size);
 }
 
 template <>
@@ -403,17 +445,8 @@ void syncWithSerializer(Common::Serializer &s, SegmentObjTable<SciString>::Entry
 		obj.setSize(size);
 	}
 
-	for (uint32 i = 0; i < size; i++) {
-		char value = 0;
-
-		if (s.isSaving())
-			value = obj.getValue(i);
-
-		s.syncAsByte(value);
-
-		if (s.isLoading())
-			obj.setValue(i, value);
-	}
+	if (size)
+		s.syncBytes((byte *)obj.getRawData(), size);
 }
 #endif
 
@@ -808,7 +841,7 @@ void SegManager::reconstructClones() {
 #pragma mark -
 
 
-bool gamestate_save(EngineState *s, Common::WriteStream *fh, const char* savename, const char *version) {
+static bool gamestate_write(EngineState *s, Common::WriteStream *fh, const char *savename, const char *version, bool withThumbnail) {
 	TimeDate curTime;
 	g_system->getTimeAndDate(curTime);
 
@@ -831,7 +864,9 @@ bool gamestate_save(EngineState *s, Common::WriteStream *fh, const char* savenam
 
 	Common::Serializer ser(0, fh);
 	sync_SavegameMetadata(ser, meta);
-	Graphics::saveThumbnail(*fh);
+	// Snapshots don't need a thumbnail, gamestate_restore() skips it anyway
+	if (withThumbnail)
+		Graphics::saveThumbnail(*fh);
 	s->saveLoadWithSerializer(ser);		// FIXME: Error handling?
 	if (g_sci->_gfxPorts)
 		g_sci->_gfxPorts->saveLoadWithSerializer(ser);
@@ -842,6 +877,14 @@ bool gamestate_save(EngineState *s, Common::WriteStream *fh, const char* savenam
 	return true;
 }
 
+bool gamestate_save(EngineState *s, Common::WriteStream *fh, const char *savename, const char *version) {
+	return gamestate_write(s, fh, savename, version, true);
+}
+
+bool gamestate_snapshot(EngineState *s, Common::MemoryWriteStreamDynamic *snapshot) {
+	return gamestate_write(s, snapshot, "snapshot", "", false);
+}
+
 extern void showScummVMDialog(const Common::String &message);
 
 void gamestate_restore(EngineState *s, Common::SeekableReadStream *fh) {
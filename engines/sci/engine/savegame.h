@@ -31,6 +31,10 @@
 
 #include "sci/sci.h"
 
+namespace Common {
+class MemoryWriteStreamDynamic;
+}
+
 namespace Sci {
 
 struct EngineState;
@@ -84,6 +88,17 @@ struct SavegameMetadata {
  */
 bool gamestate_save(EngineState *s, Common::WriteStream *save, const char *savename, const char *version);
 
+/**
+ * Saves the game state into a memory buffer. Snapshots use the regular
+ * savegame format, but are not compressed and don't contain a thumbnail,
+ * so that they are cheap enough for quick saves. They can be restored by
+ * passing a MemoryReadStream over the buffer to gamestate_restore().
+ * @param s			The state to save
+ * @param snapshot	The stream to write the snapshot to
+ * @return true on success, false otherwise
+ */
+bool gamestate_snapshot(EngineState *s, Common::MemoryWriteStreamDynamic *snapshot);
+
 /**
  * Restores a game state from a directory.
  * @param s			An older state from the same game
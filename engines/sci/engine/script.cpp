@@ -64,6 +64,9 @@ void Script::freeScript() {
 	_bufSize = 0;
 
 	_objects.clear();
+
+	_instructionIndex.clear();
+	_instructions.clear();
 }
 
 void Script::init(int script_nr, ResourceManager *resMan) {
@@ -78,6 +81,9 @@ void Script::init(int script_nr, ResourceManager *resMan) {
 
 	_markedAsDeleted = false;
 
+	_instructionIndex.clear();
+	_instructions.clear();
+
 	_nr = script_nr;
 	_buf = 0;
 	_heapStart = 0;
@@ -125,6 +131,45 @@ void Script::init(int script_nr, ResourceManager *resMan) {
 	}
 }
 
+const PMachineInstruction &Script::getInstruction(uint16 offset) {
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(_bufSize);
+
+	uint16 index = _instructionIndex[offset];
+
+	if (!index) {
+		// Not executed before, decode it now. The scripts are fully set up
+		// (patched and relocated) when they start running, so this is final.
+		PMachineInstruction instruction;
+		instruction.size = readPMachineInstruction(_buf + offset, instruction.extOpcode, instruction.opparams);
+		instruction.validatedArgc = -1;
+		instruction.validatedSubId = 0;
+
+		_instructions.push_back(instruction);
+		index = _instructions.size();
+		_instructionIndex[offset] = index;
+	}
+
+	return _instructions[index - 1];
+}
+
+bool Script::isKernelCallValidated(uint16 offset, int argc, uint16 subId) const {
+	if (offset >= _instructionIndex.size() || !_instructionIndex[offset])
+		return false;
+
+	const PMachineInstruction &instruction = _instructions[_instructionIndex[offset] - 1];
+	return instruction.validatedArgc == argc && instruction.validatedSubId == subId;
+}
+
+void Script::setKernelCallValidated(uint16 offset, int argc, uint16 subId) {
+	if (offset >= _instructionIndex.size() || !_instructionIndex[offset])
+		return;
+
+	PMachineInstruction &instruction = _instructions[_instructionIndex[offset] - 1];
+	instruction.validatedArgc = argc;
+	instruction.validatedSubId = subId;
+}
+
 void Script::load(ResourceManager *resMan) {
 	Resource *script = resMan->findResource(ResourceId(kResourceTypeScript, _nr), 0);
 	assert(script != 0);
@@ -51,6 +51,15 @@ enum ScriptObjectTypes {
 
 typedef Common::HashMap<uint16, Object> ObjMap;
 
+/** An instruction of a script, as decoded by readPMachineInstruction() */
+struct PMachineInstruction {
+	byte extOpcode; ///< The opcode, and the flag for byte sized parameters
+	uint16 size; ///< The size of the instruction in bytes
+	int16 opparams[4]; ///< The parameters
+	int16 validatedArgc; ///< callk only: argc of the last call which passed the signature check, or -1
+	uint16 validatedSubId; ///< callk only: subfunction id of that call
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -73,6 +82,14 @@ private:
 
 	bool _markedAsDeleted;
 
+	/**
+	 * For each offset in the buffer, the index of the decoded instruction
+	 * starting there plus one, or 0 if the instruction hasn't been
+	 * executed yet. Empty until the first instruction is decoded.
+	 */
+	Common::Array<uint16> _instructionIndex;
+	Common::Array<PMachineInstruction> _instructions; /**< The decoded instructions */
+
 public:
 	/**
 	 * Table for objects, contains property variables.
@@ -93,6 +110,27 @@ public:
 
 	int getScriptNumber() const { return _nr; }
 
+	/**
+	 * Retrieves the decoded instruction at the given offset. Each
+	 * instruction is only decoded the first time it is executed.
+	 * @param offset	The offset of the instruction in the buffer
+	 * @return			The instruction. The reference becomes invalid
+	 *					once another instruction is decoded.
+	 */
+	const PMachineInstruction &getInstruction(uint16 offset);
+
+	/**
+	 * Checks if the kernel call at the given offset has already passed the
+	 * signature check with the given argument count and subfunction id.
+	 */
+	bool isKernelCallValidated(uint16 offset, int argc, uint16 subId) const;
+
+	/**
+	 * Remembers that the kernel call at the given offset has passed the
+	 * signature check with the given argument count and subfunction id.
+	 */
+	void setKernelCallValidated(uint16 offset, int argc, uint16 subId);
+
 public:
 	Script();
 	~Script();
@@ -52,6 +52,10 @@ SegManager::SegManager(ResourceManager *resMan) {
 
 	_resMan = resMan;
 
+	_selectorLookupHits = 0;
+	_selectorLookupMisses = 0;
+	_nextSegmentSerial = 0;
+
 	createClassTable();
 }
 
@@ -67,6 +71,7 @@ void SegManager::resetSegMan() {
 	}
 
 	_heap.clear();
+	_selectorLookups.clear();
 
 	// And reinitialize
 	_heap.push_back(0);
@@ -131,6 +136,10 @@ SegmentObj *SegManager::allocSegment(SegmentObj *mem, SegmentId *segid) {
 	}
 	_heap[id] = mem;
 
+	if (id >= (int)_segmentSerials.size())
+		_segmentSerials.resize(id + 1);
+	_segmentSerials[id] = ++_nextSegmentSerial;
+
 	return mem;
 }
 
@@ -159,6 +168,8 @@ void SegManager::deallocate(SegmentId seg) {
 
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
+		// The segment of the script may be reused by another one
+		flushSelectorLookups();
 		_scriptSegMap.erase(scr->getScriptNumber());
 		if (scr->_localsSegment)
 			deallocate(scr->_localsSegment);
@@ -168,6 +179,29 @@ void SegManager::deallocate(SegmentId seg) {
 	_heap[seg] = NULL;
 }
 
+const SelectorLookup *SegManager::findSelectorLookup(reg_t obj, Selector selector) {
+	SelectorLookupKey key;
+	key.obj = obj;
+	key.selector = selector;
+
+	SelectorLookupMap::const_iterator it = _selectorLookups.find(key);
+	if (it == _selectorLookups.end()) {
+		_selectorLookupMisses++;
+		return NULL;
+	}
+
+	_selectorLookupHits++;
+	return &it->_value;
+}
+
+void SegManager::cacheSelectorLookup(reg_t obj, Selector selector, const SelectorLookup &lookup) {
+	SelectorLookupKey key;
+	key.obj = obj;
+	key.selector = selector;
+
+	_selectorLookups[key] = lookup;
+}
+
 bool SegManager::isHeapObject(reg_t pos) const {
 	const Object *obj = getObject(pos);
 	if (obj == NULL || (obj && obj->isFreed()))
@@ -1008,6 +1042,10 @@ int SegManager::instantiateScript(int scriptNum) {
 		scr = allocateScript(scriptNum, &segmentId);
 	}
 
+	// The objects of the script may replace objects of a script which
+	// used the same segment before
+	flushSelectorLookups();
+
 	scr->init(scriptNum, _resMan);
 	scr->load(_resMan);
 	scr->initialiseLocals(this);
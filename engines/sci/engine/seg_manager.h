@@ -46,6 +46,24 @@ enum ScriptLoadType {
 
 class Script;
 
+/** Key of the selector lookup cache: an object address and a selector */
+struct SelectorLookupKey {
+	reg_t obj;
+	Selector selector;
+
+	bool operator==(const SelectorLookupKey &other) const {
+		return obj == other.obj && selector == other.selector;
+	}
+};
+
+struct SelectorLookupKey_Hash {
+	uint operator()(const SelectorLookupKey &x) const {
+		return (x.obj.segment << 19) ^ (x.obj.offset << 3) ^ x.selector;
+	}
+};
+
+typedef Common::HashMap<SelectorLookupKey, SelectorLookup, SelectorLookupKey_Hash> SelectorLookupMap;
+
 class SegManager : public Common::Serializable {
 	friend class Console;
 public:
@@ -398,6 +416,28 @@ public:
 	 */
 	bool isObject(reg_t obj) const { return getObject(obj) != NULL; }
 
+	/**
+	 * Finds a cached selector lookup. The lookups are cached by the address
+	 * of the object's base, i.e. Object::getPos(), which clones share with
+	 * the object they were cloned from, as all objects with the same base
+	 * have the same variables, methods and superclasses.
+	 * @param obj		The base address of the object
+	 * @param selector	The selector which was looked up
+	 * @return			The cached lookup, or NULL if there is none
+	 */
+	const SelectorLookup *findSelectorLookup(reg_t obj, Selector selector);
+
+	/**
+	 * Adds a selector lookup to the cache, see findSelectorLookup().
+	 */
+	void cacheSelectorLookup(reg_t obj, Selector selector, const SelectorLookup &lookup);
+
+	/**
+	 * Empties the selector lookup cache. This has to happen whenever
+	 * scripts are loaded or unloaded, as their segments get reused.
+	 */
+	void flushSelectorLookups() { _selectorLookups.clear(); }
+
 	// TODO: document this
 	bool isHeapObject(reg_t pos) const;
 
@@ -444,11 +484,26 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Returns a number which identifies the segment allocated at the given
+	 * id. It changes when the id is reused for another segment, so that
+	 * users can tell if a segment id they kept around still refers to the
+	 * same segment. Returns 0 for ids which were never allocated.
+	 */
+	uint32 getSegmentSerial(SegmentId seg) const { return seg < (SegmentId)_segmentSerials.size() ? _segmentSerials[seg] : 0; }
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
 	Common::HashMap<int, SegmentId> _scriptSegMap;
+	/** Cached lookupSelector() results, see findSelectorLookup() */
+	SelectorLookupMap _selectorLookups;
+	/** Number of selector lookups found in the cache, and not found there */
+	uint32 _selectorLookupHits, _selectorLookupMisses;
+	/** Serial number of the segment at each id, see getSegmentSerial() */
+	Common::Array<uint32> _segmentSerials;
+	uint32 _nextSegmentSerial;
 
 	ResourceManager *_resMan;
 
@@ -252,7 +252,6 @@ void invokeSelector(EngineState *s, reg_t object, int selectorId,
 
 SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
 	const Object *obj = segMan->getObject(obj_location);
-	int index;
 	bool oldScriptHeader = (getSciVersion() == SCI_VERSION_0_EARLY);
 
 	// Early SCI versions used the LSB in the selector ID as a read/write
@@ -265,34 +264,45 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 				PRINT_REG(obj_location));
 	}
 
-	index = obj->locateVarSelector(segMan, selectorId);
+	const SelectorLookup *cachedLookup = segMan->findSelectorLookup(obj->getPos(), selectorId);
+	SelectorLookup lookup;
 
-	if (index >= 0) {
-		// Found it as a variable
-		if (varp) {
-			varp->obj = obj_location;
-			varp->varindex = index;
-		}
-		return kSelectorVariable;
+	if (cachedLookup) {
+		lookup = *cachedLookup;
 	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
+		lookup.type = kSelectorNone;
+		lookup.varIndex = obj->locateVarSelector(segMan, selectorId);
+		lookup.func = NULL_REG;
+
+		if (lookup.varIndex >= 0) {
+			// Found it as a variable
+			lookup.type = kSelectorVariable;
+		} else {
+			// Check if it's a method, with recursive lookup in superclasses
+			const Object *curObj = obj;
+			while (curObj) {
+				int index = curObj->funcSelectorPosition(selectorId);
+				if (index >= 0) {
+					lookup.type = kSelectorMethod;
+					lookup.func = curObj->getFunction(index);
+					break;
+				}
+
+				curObj = segMan->getObject(curObj->getSuperClassSelector());
 			}
 		}
 
-		return kSelectorNone;
+		segMan->cacheSelectorLookup(obj->getPos(), selectorId, lookup);
 	}
 
+	if (lookup.type == kSelectorVariable && varp) {
+		varp->obj = obj_location;
+		varp->varindex = lookup.varIndex;
+	} else if (lookup.type == kSelectorMethod && fptr) {
+		*fptr = lookup.func;
+	}
 
-//	return _lookupSelector_function(segMan, obj, selectorId, fptr);
+	return lookup.type;
 }
 
 } // End of namespace Sci
@@ -101,6 +101,7 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	_gcState.pendingGarbage.clear();
 
 	_throttleCounter = 0;
 	_throttleLastTime = 0;
@@ -28,6 +28,8 @@
 
 #include "common/scummsys.h"
 #include "common/array.h"
+#include "common/list.h"
+#include "common/rect.h"
 #include "common/serializer.h"
 #include "common/str-array.h"
 
@@ -134,6 +136,64 @@ struct VideoState {
 	}
 };
 
+/**
+ * Which vertices of a set of pathfinding polygons can see each other, see
+ * kAvoidPath. Filled in as the pathfinder needs it.
+ */
+struct AvoidPathVisibility {
+	uint32 hash; ///< Hash of points and polygonSizes
+	Common::Array<Common::Point> points; ///< The vertices of all polygons
+	Common::Array<uint16> polygonSizes; ///< The number of vertices of each polygon
+	/**
+	 * For each pair of vertices (from * points.size() + to), 0 if not known
+	 * yet, otherwise kVisible or kNotVisible
+	 */
+	Common::Array<byte> visible;
+
+	enum {
+		kVisible = 1,
+		kNotVisible = 2
+	};
+};
+
+/** State of the garbage collector, which is kept between collections */
+struct GCState {
+	/**
+	 * Unreachable addresses found by the last collection which haven't been
+	 * freed yet, because the collection ran out of time
+	 */
+	Common::Array<reg_t> pendingGarbage;
+	/** SegManager::getSegmentSerial() of every segment when pendingGarbage was filled */
+	Common::Array<uint32> segmentSerials;
+	/**
+	 * Time in ms after which freeing garbage is postponed, or 0 for no limit.
+	 * Only freeing is limited, finding the reachable addresses always runs
+	 * in one go.
+	 */
+	uint32 maxPause;
+
+	// Statistics
+	uint32 collections; ///< Number of collections
+	uint32 lastMarkTime, maxMarkTime, totalMarkTime; ///< Time spent finding the reachable addresses, in ms
+	uint32 lastSweepTime, maxSweepTime, totalSweepTime; ///< Time spent freeing garbage in a single step, in ms
+	uint32 sweepSteps; ///< Number of steps which freed garbage
+	uint32 lastReachable; ///< Number of reachable addresses in the last collection
+	uint32 freed; ///< Number of freed addresses
+
+	GCState() : maxPause(0) {
+		resetStats();
+	}
+
+	void resetStats() {
+		collections = 0;
+		lastMarkTime = maxMarkTime = totalMarkTime = 0;
+		lastSweepTime = maxSweepTime = totalSweepTime = 0;
+		sweepSteps = 0;
+		lastReachable = 0;
+		freed = 0;
+	}
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -219,6 +279,7 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GCState _gcState;
 
 	MessageState *_msgState;
 
@@ -233,6 +294,12 @@ public:
 	VideoState _videoState;
 	bool _syncedAudioOptions;
 
+	/**
+	 * Visibility of the polygon sets which kAvoidPath was called with most
+	 * recently, the most recent one first
+	 */
+	Common::List<AvoidPathVisibility> _avoidPathVisibility;
+
 	/**
 	 * Resets the engine state.
 	 */
@@ -352,7 +352,7 @@ static void addKernelCallToExecStack(EngineState *s, int kernelCallNr, int argc,
 // from scriptdebug.cpp
 extern void logKernelCall(const KernelFunction *kernelCall, const KernelSubFunction *kernelSubCall, EngineState *s, int argc, reg_t *argv, reg_t result);
 
-static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
+static void callKernelFunc(EngineState *s, int kernelCallNr, int argc, Script *callSite, uint16 callSiteOffset) {
 	Kernel *kernel = g_sci->getKernel();
 
 	if (kernelCallNr >= (int)kernel->_kernelFuncs.size())
@@ -361,8 +361,16 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 	const KernelFunction &kernelCall = kernel->_kernelFuncs[kernelCallNr];
 	reg_t *argv = s->xs->sp + 1;
 
-	if (kernelCall.signature
+	// If signatures only get checked on the first call from each call site,
+	// skip the checks when this call site already passed them with the same
+	// argument count (and subfunction)
+	const uint16 siteSubId = (kernelCall.subFunctionCount && argc >= 1) ? argv[0].offset : 0;
+	const bool siteValidated = kernel->_validateCallsOnce && callSite->isKernelCallValidated(callSiteOffset, argc, siteSubId);
+	bool signatureMismatch = false;
+
+	if (!siteValidated && kernelCall.signature
 			&& !kernel->signatureMatch(kernelCall.signature, argc, argv)) {
+		signatureMismatch = true;
 		// signature mismatch, check if a workaround is available
 		SciTrackOriginReply originReply;
 		SciWorkaroundSolution solution = trackOriginAndFindWorkaround(0, kernelCall.workarounds, &originReply);
@@ -388,6 +396,11 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 
 	// Call kernel function
 	if (!kernelCall.subFunctionCount) {
+		// Remember the call site before the call, as the kernel function may
+		// unload its script
+		if (kernel->_validateCallsOnce && !siteValidated && !signatureMismatch)
+			callSite->setKernelCallValidated(callSiteOffset, argc, siteSubId);
+
 		addKernelCallToExecStack(s, kernelCallNr, argc, argv);
 		s->r_acc = kernelCall.function(s, argc, argv);
 
@@ -411,8 +424,9 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 		if (subId >= kernelCall.subFunctionCount)
 			error("[VM] k%s: subfunction ID %d requested, but not available", kernelCall.name, subId);
 		const KernelSubFunction &kernelSubCall = kernelCall.subFunctions[subId];
-		if (kernelSubCall.signature && !kernel->signatureMatch(kernelSubCall.signature, argc, argv)) {
+		if (!siteValidated && kernelSubCall.signature && !kernel->signatureMatch(kernelSubCall.signature, argc, argv)) {
 			// Signature mismatch
+			signatureMismatch = true;
 			SciTrackOriginReply originReply;
 			SciWorkaroundSolution solution = trackOriginAndFindWorkaround(0, kernelSubCall.workarounds, &originReply);
 			switch (solution.type) {
@@ -443,6 +457,9 @@ static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 		}
 		if (!kernelSubCall.function)
 			error("[VM] k%s: subfunction ID %d requested, but not available", kernelCall.name, subId);
+		if (kernel->_validateCallsOnce && !siteValidated && !signatureMismatch)
+			callSite->setKernelCallValidated(callSiteOffset, argc + 1, siteSubId);
+
 		addKernelCallToExecStack(s, kernelCallNr, argc, argv);
 		s->r_acc = kernelSubCall.function(s, argc, argv);
 
@@ -465,7 +482,7 @@ int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4])
 	extOpcode = src[offset++]; // Get "extended" opcode (lower bit has special meaning)
 	const byte opcode = extOpcode >> 1;	// get the actual opcode
 
-	memset(opparams, 0, sizeof(opparams));
+	memset(opparams, 0, 4 * sizeof(int16));
 
 	for (int i = 0; g_opcode_formats[opcode][i]; ++i) {
 		//debugN("Opcode: 0x%x, Opnumber: 0x%x, temp: %d\n", opcode, opcode, temp);
@@ -636,9 +653,12 @@ void run_vm(EngineState *s) {
 			error("run_vm(): program counter gone astray, addr: %d, code buffer size: %d",
 			s->xs->addr.pc.offset, scr->getBufSize());
 
-		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.offset += readPMachineInstruction(scr->getBuf() + s->xs->addr.pc.offset, extOpcode, opparams);
+		// Get opcode. The instructions of the scripts are only decoded once,
+		// when they're first executed.
+		const PMachineInstruction &instruction = scr->getInstruction(s->xs->addr.pc.offset);
+		const byte extOpcode = instruction.extOpcode;
+		memcpy(opparams, instruction.opparams, sizeof(opparams));
+		s->xs->addr.pc.offset += instruction.size;
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -848,10 +868,14 @@ void run_vm(EngineState *s) {
 		}
 
 		case op_callk: { // 0x21 (33)
+			const uint16 callSiteOffset = s->xs->addr.pc.offset - instruction.size;
+
 			// Run the garbage collector, if needed
 			if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				run_gc(s, true);
+			} else {
+				continue_gc(s);
 			}
 
 			// Call kernel function
@@ -866,7 +890,7 @@ void run_vm(EngineState *s) {
 			if (!oldScriptHeader)
 				argc += s->r_rest;
 
-			callKernelFunc(s, opparams[0], argc);
+			callKernelFunc(s, opparams[0], argc, scr, callSiteOffset);
 
 			if (!oldScriptHeader)
 				s->r_rest = 0;
@@ -59,6 +59,13 @@ enum SelectorType {
 	kSelectorMethod
 };
 
+/** The result of looking up a selector of an object, see lookupSelector() */
+struct SelectorLookup {
+	SelectorType type;
+	int varIndex; ///< Index of the variable, for kSelectorVariable
+	reg_t func; ///< Address of the method, for kSelectorMethod
+};
+
 struct Class {
 	int script; ///< number of the script the class is in, -1 for non-existing
 	reg_t reg; ///< offset; script-relative offset, segment: 0 if not instantiated
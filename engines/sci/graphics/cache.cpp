@@ -39,6 +39,11 @@ namespace Sci {
 
 GfxCache::GfxCache(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette)
 	: _resMan(resMan), _screen(screen), _palette(palette) {
+	_celLruFirst = _celLruLast = NULL;
+	_celMemory = 0;
+	_maxCelMemory = MAX_CEL_CACHE_MEMORY;
+	_celCount = 0;
+	resetCelCacheStats();
 }
 
 GfxCache::~GfxCache() {
@@ -84,11 +89,86 @@ GfxView *GfxCache::getView(GuiResourceId viewId) {
 		purgeViewCache();
 
 	if (!_cachedViews.contains(viewId))
-		_cachedViews[viewId] = new GfxView(_resMan, _screen, _palette, viewId);
+		_cachedViews[viewId] = new GfxView(_resMan, _screen, _palette, viewId, this);
 
 	return _cachedViews[viewId];
 }
 
+void GfxCache::addCelBitmap(CelBitmap *bitmap) {
+	if (bitmap->scaleX)
+		_celStats.scaledMisses++;
+	else
+		_celStats.misses++;
+
+	bitmap->lruPrev = NULL;
+	bitmap->lruNext = _celLruFirst;
+	if (_celLruFirst)
+		_celLruFirst->lruPrev = bitmap;
+	else
+		_celLruLast = bitmap;
+	_celLruFirst = bitmap;
+
+	_celMemory += bitmap->width * bitmap->height;
+	_celCount++;
+	freeOldCelBitmaps();
+}
+
+void GfxCache::touchCelBitmap(CelBitmap *bitmap) {
+	if (bitmap->scaleX)
+		_celStats.scaledHits++;
+	else
+		_celStats.hits++;
+
+	if (bitmap == _celLruFirst)
+		return;
+
+	// Unlink it...
+	bitmap->lruPrev->lruNext = bitmap->lruNext;
+	if (bitmap->lruNext)
+		bitmap->lruNext->lruPrev = bitmap->lruPrev;
+	else
+		_celLruLast = bitmap->lruPrev;
+
+	// ...and put it in front
+	bitmap->lruPrev = NULL;
+	bitmap->lruNext = _celLruFirst;
+	_celLruFirst->lruPrev = bitmap;
+	_celLruFirst = bitmap;
+}
+
+void GfxCache::removeCelBitmap(CelBitmap *bitmap) {
+	if (bitmap->lruPrev)
+		bitmap->lruPrev->lruNext = bitmap->lruNext;
+	else
+		_celLruFirst = bitmap->lruNext;
+	if (bitmap->lruNext)
+		bitmap->lruNext->lruPrev = bitmap->lruPrev;
+	else
+		_celLruLast = bitmap->lruPrev;
+
+	_celMemory -= bitmap->width * bitmap->height;
+	_celCount--;
+}
+
+void GfxCache::freeOldCelBitmaps() {
+	// The two most recent cels are always kept: the caller may still be
+	// using the unscaled cel from which the newest one was scaled
+	while (_celMemory > _maxCelMemory && _celCount > 2) {
+		CelBitmap *oldest = _celLruLast;
+		oldest->view->freeBitmap(oldest);
+		_celStats.evictions++;
+	}
+}
+
+void GfxCache::setMaxCelMemory(uint32 bytes) {
+	_maxCelMemory = bytes;
+	freeOldCelBitmaps();
+}
+
+void GfxCache::resetCelCacheStats() {
+	memset(&_celStats, 0, sizeof(_celStats));
+}
+
 int16 GfxCache::kernelViewGetCelWidth(GuiResourceId viewId, int16 loopNo, int16 celNo) {
 	return getView(viewId)->getCelInfo(loopNo, celNo)->scriptWidth;
 }
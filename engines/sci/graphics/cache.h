@@ -32,15 +32,25 @@ namespace Sci {
 
 class GfxFont;
 class GfxView;
+struct CelBitmap;
 
 typedef Common::HashMap<int, GfxFont *> FontCache;
 typedef Common::HashMap<int, GfxView *> ViewCache;
 
 /**
- * Cache class, handles caching of views/fonts
+ * Cache class, handles caching of views/fonts, and of the decoded cels of
+ * the views it created
  */
 class GfxCache {
 public:
+	struct CelCacheStats {
+		uint32 hits;			///< Unscaled cels which were already decoded
+		uint32 misses;			///< Unscaled cels which had to be decoded
+		uint32 scaledHits;		///< Scaled cels which were already scaled
+		uint32 scaledMisses;	///< Scaled cels which had to be scaled
+		uint32 evictions;		///< Cels which were freed to stay within the budget
+	};
+
 	GfxCache(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette);
 	~GfxCache();
 
@@ -52,9 +62,24 @@ public:
 	int16 kernelViewGetLoopCount(GuiResourceId viewId);
 	int16 kernelViewGetCelCount(GuiResourceId viewId, int16 loopNo);
 
+	/** Adds a newly decoded or scaled cel, freeing older ones when over budget */
+	void addCelBitmap(CelBitmap *bitmap);
+	/** Marks a cel as the most recently used one */
+	void touchCelBitmap(CelBitmap *bitmap);
+	/** Forgets about a cel, called by the view which frees it */
+	void removeCelBitmap(CelBitmap *bitmap);
+
+	void setMaxCelMemory(uint32 bytes);
+	uint32 getMaxCelMemory() const { return _maxCelMemory; }
+	uint32 getCelMemory() const { return _celMemory; }
+	uint32 getCelCount() const { return _celCount; }
+	const CelCacheStats &getCelCacheStats() const { return _celStats; }
+	void resetCelCacheStats();
+
 private:
 	void purgeFontCache();
 	void purgeViewCache();
+	void freeOldCelBitmaps();
 
 	ResourceManager *_resMan;
 	GfxScreen *_screen;
@@ -62,6 +87,13 @@ private:
 
 	FontCache _cachedFonts;
 	ViewCache _cachedViews;
+
+	CelBitmap *_celLruFirst; ///< The most recently used cel
+	CelBitmap *_celLruLast; ///< The least recently used cel
+	uint32 _celMemory; ///< The size of all cached cels in bytes
+	uint32 _maxCelMemory;
+	uint32 _celCount;
+	CelCacheStats _celStats;
 };
 
 } // End of namespace Sci
@@ -24,6 +24,7 @@
  */
 
 #include "common/util.h"
+#include "common/hash-str.h"
 #include "common/stack.h"
 #include "graphics/primitives.h"
 
@@ -53,15 +54,34 @@ GfxFrameout::GfxFrameout(SegManager *segMan, ResourceManager *resMan, GfxCoordAd
 	_coordAdjuster = (GfxCoordAdjuster32 *)coordAdjuster;
 	scriptsRunningWidth = 320;
 	scriptsRunningHeight = 200;
+	_fullRedraw = true;
 }
 
 GfxFrameout::~GfxFrameout() {
+	clear();
 }
 
 void GfxFrameout::clear() {
+	for (FrameoutList::iterator it = _screenItems.begin(); it != _screenItems.end(); it++)
+		delete *it;
 	_screenItems.clear();
 	_planes.clear();
+	for (PlanePictureList::iterator it = _planePictures.begin(); it != _planePictures.end(); it++) {
+		delete it->picture;
+		delete[] it->pictureCels;
+	}
 	_planePictures.clear();
+	_dirtyRects.clear();
+	_fullRedraw = true;
+}
+
+bool sortHelper(const FrameoutEntry* entry1, const FrameoutEntry* entry2) {
+	if (entry1->priority == entry2->priority) {
+		if (entry1->y == entry2->y)
+			return (entry1->givenOrderNr < entry2->givenOrderNr);
+		return (entry1->y < entry2->y);
+	}
+	return (entry1->priority < entry2->priority);
 }
 
 void GfxFrameout::kernelAddPlane(reg_t object) {
@@ -88,6 +108,7 @@ void GfxFrameout::kernelAddPlane(reg_t object) {
 	newPlane.lastPriority = 0xFFFF; // hidden
 	newPlane.planeOffsetX = 0;
 	_planes.push_back(newPlane);
+	_fullRedraw = true;
 
 	kernelUpdatePlane(object);
 }
@@ -95,6 +116,8 @@ void GfxFrameout::kernelAddPlane(reg_t object) {
 void GfxFrameout::kernelUpdatePlane(reg_t object) {
 	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
 		if (it->object == object) {
+			PlaneEntry previousPlane = *it;
+
 			// Read some information
 			it->priority = readSelectorValue(_segMan, object, SELECTOR(priority));
 			GuiResourceId lastPictureId = it->pictureId;
@@ -148,6 +171,11 @@ void GfxFrameout::kernelUpdatePlane(reg_t object) {
 			it->planePictureMirrored = readSelectorValue(_segMan, object, SELECTOR(mirrored));
 			it->planeBack = readSelectorValue(_segMan, object, SELECTOR(back));
 
+			if (it->priority != previousPlane.priority || it->pictureId != previousPlane.pictureId ||
+				it->planeRect != previousPlane.planeRect || it->planeOffsetX != previousPlane.planeOffsetX ||
+				it->planePictureMirrored != previousPlane.planePictureMirrored || it->planeBack != previousPlane.planeBack)
+				_fullRedraw = true;
+
 			sortPlanes();
 
 			// Update the items in the plane
@@ -165,10 +193,12 @@ void GfxFrameout::kernelUpdatePlane(reg_t object) {
 }
 
 void GfxFrameout::kernelRepaintPlane(reg_t object) {
-	// TODO
+	// TODO: Only repaint the given plane
+	_fullRedraw = true;
 }
 
 void GfxFrameout::kernelDeletePlane(reg_t object) {
+	_fullRedraw = true;
 	deletePlanePictures(object);
 	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
 		if (it->object == object) {
@@ -198,14 +228,33 @@ void GfxFrameout::addPlanePicture(reg_t object, GuiResourceId pictureId, uint16
 	newPicture.pictureId = pictureId;
 	newPicture.picture = new GfxPicture(_resMan, _coordAdjuster, 0, _screen, _palette, pictureId, false);
 	newPicture.startX = startX;
-	newPicture.pictureCels = 0;
+
+	// The cels of a picture don't change, so they are only sorted once
+	int16 pictureCelCount = newPicture.picture->getSci32celCount();
+	newPicture.pictureCels = new FrameoutEntry[pictureCelCount]();
+	for (int16 pictureCelNr = 0; pictureCelNr < pictureCelCount; pictureCelNr++) {
+		FrameoutEntry *picEntry = &newPicture.pictureCels[pictureCelNr];
+		picEntry->celNo = pictureCelNr;
+		picEntry->object = NULL_REG;
+		picEntry->picture = newPicture.picture;
+		picEntry->y = newPicture.picture->getSci32celY(pictureCelNr);
+		picEntry->x = newPicture.picture->getSci32celX(pictureCelNr);
+		picEntry->picStartX = startX;
+		picEntry->priority = newPicture.picture->getSci32celPriority(pictureCelNr);
+		newPicture.sortedPictureCels.push_back(picEntry);
+	}
+	Common::sort(newPicture.sortedPictureCels.begin(), newPicture.sortedPictureCels.end(), sortHelper);
+
 	_planePictures.push_back(newPicture);
+	_fullRedraw = true;
 }
 
 void GfxFrameout::deletePlanePictures(reg_t object) {
 	for (PlanePictureList::iterator it = _planePictures.begin(); it != _planePictures.end(); it++) {
 		if (it->object == object) {
+			_fullRedraw = true;
 			delete it->picture;
+			delete[] it->pictureCels;
 			_planePictures.erase(it);
 			deletePlanePictures(object);
 			return;
@@ -222,6 +271,7 @@ void GfxFrameout::kernelAddScreenItem(reg_t object) {
 	memset(itemEntry, 0, sizeof(FrameoutEntry));
 	itemEntry->object = object;
 	itemEntry->givenOrderNr = _screenItems.size();
+	itemEntry->changed = true;
 	_screenItems.push_back(itemEntry);
 
 	kernelUpdateScreenItem(object);
@@ -236,6 +286,9 @@ void GfxFrameout::kernelUpdateScreenItem(reg_t object) {
 		FrameoutEntry *itemEntry = *listIterator;
 
 		if (itemEntry->object == object) {
+			FrameoutEntry previousEntry = *itemEntry;
+
+			itemEntry->plane = readSelector(_segMan, object, SELECTOR(plane));
 			itemEntry->viewId = readSelectorValue(_segMan, object, SELECTOR(view));
 			itemEntry->loopNo = readSelectorValue(_segMan, object, SELECTOR(loop));
 			itemEntry->celNo = readSelectorValue(_segMan, object, SELECTOR(cel));
@@ -249,16 +302,51 @@ void GfxFrameout::kernelUpdateScreenItem(reg_t object) {
 			itemEntry->signal = readSelectorValue(_segMan, object, SELECTOR(signal));
 			itemEntry->scaleX = readSelectorValue(_segMan, object, SELECTOR(scaleX));
 			itemEntry->scaleY = readSelectorValue(_segMan, object, SELECTOR(scaleY));
+
+			if (itemEntry->viewId != 0xFFFF) {
+				itemEntry->useInsetRect = readSelectorValue(_segMan, object, SELECTOR(useInsetRect));
+				if (itemEntry->useInsetRect) {
+					itemEntry->insetRect.top = readSelectorValue(_segMan, object, SELECTOR(inTop));
+					itemEntry->insetRect.left = readSelectorValue(_segMan, object, SELECTOR(inLeft));
+					itemEntry->insetRect.bottom = readSelectorValue(_segMan, object, SELECTOR(inBottom)) + 1;
+					itemEntry->insetRect.right = readSelectorValue(_segMan, object, SELECTOR(inRight)) + 1;
+				}
+			} else if (lookupSelector(_segMan, object, SELECTOR(text), NULL, NULL) == kSelectorVariable) {
+				// The text may change without the item being updated, so
+				// remember what would get drawn
+				reg_t stringObject = readSelector(_segMan, object, SELECTOR(text));
+				if (_segMan->isHeapObject(stringObject))
+					stringObject = readSelector(_segMan, stringObject, SELECTOR(data));
+				Common::String text = _segMan->getString(stringObject);
+				text += Common::String::format("\n%d %d %d", readSelectorValue(_segMan, object, SELECTOR(font)),
+				                               readSelectorValue(_segMan, object, SELECTOR(fore)),
+				                               readSelectorValue(_segMan, object, SELECTOR(dimmed)));
+				itemEntry->textHash = Common::hashit(text.c_str());
+			}
+
+			if (itemEntry->plane != previousEntry.plane || itemEntry->viewId != previousEntry.viewId ||
+				itemEntry->loopNo != previousEntry.loopNo || itemEntry->celNo != previousEntry.celNo ||
+				itemEntry->x != previousEntry.x || itemEntry->y != previousEntry.y || itemEntry->z != previousEntry.z ||
+				itemEntry->priority != previousEntry.priority || itemEntry->signal != previousEntry.signal ||
+				itemEntry->scaleX != previousEntry.scaleX || itemEntry->scaleY != previousEntry.scaleY ||
+				itemEntry->useInsetRect != previousEntry.useInsetRect || itemEntry->insetRect != previousEntry.insetRect ||
+				itemEntry->textHash != previousEntry.textHash)
+				itemEntry->changed = true;
 			return;
 		}
 	}
 }
 
 void GfxFrameout::kernelDeleteScreenItem(reg_t object) {
-	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
-		FrameoutEntry *itemEntry = *listIterator;
+	for (uint itemNr = 0; itemNr < _screenItems.size(); itemNr++) {
+		FrameoutEntry *itemEntry = _screenItems[itemNr];
 		if (itemEntry->object == object) {
-			_screenItems.remove(itemEntry);
+			if (itemEntry->drawnElsewhere)
+				_fullRedraw = true;
+			else
+				addDirtyRect(itemEntry->drawnRect);
+			_screenItems.remove_at(itemNr);
+			delete itemEntry;
 			return;
 		}
 	}
@@ -274,15 +362,6 @@ void GfxFrameout::kernelAddPicAt(reg_t planeObj, int16 forWidth, GuiResourceId p
 	addPlanePicture(planeObj, pictureId, forWidth);
 }
 
-bool sortHelper(const FrameoutEntry* entry1, const FrameoutEntry* entry2) {
-	if (entry1->priority == entry2->priority) {
-		if (entry1->y == entry2->y)
-			return (entry1->givenOrderNr < entry2->givenOrderNr);
-		return (entry1->y < entry2->y);
-	}
-	return (entry1->priority < entry2->priority);
-}
-
 bool planeSortHelper(const PlaneEntry &entry1, const PlaneEntry &entry2) {
 //	SegManager *segMan = g_sci->getEngineState()->_segMan;
 
@@ -349,6 +428,48 @@ static int16 GetLongest(const char *text, int16 maxWidth, GfxFont *font) {
 	return maxChars;
 }
 
+void GfxFrameout::sortScreenItems() {
+	// The items hardly ever change their order from one frame to the next,
+	// so an insertion sort only has to go over them once
+	for (uint i = 1; i < _screenItems.size(); i++) {
+		FrameoutEntry *itemEntry = _screenItems[i];
+		uint j = i;
+		for (; j > 0 && sortHelper(itemEntry, _screenItems[j - 1]); j--)
+			_screenItems[j] = _screenItems[j - 1];
+		_screenItems[j] = itemEntry;
+	}
+}
+
+void GfxFrameout::addDirtyRect(const Common::Rect &rect) {
+	Common::Rect dirtyRect = rect;
+	dirtyRect.clip(Common::Rect(_screen->getWidth(), _screen->getHeight()));
+	if (dirtyRect.isEmpty())
+		return;
+
+	// Merge it with the rects it overlaps, they mostly belong to the same item
+	for (uint i = 0; i < _dirtyRects.size();) {
+		if (_dirtyRects[i].intersects(dirtyRect)) {
+			dirtyRect.extend(_dirtyRects[i]);
+			_dirtyRects.remove_at(i);
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+	_dirtyRects.push_back(dirtyRect);
+}
+
+void GfxFrameout::showDirtyRects() {
+	if (_fullRedraw) {
+		_screen->copyToScreen();
+	} else {
+		for (uint i = 0; i < _dirtyRects.size(); i++)
+			_screen->copyRectToScreen(_dirtyRects[i]);
+	}
+	_dirtyRects.clear();
+	_fullRedraw = false;
+}
+
 void GfxFrameout::kernelFrameout() {
 	if (g_sci->_robotDecoder->isVideoLoaded()) {
 		bool skipVideo = false;
@@ -380,86 +501,291 @@ void GfxFrameout::kernelFrameout() {
 
 			g_system->delayMillis(10);
 		}
+		// The video went straight to the screen
+		_fullRedraw = true;
 		return;
 	}
 
 	_palette->palVaryUpdate();
 
+	// Find out what changed since the last frame. Update priority here, sq6
+	// sets it w/o UpdatePlane
 	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
-		reg_t planeObject = it->object;
-		uint16 planeLastPriority = it->lastPriority;
+		it->priority = readSelectorValue(_segMan, it->object, SELECTOR(priority));
+		if (it->priority != it->lastPriority)
+			_fullRedraw = true;
+	}
+
+	bool itemsChanged = false;
+	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
+		FrameoutEntry *itemEntry = *listIterator;
+		reg_t itemPlane = readSelector(_segMan, itemEntry->object, SELECTOR(plane));
+
+		bool planeShown = false;
+		for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
+			if (it->object == itemPlane) {
+				planeShown = (it->priority != 0xffff);
+				break;
+			}
+		}
+
+		if (planeShown)
+			kernelUpdateScreenItem(itemEntry->object);	// TODO: Why is this necessary?
+		else if (itemPlane != itemEntry->plane)
+			itemEntry->changed = true;
+		itemEntry->plane = itemPlane;
+
+		if (itemEntry->changed)
+			itemsChanged = true;
+	}
+
+	// Nothing to do, if the screen would look the same as before
+	if (!_fullRedraw && !itemsChanged && _dirtyRects.empty()) {
+		for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
+			if (it->priority != 0xffff) {
+				_coordAdjuster->pictureSetDisplayArea(it->planeRect);
+				_palette->drewPicture(it->pictureId);
+			}
+		}
+		g_sci->getEngineState()->_throttleTrigger = true;
+		return;
+	}
 
-		// Update priority here, sq6 sets it w/o UpdatePlane
-		uint16 planePriority = it->priority = readSelectorValue(_segMan, planeObject, SELECTOR(priority));
+	sortScreenItems();
+
+	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
+		FrameoutEntry *itemEntry = *listIterator;
+		itemEntry->lastDrawnRect = itemEntry->drawnRect;
+		itemEntry->lastDrawnElsewhere = itemEntry->drawnElsewhere;
+		itemEntry->drawnRect = Common::Rect();
+		itemEntry->drawnElsewhere = false;
+		itemEntry->visible = false;
+	}
+
+	// First find out where everything goes, then draw only what is needed
+	Common::Array<FrameoutList> planeItemLists;
+	bool drawnElsewhere = false;
+
+	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
+		uint16 planeLastPriority = it->lastPriority;
+		uint16 planePriority = it->priority;
 
 		it->lastPriority = planePriority;
 		if (planePriority == 0xffff) { // Plane currently not meant to be shown
 			// If plane was shown before, delete plane rect
 			if (planePriority != planeLastPriority)
 				_paint32->fillRect(it->planeRect, 0);
+			planeItemLists.push_back(FrameoutList());
 			continue;
 		}
 
-		if (it->planeBack)
-			_paint32->fillRect(it->planeRect, it->planeBack);
-
-		GuiResourceId planeMainPictureId = it->pictureId;
-
 		_coordAdjuster->pictureSetDisplayArea(it->planeRect);
-		_palette->drewPicture(planeMainPictureId);
+		_palette->drewPicture(it->pictureId);
 
-		FrameoutList itemList;
+		planeItemLists.push_back(getPlaneItems(it->object));
 
-		// Copy screen items of the current frame to the list of items to be drawn
-		for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
-			reg_t itemPlane = readSelector(_segMan, (*listIterator)->object, SELECTOR(plane));
-			if (planeObject == itemPlane) {
-				kernelUpdateScreenItem((*listIterator)->object);	// TODO: Why is this necessary?
-				itemList.push_back(*listIterator);
+		const FrameoutList &itemList = planeItemLists.back();
+		for (FrameoutList::const_iterator listIterator = itemList.begin(); listIterator != itemList.end(); listIterator++) {
+			FrameoutEntry *itemEntry = *listIterator;
+			if (!itemEntry->object.isNull()) {
+				placeScreenItem(*it, itemEntry);
+				if (itemEntry->drawnElsewhere)
+					drawnElsewhere = true;
 			}
 		}
+	}
 
-		for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
-			if (pictureIt->object == planeObject) {
-				GfxPicture *planePicture = pictureIt->picture;
-				// Allocate memory for picture cels
-				pictureIt->pictureCels = new FrameoutEntry[planePicture->getSci32celCount()];
-
-				// Add following cels to the itemlist
-				FrameoutEntry *picEntry = pictureIt->pictureCels;
-				int planePictureCels = planePicture->getSci32celCount();
-				for (int pictureCelNr = 0; pictureCelNr < planePictureCels; pictureCelNr++) {
-					picEntry->celNo = pictureCelNr;
-					picEntry->object = NULL_REG;
-					picEntry->picture = planePicture;
-					picEntry->y = planePicture->getSci32celY(pictureCelNr);
-					picEntry->x = planePicture->getSci32celX(pictureCelNr);
-					picEntry->picStartX = pictureIt->startX;
-
-					picEntry->priority = planePicture->getSci32celPriority(pictureCelNr);
-
-					itemList.push_back(picEntry);
-					picEntry++;
-				}
+	// Work out which parts of the screen look different now
+	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
+		FrameoutEntry *itemEntry = *listIterator;
+		if (itemEntry->changed || itemEntry->drawnRect != itemEntry->lastDrawnRect || itemEntry->drawnElsewhere != itemEntry->lastDrawnElsewhere) {
+			if (itemEntry->drawnElsewhere || itemEntry->lastDrawnElsewhere) {
+				_fullRedraw = true;
+			} else {
+				addDirtyRect(itemEntry->lastDrawnRect);
+				addDirtyRect(itemEntry->drawnRect);
+			}
+		}
+		itemEntry->changed = false;
+	}
+
+	// Text and hires cels can't be drawn clipped, and their area isn't
+	// known, so the plane background would cover them
+	if (drawnElsewhere && !_dirtyRects.empty())
+		_fullRedraw = true;
+
+	if (_fullRedraw) {
+		drawPlanes(planeItemLists, Common::Rect(_screen->getWidth(), _screen->getHeight()), true);
+	} else {
+		for (uint i = 0; i < _dirtyRects.size(); i++)
+			drawPlanes(planeItemLists, _dirtyRects[i], false);
+	}
+
+	showDirtyRects();
+
+	g_sci->getEngineState()->_throttleTrigger = true;
+}
+
+FrameoutList GfxFrameout::getPlaneItems(reg_t planeObject) {
+	// Both the screen items and the picture cels are already sorted, so
+	// they only have to be merged
+	FrameoutList itemList;
+	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
+		if ((*listIterator)->plane == planeObject)
+			itemList.push_back(*listIterator);
+	}
+
+	for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
+		if (pictureIt->object == planeObject) {
+			const FrameoutList &pictureCels = pictureIt->sortedPictureCels;
+			FrameoutList mergedList;
+			uint itemNr = 0, celNr = 0;
+			while (itemNr < itemList.size() || celNr < pictureCels.size()) {
+				if (celNr < pictureCels.size() && (itemNr == itemList.size() || !sortHelper(itemList[itemNr], pictureCels[celNr])))
+					mergedList.push_back(pictureCels[celNr++]);
+				else
+					mergedList.push_back(itemList[itemNr++]);
 			}
+			itemList = mergedList;
+		}
+	}
+
+	return itemList;
+}
+
+void GfxFrameout::placeScreenItem(const PlaneEntry &plane, FrameoutEntry *itemEntry) {
+	if (itemEntry->viewId == 0xFFFF) {
+		// Most likely a text entry
+		if (lookupSelector(_segMan, itemEntry->object, SELECTOR(text), NULL, NULL) == kSelectorVariable) {
+			itemEntry->visible = true;
+			itemEntry->drawnElsewhere = true;
+		}
+		return;
+	}
+
+	GfxView *view = _cache->getView(itemEntry->viewId);
+	int16 itemX = itemEntry->x;
+	int16 itemY = itemEntry->y;
+	int16 itemZ = itemEntry->z;
+	Common::Rect &celRect = itemEntry->celRect;
+
+//	warning("view %s %04x:%04x", _segMan->getObjectName(itemEntry->object), PRINT_REG(itemEntry->object));
+
+	if (view->isSci2Hires()) {
+		int16 dummyX = 0;
+		view->adjustToUpscaledCoordinates(itemY, itemX);
+		view->adjustToUpscaledCoordinates(itemZ, dummyX);
+	} else if (getSciVersion() == SCI_VERSION_2_1) {
+		itemY = (itemY * _screen->getHeight()) / scriptsRunningHeight;
+		itemX = (itemX * _screen->getWidth()) / scriptsRunningWidth;
+		itemZ = (itemZ * _screen->getHeight()) / scriptsRunningHeight;
+	}
+
+	// Adjust according to current scroll position
+	itemX -= plane.planeOffsetX;
+
+	if (itemEntry->useInsetRect) {
+		celRect = itemEntry->insetRect;
+		if (view->isSci2Hires()) {
+			view->adjustToUpscaledCoordinates(celRect.top, celRect.left);
+			view->adjustToUpscaledCoordinates(celRect.bottom, celRect.right);
+		}
+		celRect.translate(itemX, itemY);
+		// TODO: maybe we should clip the cels rect with this, i'm not sure
+		//  the only currently known usage is game menu of gk1
+	} else {
+		if ((itemEntry->scaleX == 128) && (itemEntry->scaleY == 128))
+			view->getCelRect(itemEntry->loopNo, itemEntry->celNo, itemX, itemY, itemZ, celRect);
+		else
+			view->getCelScaledRect(itemEntry->loopNo, itemEntry->celNo, itemX, itemY, itemZ, itemEntry->scaleX, itemEntry->scaleY, celRect);
+
+		Common::Rect nsRect = celRect;
+		// Translate back to actual coordinate within scrollable plane
+		nsRect.translate(plane.planeOffsetX, 0);
+
+		if (view->isSci2Hires()) {
+			view->adjustBackUpscaledCoordinates(nsRect.top, nsRect.left);
+			view->adjustBackUpscaledCoordinates(nsRect.bottom, nsRect.right);
+		} else if (getSciVersion() == SCI_VERSION_2_1) {
+			nsRect.top = (nsRect.top * scriptsRunningHeight) / _screen->getHeight();
+			nsRect.left = (nsRect.left * scriptsRunningWidth) / _screen->getWidth();
+			nsRect.bottom = (nsRect.bottom * scriptsRunningHeight) / _screen->getHeight();
+			nsRect.right = (nsRect.right * scriptsRunningWidth) / _screen->getWidth();
 		}
 
-		// Now sort our itemlist
-		Common::sort(itemList.begin(), itemList.end(), sortHelper);
+		writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsLeft), nsRect.left);
+		writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsTop), nsRect.top);
+		writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsRight), nsRect.right);
+		writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsBottom), nsRect.bottom);
+	}
+
+	int16 screenHeight = _screen->getHeight();
+	int16 screenWidth = _screen->getWidth();
+	if (view->isSci2Hires()) {
+		screenHeight = _screen->getDisplayHeight();
+		screenWidth = _screen->getDisplayWidth();
+	}
+
+	if (celRect.bottom < 0 || celRect.top >= screenHeight)
+		return;
+
+	if (celRect.right < 0 || celRect.left >= screenWidth)
+		return;
+
+	Common::Rect &clipRect = itemEntry->clipRect;
+	Common::Rect &translatedClipRect = itemEntry->translatedClipRect;
+	clipRect = celRect;
+	if (view->isSci2Hires()) {
+		clipRect.clip(plane.upscaledPlaneClipRect);
+		translatedClipRect = clipRect;
+		translatedClipRect.translate(plane.upscaledPlaneRect.left, plane.upscaledPlaneRect.top);
+	} else {
+		clipRect.clip(plane.planeClipRect);
+		translatedClipRect = clipRect;
+		translatedClipRect.translate(plane.planeRect.left, plane.planeRect.top);
+	}
+
+	if (clipRect.isEmpty())
+		return;
+
+	itemEntry->visible = true;
 
-//		warning("Plane %s", _segMan->getObjectName(planeObject));
+	// Hires cels are drawn in display coordinates
+	if (view->isSci2Hires() || _screen->getUpscaledHires())
+		itemEntry->drawnElsewhere = true;
+	else
+		itemEntry->drawnRect = translatedClipRect;
+}
+
+void GfxFrameout::drawPlanes(const Common::Array<FrameoutList> &planeItemLists, const Common::Rect &drawRect, bool fullRedraw) {
+	uint planeNr = 0;
+	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++, planeNr++) {
+		if (it->priority == 0xffff)
+			continue;
 
-		for (FrameoutList::iterator listIterator = itemList.begin(); listIterator != itemList.end(); listIterator++) {
+		if (it->planeBack) {
+			Common::Rect backRect = it->planeRect;
+			backRect.clip(drawRect);
+			if (!backRect.isEmpty())
+				_paint32->fillRect(backRect, it->planeBack);
+		}
+
+		_coordAdjuster->pictureSetDisplayArea(it->planeRect);
+
+//		warning("Plane %s", _segMan->getObjectName(it->object));
+
+		const FrameoutList &itemList = planeItemLists[planeNr];
+		for (FrameoutList::const_iterator listIterator = itemList.begin(); listIterator != itemList.end(); listIterator++) {
 			FrameoutEntry *itemEntry = *listIterator;
 
 			if (itemEntry->object.isNull()) {
 				// Picture cel data
-				itemEntry->y = ((itemEntry->y * _screen->getHeight()) / scriptsRunningHeight);
-				itemEntry->x = ((itemEntry->x * _screen->getWidth()) / scriptsRunningWidth);
-				itemEntry->picStartX = ((itemEntry->picStartX * _screen->getWidth()) / scriptsRunningWidth);
+				int16 celY = ((itemEntry->y * _screen->getHeight()) / scriptsRunningHeight);
+				int16 celX = ((itemEntry->x * _screen->getWidth()) / scriptsRunningWidth);
+				int16 picStartX = ((itemEntry->picStartX * _screen->getWidth()) / scriptsRunningWidth);
 
 				// Out of view
-				int16 pictureCelStartX = itemEntry->picStartX + itemEntry->x;
+				int16 pictureCelStartX = picStartX + celX;
 				int16 pictureCelEndX = pictureCelStartX + itemEntry->picture->getSci32celWidth(itemEntry->celNo);
 				int16 planeStartX = it->planeOffsetX;
 				int16 planeEndX = planeStartX + it->planeRect.width();
@@ -469,181 +795,101 @@ void GfxFrameout::kernelFrameout() {
 					continue;
 
 				int16 pictureOffsetX = it->planeOffsetX;
-				int16 pictureX = itemEntry->x;
-				if ((it->planeOffsetX) || (itemEntry->picStartX)) {
-					if (it->planeOffsetX <= itemEntry->picStartX) {
-						pictureX += itemEntry->picStartX - it->planeOffsetX;
+				int16 pictureX = celX;
+				if ((it->planeOffsetX) || (picStartX)) {
+					if (it->planeOffsetX <= picStartX) {
+						pictureX += picStartX - it->planeOffsetX;
 						pictureOffsetX = 0;
 					} else {
-						pictureOffsetX = it->planeOffsetX - itemEntry->picStartX;
+						pictureOffsetX = it->planeOffsetX - picStartX;
 					}
 				}
 
-				itemEntry->picture->drawSci32Vga(itemEntry->celNo, pictureX, itemEntry->y, pictureOffsetX, it->planePictureMirrored);
+				itemEntry->picture->drawSci32Vga(itemEntry->celNo, pictureX, celY, pictureOffsetX, it->planePictureMirrored, drawRect);
 //				warning("picture cel %d %d", itemEntry->celNo, itemEntry->priority);
 
+			} else if (!itemEntry->visible) {
+				continue;
 			} else if (itemEntry->viewId != 0xFFFF) {
 				GfxView *view = _cache->getView(itemEntry->viewId);
-
-//				warning("view %s %04x:%04x", _segMan->getObjectName(itemEntry->object), PRINT_REG(itemEntry->object));
-
-
-				if (view->isSci2Hires()) {
-					int16 dummyX = 0;
-					view->adjustToUpscaledCoordinates(itemEntry->y, itemEntry->x);
-					view->adjustToUpscaledCoordinates(itemEntry->z, dummyX);
-				} else if (getSciVersion() == SCI_VERSION_2_1) {
-					itemEntry->y = (itemEntry->y * _screen->getHeight()) / scriptsRunningHeight;
-					itemEntry->x = (itemEntry->x * _screen->getWidth()) / scriptsRunningWidth;
-					itemEntry->z = (itemEntry->z * _screen->getHeight()) / scriptsRunningHeight;
-				}
-
-				// Adjust according to current scroll position
-				itemEntry->x -= it->planeOffsetX;
-
-				uint16 useInsetRect = readSelectorValue(_segMan, itemEntry->object, SELECTOR(useInsetRect));
-				if (useInsetRect) {
-					itemEntry->celRect.top = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inTop));
-					itemEntry->celRect.left = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inLeft));
-					itemEntry->celRect.bottom = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inBottom)) + 1;
-					itemEntry->celRect.right = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inRight)) + 1;
-					if (view->isSci2Hires()) {
-						view->adjustToUpscaledCoordinates(itemEntry->celRect.top, itemEntry->celRect.left);
-						view->adjustToUpscaledCoordinates(itemEntry->celRect.bottom, itemEntry->celRect.right);
-					}
-					itemEntry->celRect.translate(itemEntry->x, itemEntry->y);
-					// TODO: maybe we should clip the cels rect with this, i'm not sure
-					//  the only currently known usage is game menu of gk1
-				} else {
-					if ((itemEntry->scaleX == 128) && (itemEntry->scaleY == 128))
-						view->getCelRect(itemEntry->loopNo, itemEntry->celNo, itemEntry->x, itemEntry->y, itemEntry->z, itemEntry->celRect);
-					else
-						view->getCelScaledRect(itemEntry->loopNo, itemEntry->celNo, itemEntry->x, itemEntry->y, itemEntry->z, itemEntry->scaleX, itemEntry->scaleY, itemEntry->celRect);
-
-					Common::Rect nsRect = itemEntry->celRect;
-					// Translate back to actual coordinate within scrollable plane
-					nsRect.translate(it->planeOffsetX, 0);
-
-					if (view->isSci2Hires()) {
-						view->adjustBackUpscaledCoordinates(nsRect.top, nsRect.left);
-						view->adjustBackUpscaledCoordinates(nsRect.bottom, nsRect.right);
-					} else if (getSciVersion() == SCI_VERSION_2_1) {
-						nsRect.top = (nsRect.top * scriptsRunningHeight) / _screen->getHeight();
-						nsRect.left = (nsRect.left * scriptsRunningWidth) / _screen->getWidth();
-						nsRect.bottom = (nsRect.bottom * scriptsRunningHeight) / _screen->getHeight();
-						nsRect.right = (nsRect.right * scriptsRunningWidth) / _screen->getWidth();
-					}
-
-					writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsLeft), nsRect.left);
-					writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsTop), nsRect.top);
-					writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsRight), nsRect.right);
-					writeSelectorValue(_segMan, itemEntry->object, SELECTOR(nsBottom), nsRect.bottom);
-				}
-
-				int16 screenHeight = _screen->getHeight();
-				int16 screenWidth = _screen->getWidth();
-				if (view->isSci2Hires()) {
-					screenHeight = _screen->getDisplayHeight();
-					screenWidth = _screen->getDisplayWidth();
+				Common::Rect clipRect = itemEntry->clipRect;
+				Common::Rect translatedClipRect = itemEntry->translatedClipRect;
+
+				// Only cels with a known area get drawn clipped, see kernelFrameout()
+				if (!fullRedraw) {
+					translatedClipRect.clip(drawRect);
+					if (translatedClipRect.isEmpty())
+						continue;
+					clipRect = translatedClipRect;
+					clipRect.translate(-it->planeRect.left, -it->planeRect.top);
 				}
 
-				if (itemEntry->celRect.bottom < 0 || itemEntry->celRect.top >= screenHeight)
-					continue;
-
-				if (itemEntry->celRect.right < 0 || itemEntry->celRect.left >= screenWidth)
-					continue;
-
-				Common::Rect clipRect, translatedClipRect;
-				clipRect = itemEntry->celRect;
-				if (view->isSci2Hires()) {
-					clipRect.clip(it->upscaledPlaneClipRect);
-					translatedClipRect = clipRect;
-					translatedClipRect.translate(it->upscaledPlaneRect.left, it->upscaledPlaneRect.top);
-				} else {
-					clipRect.clip(it->planeClipRect);
-					translatedClipRect = clipRect;
-					translatedClipRect.translate(it->planeRect.left, it->planeRect.top);
-				}
-
-				if (!clipRect.isEmpty()) {
-					if ((itemEntry->scaleX == 128) && (itemEntry->scaleY == 128))
-						view->draw(itemEntry->celRect, clipRect, translatedClipRect, itemEntry->loopNo, itemEntry->celNo, 255, 0, view->isSci2Hires());
-					else
-						view->drawScaled(itemEntry->celRect, clipRect, translatedClipRect, itemEntry->loopNo, itemEntry->celNo, 255, itemEntry->scaleX, itemEntry->scaleY);
-				}
-			} else {
-				// Most likely a text entry
-				// This draws text the "SCI0-SCI11" way. In SCI2, text is prerendered in kCreateTextBitmap
-				// TODO: rewrite this the "SCI2" way (i.e. implement the text buffer to draw inside kCreateTextBitmap)
-				if (lookupSelector(_segMan, itemEntry->object, SELECTOR(text), NULL, NULL) == kSelectorVariable) {
-					reg_t stringObject = readSelector(_segMan, itemEntry->object, SELECTOR(text));
-
-					// The object in the text selector of the item can be either a raw string
-					// or a Str object. In the latter case, we need to access the object's data
-					// selector to get the raw string.
-					if (_segMan->isHeapObject(stringObject))
-						stringObject = readSelector(_segMan, stringObject, SELECTOR(data));
-
-					Common::String text = _segMan->getString(stringObject);
-					GfxFont *font = _cache->getFont(readSelectorValue(_segMan, itemEntry->object, SELECTOR(font)));
-					bool dimmed = readSelectorValue(_segMan, itemEntry->object, SELECTOR(dimmed));
-					uint16 foreColor = readSelectorValue(_segMan, itemEntry->object, SELECTOR(fore));
-
-					itemEntry->y = ((itemEntry->y * _screen->getHeight()) / scriptsRunningHeight);
-					itemEntry->x = ((itemEntry->x * _screen->getWidth()) / scriptsRunningWidth);
-
-					uint16 startX = itemEntry->x + it->planeRect.left;
-					uint16 curY = itemEntry->y + it->planeRect.top;
-					const char *txt = text.c_str();
-					// HACK. The plane sometimes doesn't contain the correct width. This
-					// hack breaks the dialog options when speaking with Grace, but it's
-					// the best we got up to now. This happens because of the unimplemented
-					// kTextWidth function in SCI32.
-					// TODO: Remove this once kTextWidth has been implemented.
-					uint16 w = it->planeRect.width() >= 20 ? it->planeRect.width() : _screen->getWidth() - 10;
-					int16 charCount;
-
-					// Upscale the coordinates/width if the fonts are already upscaled
-					if (_screen->fontIsUpscaled()) {
-						startX = startX * _screen->getDisplayWidth() / _screen->getWidth();
-						curY = curY * _screen->getDisplayHeight() / _screen->getHeight();
-						w  = w * _screen->getDisplayWidth() / _screen->getWidth();
-					}
-
-					while (*txt) {
-						charCount = GetLongest(txt, w, font);
-						if (charCount == 0)
-							break;
+				if ((itemEntry->scaleX == 128) && (itemEntry->scaleY == 128))
+					view->draw(itemEntry->celRect, clipRect, translatedClipRect, itemEntry->loopNo, itemEntry->celNo, 255, 0, view->isSci2Hires());
+				else
+					view->drawScaled(itemEntry->celRect, clipRect, translatedClipRect, itemEntry->loopNo, itemEntry->celNo, 255, itemEntry->scaleX, itemEntry->scaleY);
+			} else if (fullRedraw) {
+				drawTextItem(*it, itemEntry);
+			}
+		}
+	}
+}
 
-						uint16 curX = startX;
+void GfxFrameout::drawTextItem(const PlaneEntry &plane, FrameoutEntry *itemEntry) {
+	// This draws text the "SCI0-SCI11" way. In SCI2, text is prerendered in kCreateTextBitmap
+	// TODO: rewrite this the "SCI2" way (i.e. implement the text buffer to draw inside kCreateTextBitmap)
+	reg_t stringObject = readSelector(_segMan, itemEntry->object, SELECTOR(text));
+
+	// The object in the text selector of the item can be either a raw string
+	// or a Str object. In the latter case, we need to access the object's data
+	// selector to get the raw string.
+	if (_segMan->isHeapObject(stringObject))
+		stringObject = readSelector(_segMan, stringObject, SELECTOR(data));
+
+	Common::String text = _segMan->getString(stringObject);
+	GfxFont *font = _cache->getFont(readSelectorValue(_segMan, itemEntry->object, SELECTOR(font)));
+	bool dimmed = readSelectorValue(_segMan, itemEntry->object, SELECTOR(dimmed));
+	uint16 foreColor = readSelectorValue(_segMan, itemEntry->object, SELECTOR(fore));
+
+	int16 textY = ((itemEntry->y * _screen->getHeight()) / scriptsRunningHeight);
+	int16 textX = ((itemEntry->x * _screen->getWidth()) / scriptsRunningWidth);
+
+	uint16 startX = textX + plane.planeRect.left;
+	uint16 curY = textY + plane.planeRect.top;
+	const char *txt = text.c_str();
+	// HACK. The plane sometimes doesn't contain the correct width. This
+	// hack breaks the dialog options when speaking with Grace, but it's
+	// the best we got up to now. This happens because of the unimplemented
+	// kTextWidth function in SCI32.
+	// TODO: Remove this once kTextWidth has been implemented.
+	uint16 w = plane.planeRect.width() >= 20 ? plane.planeRect.width() : _screen->getWidth() - 10;
+	int16 charCount;
+
+	// Upscale the coordinates/width if the fonts are already upscaled
+	if (_screen->fontIsUpscaled()) {
+		startX = startX * _screen->getDisplayWidth() / _screen->getWidth();
+		curY = curY * _screen->getDisplayHeight() / _screen->getHeight();
+		w  = w * _screen->getDisplayWidth() / _screen->getWidth();
+	}
 
-						for (int i = 0; i < charCount; i++) {
-							unsigned char curChar = txt[i];
-							font->draw(curChar, curY, curX, foreColor, dimmed);
-							curX += font->getCharWidth(curChar);
-						}
+	while (*txt) {
+		charCount = GetLongest(txt, w, font);
+		if (charCount == 0)
+			break;
 
-						curY += font->getHeight();
-						txt += charCount;
-						while (*txt == ' ')
-							txt++; // skip over breaking spaces
-					}
+		uint16 curX = startX;
 
-				}
-			}
+		for (int i = 0; i < charCount; i++) {
+			unsigned char curChar = txt[i];
+			font->draw(curChar, curY, curX, foreColor, dimmed);
+			curX += font->getCharWidth(curChar);
 		}
 
-		for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
-			if (pictureIt->object == planeObject) {
-				delete[] pictureIt->pictureCels;
-				pictureIt->pictureCels = 0;
-			}
-		}
+		curY += font->getHeight();
+		txt += charCount;
+		while (*txt == ' ')
+			txt++; // skip over breaking spaces
 	}
-
-	_screen->copyToScreen();
-
-	g_sci->getEngineState()->_throttleTrigger = true;
 }
 
 } // End of namespace Sci
@@ -49,6 +49,7 @@ typedef Common::List<PlaneEntry> PlaneList;
 struct FrameoutEntry {
 	uint16 givenOrderNr;
 	reg_t object;
+	reg_t plane;
 	GuiResourceId viewId;
 	int16 loopNo;
 	int16 celNo;
@@ -58,19 +59,34 @@ struct FrameoutEntry {
 	uint16 scaleSignal;
 	int16 scaleX;
 	int16 scaleY;
-	Common::Rect celRect;
+	bool useInsetRect;
+	Common::Rect insetRect;
+	uint32 textHash; ///< Text items only: hash of the text and how it is drawn
 	GfxPicture *picture;
 	int16 picStartX;
+
+	// View items only: where the cel goes in the current frame
+	Common::Rect celRect;
+	Common::Rect clipRect; ///< celRect, clipped to the plane
+	Common::Rect translatedClipRect; ///< clipRect, in screen coordinates
+	bool visible; ///< Gets drawn in the current frame
+
+	bool changed; ///< Changed since it was last drawn
+	Common::Rect drawnRect; ///< Where it got drawn in the last frame, in screen coordinates
+	bool drawnElsewhere; ///< It got drawn in the last frame, but its area isn't known
+	Common::Rect lastDrawnRect;
+	bool lastDrawnElsewhere;
 };
 
-typedef Common::List<FrameoutEntry *> FrameoutList;
+typedef Common::Array<FrameoutEntry *> FrameoutList;
 
 struct PlanePictureEntry {
 	reg_t object;
 	int16 startX;
 	GuiResourceId pictureId;
 	GfxPicture *picture;
-	FrameoutEntry *pictureCels; // temporary
+	FrameoutEntry *pictureCels;
+	FrameoutList sortedPictureCels; ///< pictureCels, in drawing order
 };
 
 typedef Common::List<PlanePictureEntry> PlanePictureList;
@@ -103,6 +119,9 @@ public:
 	void deletePlanePictures(reg_t object);
 	void clear();
 
+	/** Makes the next frame get drawn and shown in full, after something else drew on the screen */
+	void forceFullRedraw() { _fullRedraw = true; }
+
 private:
 	SegManager *_segMan;
 	ResourceManager *_resMan;
@@ -117,6 +136,19 @@ private:
 	PlanePictureList _planePictures;
 
 	void sortPlanes();
+	void sortScreenItems();
+	FrameoutList getPlaneItems(reg_t planeObject);
+	void placeScreenItem(const PlaneEntry &plane, FrameoutEntry *itemEntry);
+	void drawPlanes(const Common::Array<FrameoutList> &planeItemLists, const Common::Rect &drawRect, bool fullRedraw);
+	void drawTextItem(const PlaneEntry &plane, FrameoutEntry *itemEntry);
+	void addDirtyRect(const Common::Rect &rect);
+	void showDirtyRects();
+
+	// The parts of the screen which changed since the last frame. Only these
+	// get drawn again and copied to the actual screen. Text can't be drawn
+	// clipped, so the whole screen is drawn while any text is shown.
+	Common::Array<Common::Rect> _dirtyRects;
+	bool _fullRedraw; ///< true, if the whole screen has to be drawn
 
 	uint16 scriptsRunningWidth;
 	uint16 scriptsRunningHeight;
@@ -51,9 +51,11 @@ namespace Sci {
 
 GfxPaint16::GfxPaint16(ResourceManager *resMan, SegManager *segMan, Kernel *kernel, GfxCache *cache, GfxPorts *ports, GfxCoordAdjuster *coordAdjuster, GfxScreen *screen, GfxPalette *palette, GfxTransitions *transitions, AudioPlayer *audio)
 	: _resMan(resMan), _segMan(segMan), _kernel(kernel), _cache(cache), _ports(ports), _coordAdjuster(coordAdjuster), _screen(screen), _palette(palette), _transitions(transitions), _audio(audio) {
+	_maxCachedPictures = MAX_CACHED_PICTURES;
 }
 
 GfxPaint16::~GfxPaint16() {
+	purgePictureCache(0);
 }
 
 void GfxPaint16::init(GfxAnimate *animate, GfxText16 *text16) {
@@ -67,15 +69,129 @@ void GfxPaint16::debugSetEGAdrawingVisualize(bool state) {
 	_EGAdrawingVisualize = state;
 }
 
+/**
+ * A picture which was drawn on a cleared screen, and everything needed to
+ * draw it again without going through its vector data
+ */
+struct CachedPicture {
+	GuiResourceId pictureId;
+	int16 animationNr;
+	bool mirroredFlag;
+	int16 EGApaletteNo;
+	bool undithered;
+	Common::Rect rect; ///< The picture port, in screen coordinates
+	byte *bits; ///< The picture port area, saved by GfxScreen::bitsSave()
+	PictureSideEffects sideEffects;
+	int16 ditheredPicColors[DITHERED_BG_COLORS_SIZE]; ///< Only used when undithering
+};
+
+void GfxPaint16::setMaxCachedPictures(uint count) {
+	_maxCachedPictures = count;
+	purgePictureCache(count);
+}
+
+void GfxPaint16::purgePictureCache(uint maxCount) {
+	while (_cachedPictures.size() > maxCount) {
+		CachedPicture *cachedPicture = _cachedPictures.back();
+		delete[] cachedPicture->bits;
+		delete cachedPicture;
+		_cachedPictures.pop_back();
+	}
+}
+
+// Returns the area which drawPicture() clears, or an empty rect if pictures
+// may also be drawn outside of it
+Common::Rect GfxPaint16::getPictureCacheRect() {
+	Common::Rect rect = _ports->_curPort->rect;
+	_ports->offsetRect(rect);
+	if (rect.left != 0 || rect.right != _screen->getWidth() || rect.bottom != _screen->getHeight() || rect.top < 0)
+		return Common::Rect();
+	return rect;
+}
+
+bool GfxPaint16::drawCachedPicture(GuiResourceId pictureId, int16 animationNr, bool mirroredFlag, int16 EGApaletteNo) {
+	Common::Rect rect = getPictureCacheRect();
+	bool undithered = _screen->getUnditherState();
+
+	for (Common::List<CachedPicture *>::iterator it = _cachedPictures.begin(); it != _cachedPictures.end(); ++it) {
+		CachedPicture *cachedPicture = *it;
+		if (cachedPicture->pictureId != pictureId || cachedPicture->animationNr != animationNr ||
+			cachedPicture->mirroredFlag != mirroredFlag || cachedPicture->EGApaletteNo != EGApaletteNo ||
+			cachedPicture->undithered != undithered || cachedPicture->rect != rect)
+			continue;
+
+		_screen->bitsRestore(cachedPicture->bits);
+
+		const PictureSideEffects &sideEffects = cachedPicture->sideEffects;
+		if (sideEffects.paletteSet) {
+			Palette palette = sideEffects.palette;
+			_palette->set(&palette, true);
+		}
+		switch (sideEffects.priorityBands) {
+		case kPicturePriorityBandsEqualDistance:
+			_ports->priorityBandsInit(-1, sideEffects.priorityTop, sideEffects.priorityBottom);
+			break;
+		case kPicturePriorityBandsExplicit: {
+			byte priorityBandsData[14];
+			memcpy(priorityBandsData, sideEffects.priorityBandsData, sizeof(priorityBandsData));
+			_ports->priorityBandsInit(priorityBandsData);
+			break;
+		}
+		default:
+			break;
+		}
+		int16 *ditheredPicColors = _screen->unditherGetDitheredBgColors();
+		if (ditheredPicColors)
+			memcpy(ditheredPicColors, cachedPicture->ditheredPicColors, sizeof(cachedPicture->ditheredPicColors));
+
+		// Move it to the front
+		_cachedPictures.erase(it);
+		_cachedPictures.push_front(cachedPicture);
+		return true;
+	}
+	return false;
+}
+
+void GfxPaint16::cachePicture(GuiResourceId pictureId, int16 animationNr, bool mirroredFlag, int16 EGApaletteNo, const PictureSideEffects &sideEffects) {
+	Common::Rect rect = getPictureCacheRect();
+	if (rect.isEmpty())
+		return;
+
+	purgePictureCache(_maxCachedPictures - 1);
+
+	CachedPicture *cachedPicture = new CachedPicture();
+	cachedPicture->pictureId = pictureId;
+	cachedPicture->animationNr = animationNr;
+	cachedPicture->mirroredFlag = mirroredFlag;
+	cachedPicture->EGApaletteNo = EGApaletteNo;
+	cachedPicture->undithered = _screen->getUnditherState();
+	cachedPicture->rect = rect;
+	cachedPicture->bits = new byte[_screen->bitsGetDataSize(rect, GFX_SCREEN_MASK_ALL)];
+	_screen->bitsSave(rect, GFX_SCREEN_MASK_ALL, cachedPicture->bits);
+	cachedPicture->sideEffects = sideEffects;
+	int16 *ditheredPicColors = _screen->unditherGetDitheredBgColors();
+	if (ditheredPicColors)
+		memcpy(cachedPicture->ditheredPicColors, ditheredPicColors, sizeof(cachedPicture->ditheredPicColors));
+	_cachedPictures.push_front(cachedPicture);
+}
+
 void GfxPaint16::drawPicture(GuiResourceId pictureId, int16 animationNr, bool mirroredFlag, bool addToFlag, GuiResourceId paletteId) {
-	GfxPicture *picture = new GfxPicture(_resMan, _coordAdjuster, _ports, _screen, _palette, pictureId, _EGAdrawingVisualize);
+	// A picture drawn on a cleared screen always looks the same, so the
+	// result of the last few ones is kept
+	bool useCache = !addToFlag && !_EGAdrawingVisualize && _maxCachedPictures > 0;
+
+	if (!useCache || !drawCachedPicture(pictureId, animationNr, mirroredFlag, paletteId)) {
+		GfxPicture *picture = new GfxPicture(_resMan, _coordAdjuster, _ports, _screen, _palette, pictureId, _EGAdrawingVisualize);
 
-	// do we add to a picture? if not -> clear screen with white
-	if (!addToFlag)
-		clearScreen(_screen->getColorWhite());
+		// do we add to a picture? if not -> clear screen with white
+		if (!addToFlag)
+			clearScreen(_screen->getColorWhite());
 
-	picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
-	delete picture;
+		picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+		if (useCache && picture->getSideEffects().replayable)
+			cachePicture(pictureId, animationNr, mirroredFlag, paletteId, picture->getSideEffects());
+		delete picture;
+	}
 
 	// We make a call to SciPalette here, for increasing sys timestamp and also loading targetpalette, if palvary active
 	//  (SCI1.1 only)
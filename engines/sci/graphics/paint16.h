@@ -29,6 +29,7 @@
 #include "sci/graphics/paint.h"
 
 #include "common/hashmap.h"
+#include "common/list.h"
 
 namespace Sci {
 
@@ -37,6 +38,8 @@ class GfxScreen;
 class GfxPalette;
 class Font;
 class GfxView;
+struct PictureSideEffects;
+struct CachedPicture;
 
 /**
  * Paint16 class, handles painting/drawing for SCI16 (SCI0-SCI1.1) games
@@ -50,6 +53,9 @@ public:
 
 	void debugSetEGAdrawingVisualize(bool state);
 
+	/** Sets how many drawn pictures are kept, 0 disables the picture cache */
+	void setMaxCachedPictures(uint count);
+
 	void drawPicture(GuiResourceId pictureId, int16 animationNr, bool mirroredFlag, bool addToFlag, GuiResourceId paletteId);
 	void drawCelAndShow(GuiResourceId viewId, int16 loopNo, int16 celNo, uint16 leftPos, uint16 topPos, byte priority, uint16 paletteNo, uint16 scaleX = 128, uint16 scaleY = 128);
 	void drawCel(GuiResourceId viewId, int16 loopNo, int16 celNo, const Common::Rect &celRect, byte priority, uint16 paletteNo, uint16 scaleX = 128, uint16 scaleY = 128);
@@ -92,6 +98,11 @@ public:
 	void kernelPortraitUnload(uint16 portraitId);
 
 private:
+	bool drawCachedPicture(GuiResourceId pictureId, int16 animationNr, bool mirroredFlag, int16 EGApaletteNo);
+	void cachePicture(GuiResourceId pictureId, int16 animationNr, bool mirroredFlag, int16 EGApaletteNo, const PictureSideEffects &sideEffects);
+	void purgePictureCache(uint maxCount);
+	Common::Rect getPictureCacheRect();
+
 	ResourceManager *_resMan;
 	SegManager *_segMan;
 	Kernel *_kernel;
@@ -107,6 +118,11 @@ private:
 
 	// true means make EGA picture drawing visible
 	bool _EGAdrawingVisualize;
+
+	// The screens of the last pictures which were drawn on a cleared screen,
+	// most recently drawn first
+	Common::List<CachedPicture *> _cachedPictures;
+	uint _maxCachedPictures;
 };
 
 } // End of namespace Sci
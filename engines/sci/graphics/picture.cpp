@@ -71,6 +71,9 @@ void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int1
 	_EGApaletteNo = EGApaletteNo;
 	_priority = 0;
 
+	// Only vector pictures record their side effects
+	memset(&_sideEffects, 0, sizeof(_sideEffects));
+
 	headerSize = READ_LE_UINT16(_resource->data);
 	switch (headerSize) {
 	case 0x26: // SCI 1.1 VGA picture
@@ -86,6 +89,7 @@ void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int1
 	default:
 		// VGA, EGA or Amiga vector data
 		_resourceType = SCI_PICTURE_TYPE_REGULAR;
+		_sideEffects.replayable = !_EGAdrawingVisualize;
 		drawVectorData(_resource->data, _resource->size);
 	}
 }
@@ -179,7 +183,7 @@ int16 GfxPicture::getSci32celPriority(int16 celNo) {
 	return READ_SCI11ENDIAN_UINT16(inbuffer + cel_headerPos + 36);
 }
 
-void GfxPicture::drawSci32Vga(int16 celNo, int16 drawX, int16 drawY, int16 pictureX, bool mirrored) {
+void GfxPicture::drawSci32Vga(int16 celNo, int16 drawX, int16 drawY, int16 pictureX, bool mirrored, const Common::Rect &clipRect) {
 	byte *inbuffer = _resource->data;
 	int size = _resource->size;
 	int header_size = READ_SCI11ENDIAN_UINT16(inbuffer);
@@ -219,14 +223,14 @@ void GfxPicture::drawSci32Vga(int16 celNo, int16 drawX, int16 drawY, int16 pictu
 	cel_RlePos = READ_SCI11ENDIAN_UINT32(inbuffer + cel_headerPos + 24);
 	cel_LiteralPos = READ_SCI11ENDIAN_UINT32(inbuffer + cel_headerPos + 28);
 
-	drawCelData(inbuffer, size, cel_headerPos, cel_RlePos, cel_LiteralPos, drawX, drawY, pictureX);
+	drawCelData(inbuffer, size, cel_headerPos, cel_RlePos, cel_LiteralPos, drawX, drawY, pictureX, &clipRect);
 	cel_headerPos += 42;
 }
 #endif
 
 extern void unpackCelData(byte *inBuffer, byte *celBitmap, byte clearColor, int pixelCount, int rlePos, int literalPos, ViewType viewType, uint16 width, bool isMacSci11ViewData);
 
-void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos, int literalPos, int16 drawX, int16 drawY, int16 pictureX) {
+void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos, int literalPos, int16 drawX, int16 drawY, int16 pictureX, const Common::Rect *clipRect) {
 	byte *celBitmap = NULL;
 	byte *ptr = NULL;
 	byte *headerPtr = inbuffer + headerPos;
@@ -268,6 +272,17 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 	if (displaceX || displaceY)
 		error("unsupported embedded cel-data in picture");
 
+	// Don't unpack the cel, if none of it is inside the clip rect
+	if (clipRect) {
+		Common::Rect displayArea = _coordAdjuster->pictureGetDisplayArea();
+		int16 celLeft = displayArea.left + MAX<int16>(drawX - pictureX, 0);
+		int16 celRight = MIN<int16>(displayArea.left + drawX - pictureX + width, displayArea.right);
+		int16 celTop = displayArea.top + drawY;
+		int16 celBottom = MIN<int16>(celTop + height, displayArea.bottom);
+		if (celLeft >= celRight || celTop >= celBottom || !clipRect->intersects(Common::Rect(celLeft, celTop, celRight, celBottom)))
+			return;
+	}
+
 	// We will unpack cel-data into a temporary buffer and then plot it to screen
 	//  That needs to be done cause a mirrored picture may be requested
 	pixelCount = width * height;
@@ -335,6 +350,9 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 
 		byte drawMask = priority == 255 ? GFX_SCREEN_MASK_VISUAL : GFX_SCREEN_MASK_VISUAL | GFX_SCREEN_MASK_PRIORITY;
 
+		// Only the pixels inside clipRect get drawn, if given
+		const Common::Rect clip = clipRect ? *clipRect : Common::Rect(_screen->getWidth(), _screen->getHeight());
+
 		ptr = celBitmap;
 		ptr += skipCelBitmapPixels;
 		if (!_mirroredFlag) {
@@ -342,7 +360,7 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 			x = leftX;
 			while (y < lastY) {
 				curByte = *ptr++;
-				if ((curByte != clearColor) && (priority >= _screen->getPriority(x, y)))
+				if ((curByte != clearColor) && clip.contains(x, y) && (priority >= _screen->getPriority(x, y)))
 					_screen->putPixel(x, y, drawMask, curByte, priority, 0);
 
 				x++;
@@ -358,7 +376,7 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 			x = rightX - 1;
 			while (y < lastY) {
 				curByte = *ptr++;
-				if ((curByte != clearColor) && (priority >= _screen->getPriority(x, y)))
+				if ((curByte != clearColor) && clip.contains(x, y) && (priority >= _screen->getPriority(x, y)))
 					_screen->putPixel(x, y, drawMask, curByte, priority, 0);
 			
 				if (x == leftX) {
@@ -717,6 +735,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 					break;
 				case PIC_OPX_EGA_SET_PRIORITY_TABLE:
 					_ports->priorityBandsInit(data + curPos);
+					_sideEffects.priorityBands = kPicturePriorityBandsExplicit;
+					memcpy(_sideEffects.priorityBandsData, data + curPos, 14);
 					curPos += 14;
 					break;
 				default:
@@ -740,6 +760,7 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 						} else {
 							// Setting half of the amiga palette
 							_palette->modifyAmigaPalette(&data[curPos]);
+							_sideEffects.replayable = false;
 							curPos += 32;
 						}
 					} else {
@@ -749,6 +770,12 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 							palette.colors[i].r = data[curPos++]; palette.colors[i].g = data[curPos++]; palette.colors[i].b = data[curPos++];
 						}
 						_palette->set(&palette, true);
+						// Setting the palette again may give a different result
+						// when merging, so only a single one is replayed
+						if (_sideEffects.paletteSet)
+							_sideEffects.replayable = false;
+						_sideEffects.paletteSet = true;
+						_sideEffects.palette = palette;
 					}
 					break;
 				case PIC_OPX_VGA_EMBEDDED_VIEW: // draw cel
@@ -760,10 +787,15 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 					break;
 				case PIC_OPX_VGA_PRIORITY_TABLE_EQDIST:
 					_ports->priorityBandsInit(-1, READ_LE_UINT16(data + curPos), READ_LE_UINT16(data + curPos + 2));
+					_sideEffects.priorityBands = kPicturePriorityBandsEqualDistance;
+					_sideEffects.priorityTop = READ_LE_UINT16(data + curPos);
+					_sideEffects.priorityBottom = READ_LE_UINT16(data + curPos + 2);
 					curPos += 4;
 					break;
 				case PIC_OPX_VGA_PRIORITY_TABLE_EXPLICIT:
 					_ports->priorityBandsInit(data + curPos);
+					_sideEffects.priorityBands = kPicturePriorityBandsExplicit;
+					memcpy(_sideEffects.priorityBandsData, data + curPos, 14);
 					curPos += 14;
 					break;
 				default:
@@ -860,7 +892,7 @@ void GfxPicture::vectorGetPatternTexture(byte *data, int &curPos, int16 pattern_
 // Do not replace w/ some generic code. This algo really needs to behave exactly as the one from sierra
 void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, byte control) {
 	Port *curPort = _ports->getPort();
-	Common::Stack<Common::Point> stack;
+	Common::Stack<Common::Point> &stack = _floodFillStack;
 	Common::Point p, p1;
 	byte screenMask = _screen->getDrawingMask(color, priority, control);
 	byte matchedMask, matchMask;
@@ -929,14 +961,17 @@ void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, by
 		p = stack.pop();
 		if ((matchedMask = _screen->isFillMatch(p.x, p.y, matchMask, searchColor, searchPriority, searchControl, isEGA)) == 0) // already filled
 			continue;
-		_screen->putPixel(p.x, p.y, screenMask, color, priority, control);
 		w = p.x;
 		e = p.x;
 		// moving west and east pointers as long as there is a matching color to fill
 		while (w > l && (matchedMask = _screen->isFillMatch(w - 1, p.y, matchMask, searchColor, searchPriority, searchControl, isEGA)))
-			_screen->putPixel(--w, p.y, screenMask, color, priority, control);
+			w--;
 		while (e < r && (matchedMask = _screen->isFillMatch(e + 1, p.y, matchMask, searchColor, searchPriority, searchControl, isEGA)))
-			_screen->putPixel(++e, p.y, screenMask, color, priority, control);
+			e++;
+		// filling the whole span at once. The matches above only looked at
+		// pixels of this line which weren't filled yet, so this is the same
+		// as filling each pixel right after matching it
+		_screen->putPixelSpan(w, e, p.y, screenMask, color, priority, control);
 		// checking lines above and below for possible flood targets
 		a_set = b_set = 0;
 		while (w <= e) {
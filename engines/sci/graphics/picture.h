@@ -26,6 +26,10 @@
 #ifndef SCI_GRAPHICS_PICTURE_H
 #define SCI_GRAPHICS_PICTURE_H
 
+#include "common/stack.h"
+
+#include "sci/graphics/helpers.h"
+
 namespace Sci {
 
 #define SCI_PATTERN_CODE_RECTANGLE 0x10
@@ -42,6 +46,26 @@ class GfxPorts;
 class GfxScreen;
 class GfxPalette;
 
+enum PicturePriorityBands {
+	kPicturePriorityBandsNone,
+	kPicturePriorityBandsEqualDistance,
+	kPicturePriorityBandsExplicit
+};
+
+/**
+ * What drawing a vector picture changed besides the screen. GfxPaint16 keeps
+ * this together with the drawn screen, to draw the picture again from its
+ * cache.
+ */
+struct PictureSideEffects {
+	bool replayable; ///< false, if the picture did something which isn't recorded here
+	bool paletteSet;
+	Palette palette; ///< The palette which was set, if paletteSet
+	PicturePriorityBands priorityBands;
+	int16 priorityTop, priorityBottom; ///< The equal distance priority bands
+	byte priorityBandsData[14]; ///< The explicit priority bands
+};
+
 /**
  * Picture class, handles loading and displaying of picture resources
  *  every picture resource has its own instance of this class
@@ -54,20 +78,23 @@ public:
 	GuiResourceId getResourceId();
 	void draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo);
 
+	/** Returns what the last draw() changed besides the screen */
+	const PictureSideEffects &getSideEffects() const { return _sideEffects; }
+
 #ifdef ENABLE_SCI32
 	int16 getSci32celCount();
 	int16 getSci32celY(int16 celNo);
 	int16 getSci32celX(int16 celNo);
 	int16 getSci32celWidth(int16 celNo);
 	int16 getSci32celPriority(int16 celNo);
-	void drawSci32Vga(int16 celNo, int16 callerX, int16 callerY, int16 pictureX, bool mirrored);
+	void drawSci32Vga(int16 celNo, int16 callerX, int16 callerY, int16 pictureX, bool mirrored, const Common::Rect &clipRect);
 #endif
 
 private:
 	void initData(GuiResourceId resourceId);
 	void reset();
 	void drawSci11Vga();
-	void drawCelData(byte *inbuffer, int size, int headerPos, int rlePos, int literalPos, int16 drawX, int16 drawY, int16 pictureX);
+	void drawCelData(byte *inbuffer, int size, int headerPos, int rlePos, int literalPos, int16 drawX, int16 drawY, int16 pictureX, const Common::Rect *clipRect = NULL);
 	void drawVectorData(byte *data, int size);
 	bool vectorIsNonOpcode(byte pixel);
 	void vectorGetAbsCoords(byte *data, int &curPos, int16 &x, int16 &y);
@@ -100,6 +127,11 @@ private:
 
 	// If true, we will show the whole EGA drawing process...
 	bool _EGAdrawingVisualize;
+
+	PictureSideEffects _sideEffects;
+
+	// Kept between fills, so that it only gets allocated once per picture
+	Common::Stack<Common::Point> _floodFillStack;
 };
 
 } // End of namespace Sci
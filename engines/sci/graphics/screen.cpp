@@ -356,6 +356,34 @@ byte GfxScreen::getControl(int x, int y) {
 	return _controlScreen[y * _width + x];
 }
 
+/**
+ * Sets the pixels from left to right (inclusive) in line y, like putPixel()
+ * does it for a single pixel.
+ */
+void GfxScreen::putPixelSpan(int left, int right, int y, byte drawMask, byte color, byte priority, byte control) {
+	int offset = y * _width + left;
+	int count = right - left + 1;
+
+	if (drawMask & GFX_SCREEN_MASK_VISUAL) {
+		memset(_visualScreen + offset, color, count);
+		if (!_upscaledHires) {
+			memset(_displayScreen + offset, color, count);
+		} else {
+			int displayOffset = _upscaledMapping[y] * _displayWidth + left * 2;
+			int heightOffsetBreak = (_upscaledMapping[y + 1] - _upscaledMapping[y]) * _displayWidth;
+			int heightOffset = 0;
+			do {
+				memset(_displayScreen + displayOffset + heightOffset, color, count * 2);
+				heightOffset += _displayWidth;
+			} while (heightOffset != heightOffsetBreak);
+		}
+	}
+	if (drawMask & GFX_SCREEN_MASK_PRIORITY)
+		memset(_priorityScreen + offset, priority, count);
+	if (drawMask & GFX_SCREEN_MASK_CONTROL)
+		memset(_controlScreen + offset, control, count);
+}
+
 byte GfxScreen::isFillMatch(int16 x, int16 y, byte screenMask, byte t_color, byte t_pri, byte t_con, bool isEGA) {
 	int offset = y * _width + x;
 	byte match = 0;
@@ -29,12 +29,13 @@
 #include "sci/graphics/screen.h"
 #include "sci/graphics/palette.h"
 #include "sci/graphics/coordadjuster.h"
+#include "sci/graphics/cache.h"
 #include "sci/graphics/view.h"
 
 namespace Sci {
 
-GfxView::GfxView(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId)
-	: _resMan(resMan), _screen(screen), _palette(palette), _resourceId(resourceId) {
+GfxView::GfxView(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, GfxCache *cache)
+	: _resMan(resMan), _cache(cache), _screen(screen), _palette(palette), _resourceId(resourceId) {
 	assert(resourceId != -1);
 	_coordAdjuster = g_sci->_gfxCoordAdjuster;
 	initData(resourceId);
@@ -45,7 +46,8 @@ GfxView::~GfxView() {
 	for (uint16 loopNum = 0; loopNum < _loopCount; loopNum++) {
 		// and through the cells of each loop
 		for (uint16 celNum = 0; celNum < _loop[loopNum].celCount; celNum++) {
-			delete[] _loop[loopNum].cel[celNum].rawBitmap;
+			while (_loop[loopNum].cel[celNum].bitmaps)
+				freeBitmap(_loop[loopNum].cel[celNum].bitmaps);
 		}
 		delete[] _loop[loopNum].cel;
 	}
@@ -189,7 +191,7 @@ void GfxView::initData(GuiResourceId resourceId) {
 						cel->offsetLiteral = celOffset + 8;
 					}
 				}
-				cel->rawBitmap = 0;
+				cel->bitmaps = 0;
 				if (_loop[loopNo].mirrorFlag)
 					cel->displaceX = -cel->displaceX;
 			}
@@ -281,7 +283,7 @@ void GfxView::initData(GuiResourceId resourceId) {
 				if ((cel->offsetRLE) && (!cel->offsetLiteral))
 					SWAP(cel->offsetRLE, cel->offsetLiteral);
 
-				cel->rawBitmap = 0;
+				cel->bitmaps = 0;
 				if (_loop[loopNo].mirrorFlag)
 					cel->displaceX = -cel->displaceX;
 
@@ -566,18 +568,59 @@ void GfxView::unpackCel(int16 loopNo, int16 celNo, byte *outPtr, uint32 pixelCou
 	}
 }
 
+CelBitmap *GfxView::findBitmap(int16 loopNo, int16 celNo, int16 scaleX, int16 scaleY) {
+	for (CelBitmap *bitmap = _loop[loopNo].cel[celNo].bitmaps; bitmap; bitmap = bitmap->next) {
+		if (bitmap->scaleX == scaleX && bitmap->scaleY == scaleY) {
+			if (_cache)
+				_cache->touchCelBitmap(bitmap);
+			return bitmap;
+		}
+	}
+	return NULL;
+}
+
+CelBitmap *GfxView::addBitmap(int16 loopNo, int16 celNo, int16 scaleX, int16 scaleY, int16 width, int16 height) {
+	CelBitmap *bitmap = new CelBitmap();
+	bitmap->scaleX = scaleX;
+	bitmap->scaleY = scaleY;
+	bitmap->width = width;
+	bitmap->height = height;
+	bitmap->bitmap = new byte[width * height];
+	bitmap->next = _loop[loopNo].cel[celNo].bitmaps;
+	bitmap->view = this;
+	bitmap->loopNo = loopNo;
+	bitmap->celNo = celNo;
+	bitmap->lruPrev = bitmap->lruNext = NULL;
+	_loop[loopNo].cel[celNo].bitmaps = bitmap;
+	return bitmap;
+}
+
+void GfxView::freeBitmap(CelBitmap *bitmap) {
+	CelBitmap **link = &_loop[bitmap->loopNo].cel[bitmap->celNo].bitmaps;
+	while (*link != bitmap)
+		link = &(*link)->next;
+	*link = bitmap->next;
+
+	if (_cache)
+		_cache->removeCelBitmap(bitmap);
+
+	delete[] bitmap->bitmap;
+	delete bitmap;
+}
+
 const byte *GfxView::getBitmap(int16 loopNo, int16 celNo) {
 	loopNo = CLIP<int16>(loopNo, 0, _loopCount -1);
 	celNo = CLIP<int16>(celNo, 0, _loop[loopNo].celCount - 1);
-	if (_loop[loopNo].cel[celNo].rawBitmap)
-		return _loop[loopNo].cel[celNo].rawBitmap;
+	CelBitmap *cached = findBitmap(loopNo, celNo, 0, 0);
+	if (cached)
+		return cached->bitmap;
 
 	uint16 width = _loop[loopNo].cel[celNo].width;
 	uint16 height = _loop[loopNo].cel[celNo].height;
 	// allocating memory to store cel's bitmap
 	int pixelCount = width * height;
-	_loop[loopNo].cel[celNo].rawBitmap = new byte[pixelCount];
-	byte *pBitmap = _loop[loopNo].cel[celNo].rawBitmap;
+	CelBitmap *celBitmap = addBitmap(loopNo, celNo, 0, 0, width, height);
+	byte *pBitmap = celBitmap->bitmap;
 
 	// unpack the actual cel bitmap data
 	unpackCel(loopNo, celNo, pBitmap, pixelCount);
@@ -591,7 +634,76 @@ const byte *GfxView::getBitmap(int16 loopNo, int16 celNo) {
 			for (int j = 0; j < width / 2; j++)
 				SWAP(pBitmap[j], pBitmap[width - j - 1]);
 	}
-	return _loop[loopNo].cel[celNo].rawBitmap;
+
+	// Hand it over to the cache last, it may free other bitmaps
+	if (_cache)
+		_cache->addCelBitmap(celBitmap);
+
+	return celBitmap->bitmap;
+}
+
+/**
+ * Builds the scaling table for one direction of drawScaled()
+ * @param table			receives the source pixel of each scaled pixel
+ * @param tableSize		the size of table
+ * @param celSize		the size of the cel in this direction
+ * @param scale			the scaling, 128 is 100%
+ * @param scaledSize	the size of the scaled cel, clipped to the screen
+ * @return the number of table entries which were filled in
+ */
+static int16 createScalingTable(uint16 *table, int tableSize, int16 celSize, int16 scale, int16 scaledSize) {
+	int pixelNo = 0;
+	int scaledPixel = 0, scaledPixelNo = 0, prevScaledPixelNo = 0;
+	while (pixelNo < celSize) {
+		scaledPixelNo = scaledPixel >> 7;
+		assert(scaledPixelNo < tableSize);
+		for (; prevScaledPixelNo <= scaledPixelNo; prevScaledPixelNo++)
+			table[prevScaledPixelNo] = pixelNo;
+		pixelNo++;
+		scaledPixel += scale;
+	}
+	pixelNo--;
+	scaledPixelNo++;
+	for (; scaledPixelNo < scaledSize; scaledPixelNo++)
+		table[scaledPixelNo] = pixelNo;
+	return MAX(prevScaledPixelNo, scaledPixelNo);
+}
+
+const CelBitmap *GfxView::getScaledBitmap(int16 loopNo, int16 celNo, int16 scaleX, int16 scaleY) {
+	loopNo = CLIP<int16>(loopNo, 0, _loopCount -1);
+	celNo = CLIP<int16>(celNo, 0, _loop[loopNo].celCount - 1);
+	CelBitmap *cached = findBitmap(loopNo, celNo, scaleX, scaleY);
+	if (cached)
+		return cached;
+
+	const CelInfo *celInfo = getCelInfo(loopNo, celNo);
+	const byte *bitmap = getBitmap(loopNo, celNo);
+	const int16 celHeight = celInfo->height;
+	const int16 celWidth = celInfo->width;
+	uint16 scalingX[640];
+	uint16 scalingY[480];
+	int16 scaledWidth, scaledHeight;
+
+	scaledWidth = (celInfo->width * scaleX) >> 7;
+	scaledHeight = (celInfo->height * scaleY) >> 7;
+	scaledWidth = CLIP<int16>(scaledWidth, 0, _screen->getWidth());
+	scaledHeight = CLIP<int16>(scaledHeight, 0, _screen->getHeight());
+
+	const int16 tableHeight = createScalingTable(scalingY, ARRAYSIZE(scalingY), celHeight, scaleY, scaledHeight);
+	const int16 tableWidth = createScalingTable(scalingX, ARRAYSIZE(scalingX), celWidth, scaleX, scaledWidth);
+
+	CelBitmap *scaledBitmap = addBitmap(loopNo, celNo, scaleX, scaleY, tableWidth, tableHeight);
+	byte *scaledPtr = scaledBitmap->bitmap;
+	for (int y = 0; y < tableHeight; y++) {
+		const byte *bitmapRow = bitmap + scalingY[y] * celWidth;
+		for (int x = 0; x < tableWidth; x++)
+			*scaledPtr++ = bitmapRow[scalingX[x]];
+	}
+
+	if (_cache)
+		_cache->addCelBitmap(scaledBitmap);
+
+	return scaledBitmap;
 }
 
 /**
@@ -752,15 +864,10 @@ void GfxView::drawScaled(const Common::Rect &rect, const Common::Rect &clipRect,
 			int16 loopNo, int16 celNo, byte priority, int16 scaleX, int16 scaleY) {
 	const Palette *palette = _embeddedPal ? &_viewPalette : &_palette->_sysPalette;
 	const CelInfo *celInfo = getCelInfo(loopNo, celNo);
-	const byte *bitmap = getBitmap(loopNo, celNo);
-	const int16 celHeight = celInfo->height;
-	const int16 celWidth = celInfo->width;
+	const CelBitmap *scaledBitmap = getScaledBitmap(loopNo, celNo, scaleX, scaleY);
 	const byte clearKey = celInfo->clearKey;
 	const byte drawMask = (priority == 255) ? GFX_SCREEN_MASK_VISUAL : GFX_SCREEN_MASK_VISUAL|GFX_SCREEN_MASK_PRIORITY;
-	uint16 scalingX[640];
-	uint16 scalingY[480];
 	int16 scaledWidth, scaledHeight;
-	int pixelNo, scaledPixel, scaledPixelNo, prevScaledPixelNo;
 
 	if (_embeddedPal)
 		// Merge view palette in...
@@ -771,42 +878,6 @@ void GfxView::drawScaled(const Common::Rect &rect, const Common::Rect &clipRect,
 	scaledWidth = CLIP<int16>(scaledWidth, 0, _screen->getWidth());
 	scaledHeight = CLIP<int16>(scaledHeight, 0, _screen->getHeight());
 
-	// Do we really need to do this?!
-	//memset(scalingX, 0, sizeof(scalingX));
-	//memset(scalingY, 0, sizeof(scalingY));
-
-	// Create height scaling table
-	pixelNo = 0;
-	scaledPixel = scaledPixelNo = prevScaledPixelNo = 0;
-	while (pixelNo < celHeight) {
-		scaledPixelNo = scaledPixel >> 7;
-		assert(scaledPixelNo < ARRAYSIZE(scalingY));
-		for (; prevScaledPixelNo <= scaledPixelNo; prevScaledPixelNo++)
-			scalingY[prevScaledPixelNo] = pixelNo;
-		pixelNo++;
-		scaledPixel += scaleY;
-	}
-	pixelNo--;
-	scaledPixelNo++;
-	for (; scaledPixelNo < scaledHeight; scaledPixelNo++)
-		scalingY[scaledPixelNo] = pixelNo;
-
-	// Create width scaling table
-	pixelNo = 0;
-	scaledPixel = scaledPixelNo = prevScaledPixelNo = 0;
-	while (pixelNo < celWidth) {
-		scaledPixelNo = scaledPixel >> 7;
-		assert(scaledPixelNo < ARRAYSIZE(scalingX));
-		for (; prevScaledPixelNo <= scaledPixelNo; prevScaledPixelNo++)
-			scalingX[prevScaledPixelNo] = pixelNo;
-		pixelNo++;
-		scaledPixel += scaleX;
-	}
-	pixelNo--;
-	scaledPixelNo++;
-	for (; scaledPixelNo < scaledWidth; scaledPixelNo++)
-		scalingX[scaledPixelNo] = pixelNo;
-
 	scaledWidth = MIN(clipRect.width(), scaledWidth);
 	scaledHeight = MIN(clipRect.height(), scaledHeight);
 
@@ -817,11 +888,14 @@ void GfxView::drawScaled(const Common::Rect &rect, const Common::Rect &clipRect,
 	if (offsetX < 0 || offsetY < 0)
 		return;
 
-	assert(scaledHeight + offsetY <= ARRAYSIZE(scalingY));
-	assert(scaledWidth + offsetX <= ARRAYSIZE(scalingX));
-	for (int y = 0; y < scaledHeight; y++) {
+	// The scaled bitmap covers everything the scaling tables did
+	scaledWidth = MIN<int16>(scaledWidth, scaledBitmap->width - offsetX);
+	scaledHeight = MIN<int16>(scaledHeight, scaledBitmap->height - offsetY);
+
+	const byte *bitmap = scaledBitmap->bitmap + offsetY * scaledBitmap->width + offsetX;
+	for (int y = 0; y < scaledHeight; y++, bitmap += scaledBitmap->width) {
 		for (int x = 0; x < scaledWidth; x++) {
-			const byte color = bitmap[scalingY[y + offsetY] * celWidth + scalingX[x + offsetX]];
+			const byte color = bitmap[x];
 			const int x2 = clipRectTranslated.left + x;
 			const int y2 = clipRectTranslated.top + y;
 			if (color != clearKey && priority >= _screen->getPriority(x2, y2)) {
@@ -35,6 +35,25 @@ enum Sci32ViewNativeResolution {
 	SCI_VIEW_NATIVERES_640x400 = 2
 };
 
+class GfxCache;
+class GfxView;
+
+/**
+ * The decoded bitmap of a cel, or a scaled version of it. If the view belongs
+ * to a GfxCache, the bitmap is subject to its LRU.
+ */
+struct CelBitmap {
+	int16 scaleX, scaleY; ///< The scaling, 0 for the unscaled bitmap
+	int16 width, height;
+	byte *bitmap;
+	CelBitmap *next; ///< The next bitmap of the same cel
+
+	GfxView *view;
+	int16 loopNo, celNo;
+	CelBitmap *lruPrev; ///< The next more recently used bitmap in the GfxCache
+	CelBitmap *lruNext; ///< The next less recently used bitmap in the GfxCache
+};
+
 struct CelInfo {
 	int16 width, height;
 	int16 scriptWidth, scriptHeight;
@@ -44,7 +63,7 @@ struct CelInfo {
 	uint16 offsetEGA;
 	uint32 offsetRLE;
 	uint32 offsetLiteral;
-	byte *rawBitmap;
+	CelBitmap *bitmaps; ///< The decoded bitmaps of this cel
 };
 
 struct LoopInfo {
@@ -65,7 +84,7 @@ class GfxPalette;
  */
 class GfxView {
 public:
-	GfxView(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId);
+	GfxView(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, GfxCache *cache = 0);
 	~GfxView();
 
 	GuiResourceId getResourceId() const;
@@ -76,6 +95,14 @@ public:
 	void getCelSpecialHoyle4Rect(int16 loopNo, int16 celNo, int16 x, int16 y, int16 z, Common::Rect &outRect) const;
 	void getCelScaledRect(int16 loopNo, int16 celNo, int16 x, int16 y, int16 z, int16 scaleX, int16 scaleY, Common::Rect &outRect) const;
 	const byte *getBitmap(int16 loopNo, int16 celNo);
+	/**
+	 * Returns the cel scaled like drawScaled() does it. The scaled bitmaps
+	 * are kept, so that actors which are drawn with the same scaling in
+	 * every frame don't need to be scaled again.
+	 */
+	const CelBitmap *getScaledBitmap(int16 loopNo, int16 celNo, int16 scaleX, int16 scaleY);
+	/** Frees a bitmap returned by getBitmap() or getScaledBitmap() */
+	void freeBitmap(CelBitmap *bitmap);
 	void draw(const Common::Rect &rect, const Common::Rect &clipRect, const Common::Rect &clipRectTranslated, int16 loopNo, int16 celNo, byte priority, uint16 EGAmappingNr, bool upscaledHires);
 	void drawScaled(const Common::Rect &rect, const Common::Rect &clipRect, const Common::Rect &clipRectTranslated, int16 loopNo, int16 celNo, byte priority, int16 scaleX, int16 scaleY);
 	uint16 getLoopCount() const { return _loopCount; }
@@ -92,8 +119,11 @@ private:
 	void initData(GuiResourceId resourceId);
 	void unpackCel(int16 loopNo, int16 celNo, byte *outPtr, uint32 pixelCount);
 	void unditherBitmap(byte *bitmap, int16 width, int16 height, byte clearKey);
+	CelBitmap *findBitmap(int16 loopNo, int16 celNo, int16 scaleX, int16 scaleY);
+	CelBitmap *addBitmap(int16 loopNo, int16 celNo, int16 scaleX, int16 scaleY, int16 width, int16 height);
 
 	ResourceManager *_resMan;
+	GfxCache *_cache;
 	GfxCoordAdjuster *_coordAdjuster;
 	GfxScreen *_screen;
 	GfxPalette *_palette;
@@ -192,6 +192,8 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : _resMan(resMan), _i
 	_source = NULL;
 	_header = NULL;
 	_headerSize = 0;
+	_lruPrev = NULL;
+	_lruNext = NULL;
 }
 
 Resource::~Resource() {
@@ -892,7 +894,11 @@ ResourceManager::ResourceManager() {
 void ResourceManager::init(bool initFromFallbackDetector) {
 	_memoryLocked = 0;
 	_memoryLRU = 0;
-	_LRU.clear();
+	_maxMemoryLRU = MAX_MEMORY;
+	_lruFirst = NULL;
+	_lruLast = NULL;
+	_prefetchRooms = false;
+	resetCacheStats();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 
@@ -995,7 +1001,17 @@ void ResourceManager::removeFromLRU(Resource *res) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+
+	if (res->_lruPrev)
+		res->_lruPrev->_lruNext = res->_lruNext;
+	else
+		_lruFirst = res->_lruNext;
+	if (res->_lruNext)
+		res->_lruNext->_lruPrev = res->_lruPrev;
+	else
+		_lruLast = res->_lruPrev;
+	res->_lruPrev = res->_lruNext = NULL;
+
 	_memoryLRU -= res->size;
 	res->_status = kResStatusAllocated;
 }
@@ -1005,7 +1021,15 @@ void ResourceManager::addToLRU(Resource *res) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
+
+	res->_lruPrev = NULL;
+	res->_lruNext = _lruFirst;
+	if (_lruFirst)
+		_lruFirst->_lruPrev = res;
+	else
+		_lruLast = res;
+	_lruFirst = res;
+
 	_memoryLRU += res->size;
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s.%03d (%d bytes) to lru control: %d bytes total",
@@ -1018,32 +1042,60 @@ void ResourceManager::addToLRU(Resource *res) {
 void ResourceManager::printLRU() {
 	int mem = 0;
 	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
 
-	while (it != _LRU.end()) {
-		res = *it;
+	for (Resource *res = _lruFirst; res; res = res->_lruNext) {
 		debug("\t%s: %d bytes", res->_id.toString().c_str(), res->size);
 		mem += res->size;
 		++entries;
-		++it;
 	}
 
 	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
 }
 
 void ResourceManager::freeOldResources() {
-	while (MAX_MEMORY < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = *_LRU.reverse_begin();
+	while (_maxMemoryLRU < _memoryLRU) {
+		assert(_lruLast);
+		Resource *goner = _lruLast;
 		removeFromLRU(goner);
 		goner->unalloc();
+		_cacheStats.evictions++;
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s.%03d (%d bytes)", getResourceTypeName(goner->type), goner->number, goner->size);
 #endif
 	}
 }
 
+void ResourceManager::setMaxMemoryLRU(int bytes) {
+	_maxMemoryLRU = bytes;
+	freeOldResources();
+}
+
+void ResourceManager::resetCacheStats() {
+	memset(&_cacheStats, 0, sizeof(_cacheStats));
+}
+
+void ResourceManager::prefetchRoom(uint16 roomNumber) {
+	// Rooms are identified by their pic, scripts without one are regular
+	// game logic
+	if (!_prefetchRooms || !testResource(ResourceId(kResourceTypePic, roomNumber)))
+		return;
+
+	static const ResourceType prefetchTypes[] = {
+		kResourceTypePic, kResourceTypePalette, kResourceTypeHeap
+	};
+
+	for (int i = 0; i < ARRAYSIZE(prefetchTypes); i++) {
+		Resource *res = testResource(ResourceId(prefetchTypes[i], roomNumber));
+		if (!res || res->_status != kResStatusNoMalloc)
+			continue;
+
+		// This puts the resource at the front of the LRU list, pushing out
+		// the oldest resources (usually those of the previous room)
+		findResource(res->_id, false);
+		_cacheStats.prefetches++;
+	}
+}
+
 Common::List<ResourceId> *ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> *resources = new Common::List<ResourceId>;
 
@@ -1063,10 +1115,15 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_status == kResStatusNoMalloc) {
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		removeFromLRU(retval);
+		_cacheStats.misses++;
+		_cacheStats.bytesDecompressed += retval->size;
+	} else {
+		_cacheStats.hits++;
+		if (retval->_status == kResStatusEnqueued)
+			removeFromLRU(retval);
+	}
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
 
@@ -245,6 +245,8 @@ protected:
 	uint16 _lockers; /**< Number of places where this resource was locked */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
+	Resource *_lruPrev; /**< The next more recently used resource in the LRU list */
+	Resource *_lruNext; /**< The next less recently used resource in the LRU list */
 
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
@@ -327,6 +329,41 @@ public:
 	 */
 	Common::List<ResourceId> *listResources(ResourceType type, int mapNumber = -1);
 
+	/**
+	 * Sets the amount of memory that unlocked resources may occupy before
+	 * the least recently used ones are freed.
+	 * @param bytes	The new limit, in bytes
+	 */
+	void setMaxMemoryLRU(int bytes);
+	int getMaxMemoryLRU() const { return _maxMemoryLRU; }
+	int getMemoryLRU() const { return _memoryLRU; }
+	int getMemoryLocked() const { return _memoryLocked; }
+
+	/** Enables or disables prefetching the resources of new rooms */
+	void setRoomPrefetching(bool enable) { _prefetchRooms = enable; }
+	bool getRoomPrefetching() const { return _prefetchRooms; }
+
+	/**
+	 * Loads the resources that share the number of the given room (its pic,
+	 * palette and heap) into the LRU cache, so that they don't need to be
+	 * read while the room is set up. Does nothing unless room prefetching
+	 * is enabled, or if the room has no pic.
+	 * @param roomNumber	The number of the room
+	 */
+	void prefetchRoom(uint16 roomNumber);
+
+	/** Statistics of the resource cache */
+	struct CacheStats {
+		uint32 hits;              ///< Resources which were already in memory
+		uint32 misses;            ///< Resources which had to be loaded
+		uint32 evictions;         ///< Resources which were freed by the LRU
+		uint32 prefetches;        ///< Resources loaded by prefetchRoom()
+		uint32 bytesDecompressed; ///< Bytes of resource data which were loaded
+	};
+
+	const CacheStats &getCacheStats() const { return _cacheStats; }
+	void resetCacheStats();
+
 	void setAudioLanguage(int language);
 	int getAudioLanguage() const;
 	void changeAudioDirectory(Common::String path);
@@ -394,7 +431,11 @@ protected:
 	Common::List<ResourceSource *> _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	int _maxMemoryLRU;	///< Amount of resource bytes allowed under LRU control, MAX_MEMORY by default
+	Resource *_lruFirst;	///< Most recently used resource under LRU control
+	Resource *_lruLast;	///< Least recently used resource under LRU control
+	bool _prefetchRooms;	///< Load the resources of new rooms ahead of time
+	CacheStats _cacheStats;
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -192,11 +192,19 @@ Common::Error SciEngine::run() {
 	ConfMan.registerDefault("sci_originalsaveload", "false");
 	ConfMan.registerDefault("native_fb01", "false");
 	ConfMan.registerDefault("windows_cursors", "false");	// Windows cursors for KQ6 Windows
+	ConfMan.registerDefault("sci_validate_kernel_calls_once", "false");
+	ConfMan.registerDefault("sci_resource_cache_size", 256);	// in KB
+	ConfMan.registerDefault("sci_prefetch_rooms", "false");
+	ConfMan.registerDefault("sci_gc_max_pause", 0);	// in ms, 0 means no limit. Only limits freeing, marking always runs in one go
+	ConfMan.registerDefault("sci_cel_cache_size", 2048);	// in KB
+	ConfMan.registerDefault("sci_picture_cache_size", MAX_CACHED_PICTURES);	// in pictures, 0 disables it
 
 	_resMan = new ResourceManager();
 	assert(_resMan);
 	_resMan->addAppropriateSources();
 	_resMan->init();
+	_resMan->setMaxMemoryLRU(ConfMan.getInt("sci_resource_cache_size") * 1024);
+	_resMan->setRoomPrefetching(ConfMan.getBool("sci_prefetch_rooms"));
 
 	// TODO: Add error handling. Check return values of addAppropriateSources
 	// and init. We first have to *add* sensible return values, though ;).
@@ -223,6 +231,7 @@ Common::Error SciEngine::run() {
 	// Create debugger console. It requires GFX to be initialized
 	_console = new Console(this);
 	_kernel = new Kernel(_resMan, segMan);
+	_kernel->_validateCallsOnce = ConfMan.getBool("sci_validate_kernel_calls_once");
 
 	_features = new GameFeatures(segMan, _kernel);
 	// Only SCI0, SCI01 and SCI1 EGA games used a parser
@@ -232,6 +241,7 @@ Common::Error SciEngine::run() {
 		_vocabulary = new Vocabulary(_resMan, false);
 	_audio = new AudioPlayer(_resMan);
 	_gamestate = new EngineState(segMan);
+	_gamestate->_gcState.maxPause = ConfMan.getInt("sci_gc_max_pause");
 	_eventMan = new EventManager(_resMan->detectFontExtended());
 
 	// The game needs to be initialized before the graphics system is initialized, as
@@ -623,6 +633,7 @@ void SciEngine::initGraphics() {
 
 	_gfxPalette = new GfxPalette(_resMan, _gfxScreen, paletteMerging);
 	_gfxCache = new GfxCache(_resMan, _gfxScreen, _gfxPalette);
+	_gfxCache->setMaxCelMemory(ConfMan.getInt("sci_cel_cache_size") * 1024);
 	_gfxCursor = new GfxCursor(_resMan, _gfxPalette, _gfxScreen);
 
 #ifdef ENABLE_SCI32
@@ -644,6 +655,7 @@ void SciEngine::initGraphics() {
 		_gfxCompare = new GfxCompare(_gamestate->_segMan, _kernel, _gfxCache, _gfxScreen, _gfxCoordAdjuster);
 		_gfxTransitions = new GfxTransitions(_gfxScreen, _gfxPalette);
 		_gfxPaint16 = new GfxPaint16(_resMan, _gamestate->_segMan, _kernel, _gfxCache, _gfxPorts, _gfxCoordAdjuster, _gfxScreen, _gfxPalette, _gfxTransitions, _audio);
+		_gfxPaint16->setMaxCachedPictures(ConfMan.getInt("sci_picture_cache_size"));
 		_gfxPaint = _gfxPaint16;
 		_gfxAnimate = new GfxAnimate(_gamestate, _gfxCache, _gfxPorts, _gfxPaint16, _gfxScreen, _gfxPalette, _gfxCursor, _gfxTransitions);
 		_gfxText16 = new GfxText16(_resMan, _gfxCache, _gfxPorts, _gfxPaint16, _gfxScreen);
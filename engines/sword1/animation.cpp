@@ -66,11 +66,12 @@ static const char *sequenceList[20] = {
 // Basic movie player
 ///////////////////////////////////////////////////////////////////////////////
 
-MoviePlayer::MoviePlayer(SwordEngine *vm, Text *textMan, Audio::Mixer *snd, OSystem *system, Audio::SoundHandle *bgSoundHandle, Video::VideoDecoder *decoder, DecoderType decoderType)
+MoviePlayer::MoviePlayer(SwordEngine *vm, Text *textMan, Audio::Mixer *snd, OSystem *system, Audio::SoundHandle *bgSoundHandle, Video::VideoDecoder *decoder, DecoderType decoderType, Video::DXADecoder *dxaDecoder)
 	: _vm(vm), _textMan(textMan), _snd(snd), _bgSoundHandle(bgSoundHandle), _system(system) {
 	_bgSoundStream = NULL;
 	_decoderType = decoderType;
 	_decoder = decoder;
+	_dxaDecoder = dxaDecoder;
 
 	_white = 255;
 	_black = 0;
@@ -253,8 +254,17 @@ bool MoviePlayer::playVideo() {
 	while (!_vm->shouldQuit() && !_decoder->endOfVideo()) {
 		if (_decoder->needsUpdate()) {
 			const Graphics::Surface *frame = _decoder->decodeNextFrame();
-			if (frame)
-				_vm->_system->copyRectToScreen((byte *)frame->pixels, frame->pitch, x, y, frame->w, frame->h);
+			if (frame) {
+				// Only copy what changed, unless there are subtitles drawn
+				// over the frame
+				if (_dxaDecoder && !_textMan->giveSpriteData(2)) {
+					const Common::List<Common::Rect> &dirtyRects = _dxaDecoder->getDirtyRects();
+					for (Common::List<Common::Rect>::const_iterator rect = dirtyRects.begin(); rect != dirtyRects.end(); ++rect)
+						_vm->_system->copyRectToScreen((const byte *)frame->getBasePtr(rect->left, rect->top), frame->pitch,
+						                               x + rect->left, y + rect->top, rect->width(), rect->height());
+				} else
+					_vm->_system->copyRectToScreen((byte *)frame->pixels, frame->pitch, x, y, frame->w, frame->h);
+			}
 
 			if (_decoder->hasDirtyPalette()) {
 				_decoder->setSystemPalette();
@@ -342,7 +352,7 @@ MoviePlayer *makeMoviePlayer(uint32 id, SwordEngine *vm, Text *textMan, Audio::M
 	if (Common::File::exists(filename)) {
 #ifdef USE_ZLIB
 		DXADecoderWithSound *dxaDecoder = new DXADecoderWithSound(snd, bgSoundHandle);
-		return new MoviePlayer(vm, textMan, snd, system, bgSoundHandle, dxaDecoder, kVideoDecoderDXA);
+		return new MoviePlayer(vm, textMan, snd, system, bgSoundHandle, dxaDecoder, kVideoDecoderDXA, dxaDecoder);
 #else
 		GUI::MessageDialog dialog("DXA cutscenes found but ScummVM has been built without zlib support", "OK");
 		dialog.runModal();
@@ -73,7 +73,7 @@ private:
 
 class MoviePlayer {
 public:
-	MoviePlayer(SwordEngine *vm, Text *textMan, Audio::Mixer *snd, OSystem *system, Audio::SoundHandle *bgSoundHandle, Video::VideoDecoder *decoder, DecoderType decoderType);
+	MoviePlayer(SwordEngine *vm, Text *textMan, Audio::Mixer *snd, OSystem *system, Audio::SoundHandle *bgSoundHandle, Video::VideoDecoder *decoder, DecoderType decoderType, Video::DXADecoder *dxaDecoder = 0);
 	virtual ~MoviePlayer();
 	bool load(uint32 id);
 	void play();
@@ -89,6 +89,7 @@ protected:
 	DecoderType _decoderType;
 
 	Video::VideoDecoder *_decoder;
+	Video::DXADecoder *_dxaDecoder; ///< The decoder again for DXA videos, which report their changes
 	Audio::SoundHandle *_bgSoundHandle;
 	Audio::AudioStream *_bgSoundStream;
 
@@ -71,7 +71,7 @@ private:
 
 class MoviePlayer {
 public:
-	MoviePlayer(Sword2Engine *vm, Audio::Mixer *snd, OSystem *system, Audio::SoundHandle *bgSoundHandle, Video::VideoDecoder *decoder, DecoderType decoderType);
+	MoviePlayer(Sword2Engine *vm, Audio::Mixer *snd, OSystem *system, Audio::SoundHandle *bgSoundHandle, Video::VideoDecoder *decoder, DecoderType decoderType, Video::DXADecoder *dxaDecoder = 0);
 	virtual ~MoviePlayer();
 
 	bool load(const char *name);
@@ -90,6 +90,7 @@ protected:
 	DecoderType _decoderType;
 
 	Video::VideoDecoder *_decoder;
+	Video::DXADecoder *_dxaDecoder; ///< The decoder again for DXA videos, which report their changes
 	Audio::SoundHandle *_bgSoundHandle;
 	Audio::AudioStream *_bgSoundStream;
 
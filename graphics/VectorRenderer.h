@@ -264,6 +264,11 @@ public:
 		_activeSurface = surface;
 	}
 
+	/**
+	 * Returns the surface all drawing is currently done on.
+	 */
+	Surface *getActiveSurface() const { return _activeSurface; }
+
 	/**
 	 * Fills the active surface with the specified fg/bg color or the active gradient.
 	 * Defaults to using the active Foreground color for filling.
@@ -472,6 +477,7 @@ public:
 	 */
 	virtual void disableShadows() { _disableShadows = true; }
 	virtual void enableShadows() { _disableShadows = false; }
+	bool shadowsDisabled() const { return _disableShadows; }
 
 	/**
 	 * Applies a whole-screen shading effect, used before opening a new dialog.
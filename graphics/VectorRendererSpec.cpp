@@ -236,6 +236,9 @@ setGradientColors(uint8 r1, uint8 g1, uint8 b1, uint8 r2, uint8 g2, uint8 b2) {
 	Base::_gradientBytes[0] = (_gradientEnd & _redMask) - (_gradientStart & _redMask);
 	Base::_gradientBytes[1] = (_gradientEnd & _greenMask) - (_gradientStart & _greenMask);
 	Base::_gradientBytes[2] = (_gradientEnd & _blueMask) - (_gradientStart & _blueMask);
+
+	// Colors changed, any precalculated gradient line is stale now
+	_gradientLine.clear();
 }
 
 template<typename PixelType>
@@ -245,7 +248,8 @@ VectorRendererSpec(PixelFormat format) :
 	_redMask((0xFF >> format.rLoss) << format.rShift),
 	_greenMask((0xFF >> format.gLoss) << format.gShift),
 	_blueMask((0xFF >> format.bLoss) << format.bShift),
-	_alphaMask((0xFF >> format.aLoss) << format.aShift) {
+	_alphaMask((0xFF >> format.aLoss) << format.aShift),
+	_gradientLineFactor(0) {
 
 	_bitmapAlphaColor = _format.RGBToColor(255, 0, 255);
 }
@@ -263,9 +267,11 @@ fillSurface() {
 	} else if (Base::_fillMode == kFillForeground) {
 		colorFill<PixelType>((PixelType *)ptr, (PixelType *)(ptr + pitch * h), _fgColor);
 	} else if (Base::_fillMode == kFillGradient) {
+		precalcGradient(h);
+
 		int i = h;
 		while (i--) {
-			colorFill<PixelType>((PixelType *)ptr, (PixelType *)(ptr + pitch), calcGradient(h - i, h));
+			colorFill<PixelType>((PixelType *)ptr, (PixelType *)(ptr + pitch), gradientColor(h - i));
 			ptr += pitch;
 		}
 	}
@@ -431,6 +437,62 @@ calcGradient(uint32 pos, uint32 max) {
 	return output;
 }
 
+template<typename PixelType>
+void VectorRendererSpec<PixelType>::
+precalcGradient(uint32 max) {
+	if (_gradientLine.size() == max + 1 && _gradientLineFactor == Base::_gradientFactor)
+		return;
+
+	_gradientLine.resize(max + 1);
+	_gradientLineFactor = Base::_gradientFactor;
+
+	// calcGradient() divides by max. A zero height gradient draws nothing,
+	// so just keep the start color as the only entry.
+	if (!max) {
+		_gradientLine[0] = calcGradient(0, 1);
+		return;
+	}
+
+	for (uint32 i = 0; i <= max; ++i)
+		_gradientLine[i] = calcGradient(i, max);
+}
+
+template<typename PixelType>
+void VectorRendererSpec<PixelType>::
+blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha) {
+	// Blending with no intensity leaves the destination untouched
+	if (first >= last || !alpha)
+		return;
+
+	// Same arithmetic as blendPixelPtr(), with everything that only
+	// depends on the source color hoisted out of the loop:
+	//   dst + (((src - dst) * alpha) >> 8) == dst + ((src * alpha - dst * alpha) >> 8)
+	const int rMask = _redMask, gMask = _greenMask, bMask = _blueMask, aMask = _alphaMask;
+	const int srcR = (color & rMask) * alpha;
+	const int srcG = (color & gMask) * alpha;
+	const int srcB = (color & bMask) * alpha;
+	const int srcA = (alpha >> _format.aLoss) << _format.aShift;
+
+	// Theme surfaces mostly consist of flat areas, so remember the last
+	// blended pixel and reuse the result for runs of identical pixels.
+	// Start with a value that differs from the first pixel, so it is blended
+	int lastDst = ~(int)*first;
+	PixelType lastResult = 0;
+
+	for (; first < last; ++first) {
+		if (*first != lastDst) {
+			lastDst = *first;
+			lastResult = (PixelType)(
+				(rMask & ((lastDst & rMask) + ((srcR - (lastDst & rMask) * alpha) >> 8))) |
+				(gMask & ((lastDst & gMask) + ((srcG - (lastDst & gMask) * alpha) >> 8))) |
+				(bMask & ((lastDst & bMask) + ((srcB - (lastDst & bMask) * alpha) >> 8))) |
+				(aMask & ((lastDst & aMask) + srcA - (((lastDst & aMask) * alpha) >> 8))));
+		}
+
+		*first = lastResult;
+	}
+}
+
 /********************************************************************
  ********************************************************************
  * Primitive shapes drawing - Public API calls - VectorRendererSpec *
@@ -799,12 +861,15 @@ drawTabAlg(int x1, int y1, int w, int h, int r, PixelType color, VectorRenderer:
 		PixelType color1, color2;
 		color1 = color2 = color;
 
+		if (fill_m == kFillGradient)
+			precalcGradient(long_h);
+
 		while (x++ < y) {
 			__BE_ALGORITHM();
 
 			if (fill_m == kFillGradient) {
-				color1 = calcGradient(real_radius - x, long_h);
-				color2 = calcGradient(real_radius - y, long_h);
+				color1 = gradientColor(real_radius - x);
+				color2 = gradientColor(real_radius - y);
 			}
 
 			colorFill<PixelType>(ptr_tl - x - py, ptr_tr + x - py, color2);
@@ -819,7 +884,7 @@ drawTabAlg(int x1, int y1, int w, int h, int r, PixelType color, VectorRenderer:
 		ptr_fill += pitch * r;
 		while (short_h--) {
 			if (fill_m == kFillGradient)
-				color = calcGradient(real_radius++, long_h);
+				color = gradientColor(real_radius++);
 			colorFill<PixelType>(ptr_fill, ptr_fill + w + 1, color);
 			ptr_fill += pitch;
 		}
@@ -880,9 +945,12 @@ drawSquareAlg(int x, int y, int w, int h, PixelType color, VectorRenderer::FillM
 	int max_h = h;
 
 	if (fill_m != kFillDisabled) {
+		if (fill_m == kFillGradient)
+			precalcGradient(max_h);
+
 		while (h--) {
 			if (fill_m == kFillGradient)
-				color = calcGradient(max_h - h, max_h);
+				color = gradientColor(max_h - h);
 
 			colorFill<PixelType>(ptr, ptr + w, color);
 			ptr += pitch;
@@ -1187,13 +1255,15 @@ drawRoundedSquareAlg(int x1, int y1, int r, int w, int h, PixelType color, Vecto
 		PixelType color1, color2, color3, color4;
 
 		if (fill_m == kFillGradient) {
+			precalcGradient(long_h);
+
 			while (x++ < y) {
 				__BE_ALGORITHM();
 
-				color1 = calcGradient(real_radius - x, long_h);
-				color2 = calcGradient(real_radius - y, long_h);
-				color3 = calcGradient(long_h - r + x, long_h);
-				color4 = calcGradient(long_h - r + y, long_h);
+				color1 = gradientColor(real_radius - x);
+				color2 = gradientColor(real_radius - y);
+				color3 = gradientColor(long_h - r + x);
+				color4 = gradientColor(long_h - r + y);
 
 				colorFill<PixelType>(ptr_tl - x - py, ptr_tr + x - py, color2);
 				colorFill<PixelType>(ptr_tl - y - px, ptr_tr + y - px, color1);
@@ -1221,7 +1291,7 @@ drawRoundedSquareAlg(int x1, int y1, int r, int w, int h, PixelType color, Vecto
 		ptr_fill += pitch * r;
 		while (short_h--) {
 			if (fill_m == kFillGradient)
-				color = calcGradient(real_radius++, long_h);
+				color = gradientColor(real_radius++);
 			colorFill<PixelType>(ptr_fill, ptr_fill + w + 1, color);
 			ptr_fill += pitch;
 		}
@@ -1287,21 +1357,26 @@ drawSquareShadow(int x, int y, int w, int h, int blur) {
 	int pitch = _activeSurface->pitch / _activeSurface->bytesPerPixel;
 	int i, j;
 
-	i = h - blur;
+	// The right edge fades out horizontally, so every column of it has
+	// a constant intensity and is blended top to bottom.
+	j = blur;
+	while (j--) {
+		const uint8 alpha = ((blur - j) << 8) / blur;
+		PixelType *col = ptr + j;
 
-	while (i--) {
-		j = blur;
-		while (j--)
-			blendPixelPtr(ptr + j, 0, ((blur - j) << 8) / blur);
-		ptr += pitch;
+		i = h - blur;
+		while (i--) {
+			blendPixelPtr(col, 0, alpha);
+			col += pitch;
+		}
 	}
 
 	ptr = (PixelType *)_activeSurface->getBasePtr(x + blur, y + h - 1);
 
+	// The bottom edge fades out vertically, each row is a single span
+	i = -1;
 	while (i++ < blur) {
-		j = w - blur;
-		while (j--)
-			blendPixelPtr(ptr + j, 0, ((blur - i) << 8) / blur);
+		blendFill(ptr, ptr + w - blur, 0, ((blur - i) << 8) / blur);
 		ptr += pitch;
 	}
 
@@ -26,6 +26,8 @@
 #ifndef VECTOR_RENDERER_SPEC_H
 #define VECTOR_RENDERER_SPEC_H
 
+#include "common/array.h"
+
 #include "graphics/VectorRenderer.h"
 
 namespace Graphics {
@@ -188,9 +190,35 @@ protected:
 	 */
 	inline PixelType calcGradient(uint32 pos, uint32 max);
 
+	/**
+	 * Precalculates all the colors of a gradient with the given height.
+	 * The resulting line is kept until the gradient colors or factor change,
+	 * so consecutive widgets of the same height share it.
+	 *
+	 * @see gradientColor
+	 * @param max Maximum amount of the progress (i.e. height of the gradient).
+	 */
+	void precalcGradient(uint32 max);
+
+	/**
+	 * Looks up a color of the gradient line prepared by precalcGradient().
+	 * Equivalent to calcGradient(pos, max) for the "max" last passed to
+	 * precalcGradient().
+	 *
+	 * @param pos Progress of the gradient.
+	 */
+	inline PixelType gradientColor(uint32 pos) const {
+		return _gradientLine[MIN<uint32>(pos, _gradientLine.size() - 1)];
+	}
+
 	/**
 	 * Fills several pixels in a row with a given color and the specified alpha blending.
 	 *
+	 * The color components and masks are only extracted once for the whole
+	 * span, and runs of identical destination pixels are only blended once,
+	 * so this is a lot faster than calling blendPixelPtr() for each pixel.
+	 * The result is identical to the per pixel version.
+	 *
 	 * @see blendPixelPtr
 	 * @see blendPixel
 	 * @param first Pointer to the first pixel to fill.
@@ -198,9 +226,7 @@ protected:
 	 * @param color Color of the pixel
 	 * @param alpha Alpha intensity of the pixel (0-255)
 	 */
-	inline void blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha) {
-		while (first != last) blendPixelPtr(first++, color, alpha);
-	}
+	void blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha);
 
 	const PixelFormat _format;
 	const PixelType _redMask, _greenMask, _blueMask, _alphaMask;
@@ -213,6 +239,9 @@ protected:
 
 	PixelType _bevelColor;
 	PixelType _bitmapAlphaColor;
+
+	Common::Array<PixelType> _gradientLine; /**< Precalculated gradient colors, see precalcGradient() */
+	int _gradientLineFactor; /**< Gradient factor _gradientLine was calculated with */
 };
 
 
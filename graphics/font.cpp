@@ -49,21 +49,78 @@ int NewFont::getCharWidth(byte chr) const {
 }
 
 
+int NewFont::getStringWidth(const Common::String &str) const {
+	// Same as Font::getStringWidth, but without a virtual call per character
+	if (!desc.width)
+		return desc.maxwidth * str.size();
+
+	int space = 0;
+	for (uint i = 0; i < str.size(); ++i) {
+		byte chr = str[i];
+		if (chr < desc.firstchar || desc.firstchar + desc.size < chr)
+			chr = desc.defaultchar;
+		space += desc.width[chr - desc.firstchar];
+	}
+	return space;
+}
+
+void NewFont::buildGlyphRuns() const {
+	_glyphRuns.clear();
+	_glyphRunOffsets.resize(desc.size);
+
+	for (int chr = 0; chr < desc.size; ++chr) {
+		_glyphRunOffsets[chr] = _glyphRuns.size();
+
+		const int bbh = desc.bbx ? desc.bbx[chr].h : desc.fbbh;
+		const bitmap_t *src = desc.bits + (desc.offset ? desc.offset[chr] : (chr * desc.fbbh));
+
+		for (int y = 0; y < bbh; ++y) {
+			bitmap_t buffer = READ_UINT16(src);
+			src++;
+
+			const uint countPos = _glyphRuns.size();
+			byte count = 0;
+			_glyphRuns.push_back(0);
+
+			for (int x = 0; buffer != 0; ) {
+				// Skip the unset pixels in front of the run...
+				while ((buffer & 0x8000) == 0) {
+					buffer <<= 1;
+					x++;
+				}
+
+				// ...and measure the run itself
+				const int start = x;
+				while ((buffer & 0x8000) != 0) {
+					buffer <<= 1;
+					x++;
+				}
+
+				_glyphRuns.push_back(start);
+				_glyphRuns.push_back(x - start);
+				count++;
+			}
+
+			_glyphRuns[countPos] = count;
+		}
+	}
+}
+
 template <typename PixelType>
-void drawCharIntern(byte *ptr, uint pitch, const bitmap_t *src, int h, int minX, int maxX, const PixelType color) {
-	const bitmap_t maxXMask = ~((1 << (16-maxX)) - 1);
+void drawCharIntern(byte *ptr, uint pitch, const byte *runs, int h, int minX, int maxX, const PixelType color) {
 	while (h-- > 0) {
-		bitmap_t buffer = READ_UINT16(src);
-		src++;
-
-		buffer &= maxXMask;
-		buffer <<= minX;
-		PixelType *tmp = (PixelType *)ptr;
-		while (buffer != 0) {
-			if ((buffer & 0x8000) != 0)
-				*tmp = color;
-			tmp++;
-			buffer <<= 1;
+		int count = *runs++;
+
+		// Pixels are drawn relative to minX, just like when the glyph
+		// bitmap was shifted by minX before being drawn bit by bit.
+		PixelType *row = (PixelType *)ptr - minX;
+		while (count--) {
+			const int start = MAX<int>(runs[0], minX);
+			const int end = MIN<int>(runs[0] + runs[1], maxX);
+			runs += 2;
+
+			for (int x = start; x < end; ++x)
+				row[x] = color;
 		}
 
 		ptr += pitch;
@@ -76,6 +133,9 @@ void NewFont::drawChar(Surface *dst, byte chr, const int tx, const int ty, const
 	assert(desc.bits != 0 && desc.maxwidth <= 16);
 	assert(dst->bytesPerPixel == 1 || dst->bytesPerPixel == 2);
 
+	if (_glyphRunOffsets.empty())
+		buildGlyphRuns();
+
 	// If this character is not included in the font, use the default char.
 	if (chr < desc.firstchar || chr >= desc.firstchar + desc.size) {
 		chr = desc.defaultchar;
@@ -100,16 +160,24 @@ void NewFont::drawChar(Surface *dst, byte chr, const int tx, const int ty, const
 
 	byte *ptr = (byte *)dst->getBasePtr(tx + bbx, ty + desc.ascent - bby - bbh);
 
-	const bitmap_t *tmp = desc.bits + (desc.offset ? desc.offset[chr] : (chr * desc.fbbh));
+	const byte *runs = _glyphRuns.begin() + _glyphRunOffsets[chr];
 
 	int y = MIN(bbh, ty + desc.ascent - bby);
-	tmp += bbh - y;
+	// The glyph is entirely above the surface
+	if (y <= 0)
+		return;
+
+	// Skip the rows clipped at the top of the surface
+	for (int skip = bbh - y; skip > 0; --skip) {
+		runs += 1 + 2 * *runs;
+		ptr += dst->pitch;
+	}
 	y -= MAX(0, ty + desc.ascent - bby - dst->h);
 
 	if (dst->bytesPerPixel == 1)
-		drawCharIntern<byte>(ptr, dst->pitch, tmp, y, MAX(0, -(tx + bbx)), MIN(bbw, dst->w - tx - bbx), color);
+		drawCharIntern<byte>(ptr, dst->pitch, runs, y, MAX(0, -(tx + bbx)), MIN(bbw, dst->w - tx - bbx), color);
 	else if (dst->bytesPerPixel == 2)
-		drawCharIntern<uint16>(ptr, dst->pitch, tmp, y, MAX(0, -(tx + bbx)), MIN(bbw, dst->w - tx - bbx), color);
+		drawCharIntern<uint16>(ptr, dst->pitch, runs, y, MAX(0, -(tx + bbx)), MIN(bbw, dst->w - tx - bbx), color);
 }
 
 
@@ -98,7 +98,7 @@ public:
 	/**
 	 * Compute and return the width the string str has when rendered using this font.
 	 */
-	int getStringWidth(const Common::String &str) const;
+	virtual int getStringWidth(const Common::String &str) const;
 
 	/**
 	 * Take a text (which may contain newline characters) and word wrap it so that
@@ -162,6 +162,19 @@ protected:
 	FontDesc desc;
 	NewFontData *font;
 
+	/**
+	 * All glyph bitmaps, expanded into runs of set pixels. Each glyph row
+	 * is stored as the number of runs followed by a (start, length) pair
+	 * for each run. This allows drawChar to fill whole runs at once instead
+	 * of testing every single bit of the glyph.
+	 * Built on first use by buildGlyphRuns().
+	 */
+	mutable Common::Array<byte> _glyphRuns;
+	/** Offset of the first row of every glyph into _glyphRuns */
+	mutable Common::Array<uint32> _glyphRunOffsets;
+
+	void buildGlyphRuns() const;
+
 public:
 	NewFont(const FontDesc &d, NewFontData *font_ = 0) : desc(d), font(font_) {}
 	~NewFont();
@@ -170,6 +183,7 @@ public:
 	virtual int getMaxCharWidth() const { return desc.maxwidth; }
 
 	virtual int getCharWidth(byte chr) const;
+	virtual int getStringWidth(const Common::String &str) const;
 	virtual void drawChar(Surface *dst, byte chr, int x, int y, uint32 color) const;
 
 	static NewFont *loadFont(Common::SeekableReadStream &stream);
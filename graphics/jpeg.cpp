@@ -23,9 +23,9 @@
  *
  */
 
-#include "graphics/conversion.h"
 #include "graphics/jpeg.h"
 #include "graphics/pixelformat.h"
+#include "graphics/yuv_to_rgb.h"
 
 #include "common/endian.h"
 #include "common/util.h"
@@ -45,23 +45,28 @@ static const uint8 _zigZagOrder[64] = {
 	53, 60, 61, 54, 47, 55, 62, 63
 };
 
-// IDCT table built with :
-// _idct8x8[x][y] = cos(((2 * x + 1) * y) * (M_PI / 16.0)) * 0.5;
-// _idct8x8[x][y] /= sqrt(2.0) if y == 0
-static const double _idct8x8[8][8] = {
-	{ 0.353553390593274,  0.490392640201615,  0.461939766255643,  0.415734806151273,  0.353553390593274,  0.277785116509801,  0.191341716182545,  0.097545161008064 },
-	{ 0.353553390593274,  0.415734806151273,  0.191341716182545, -0.097545161008064, -0.353553390593274, -0.490392640201615, -0.461939766255643, -0.277785116509801 },
-	{ 0.353553390593274,  0.277785116509801, -0.191341716182545, -0.490392640201615, -0.353553390593274,  0.097545161008064,  0.461939766255643,  0.415734806151273 },
-	{ 0.353553390593274,  0.097545161008064, -0.461939766255643, -0.277785116509801,  0.353553390593274,  0.415734806151273, -0.191341716182545, -0.490392640201615 },
-	{ 0.353553390593274, -0.097545161008064, -0.461939766255643,  0.277785116509801,  0.353553390593274, -0.415734806151273, -0.191341716182545,  0.490392640201615 },
-	{ 0.353553390593274, -0.277785116509801, -0.191341716182545,  0.490392640201615, -0.353553390593273, -0.097545161008064,  0.461939766255643, -0.415734806151273 },
-	{ 0.353553390593274, -0.415734806151273,  0.191341716182545,  0.097545161008064, -0.353553390593274,  0.490392640201615, -0.461939766255643,  0.277785116509801 },
-	{ 0.353553390593274, -0.490392640201615,  0.461939766255643, -0.415734806151273,  0.353553390593273, -0.277785116509801,  0.191341716182545, -0.097545161008064 }
+// Fixed point constants of the integer IDCT (13 bits of fraction)
+enum {
+	kIDCTConstBits = 13,
+	kIDCTPass1Bits = 2,
+
+	kFix_0_298631336 = 2446,
+	kFix_0_390180644 = 3196,
+	kFix_0_541196100 = 4433,
+	kFix_0_765366865 = 6270,
+	kFix_0_899976223 = 7373,
+	kFix_1_175875602 = 9633,
+	kFix_1_501321110 = 12299,
+	kFix_1_847759065 = 15137,
+	kFix_1_961570560 = 16069,
+	kFix_2_053119869 = 16819,
+	kFix_2_562915447 = 20995,
+	kFix_3_072711026 = 25172
 };
 
 JPEG::JPEG() :
 	_stream(NULL), _w(0), _h(0), _numComp(0), _components(NULL), _numScanComp(0),
-	_scanComp(NULL), _currentComp(NULL) {
+	_scanComp(NULL), _currentComp(NULL), _restartInterval(0) {
 
 	// Initialize the quantization tables
 	for (int i = 0; i < JPEG_MAX_QUANT_TABLES; i++)
@@ -73,6 +78,7 @@ JPEG::JPEG() :
 		_huff[i].values = NULL;
 		_huff[i].sizes = NULL;
 		_huff[i].codes = NULL;
+		_huff[i].lookup = NULL;
 	}
 }
 
@@ -89,28 +95,40 @@ Surface *JPEG::getSurface(const PixelFormat &format) {
 	if (format.bytesPerPixel == 1)
 		return 0;
 
-	// Get our component surfaces
-	Graphics::Surface *yComponent = getComponent(1);
-	Graphics::Surface *uComponent = getComponent(2);
-	Graphics::Surface *vComponent = getComponent(3);
-
 	Graphics::Surface *output = new Graphics::Surface();
-	output->create(yComponent->w, yComponent->h, format.bytesPerPixel);
-
-	for (uint16 i = 0; i < output->h; i++) {
-		for (uint16 j = 0; j < output->w; j++) {
-			byte r = 0, g = 0, b = 0;
-			YUV2RGB(*((byte *)yComponent->getBasePtr(j, i)), *((byte *)uComponent->getBasePtr(j, i)), *((byte *)vComponent->getBasePtr(j, i)), r, g, b);
-			if (format.bytesPerPixel == 2)
-				*((uint16 *)output->getBasePtr(j, i)) = format.RGBToColor(r, g, b);
-			else
-				*((uint32 *)output->getBasePtr(j, i)) = format.RGBToColor(r, g, b);
-		}
-	}
+	output->create(_w, _h, format.bytesPerPixel);
+	convertToSurface(output, format);
 
 	return output;
 }
 
+bool JPEG::convertToSurface(Surface *dst, const PixelFormat &format) {
+	// Make sure we have loaded data
+	if (!isLoaded())
+		return false;
+
+	assert(dst->w >= _w && dst->h >= _h && dst->bytesPerPixel == format.bytesPerPixel);
+
+	if (format.bytesPerPixel != 2 && format.bytesPerPixel != 4)
+		return false;
+
+	// Convert straight from the component buffers. JFIF stores the
+	// components in Y, Cb, Cr order, whatever ids the encoder gave them.
+	if (_numComp < 3)
+		return false;
+
+	const Graphics::Surface *yComponent = &_components[0].surface;
+	const Graphics::Surface *uComponent = &_components[1].surface;
+	const Graphics::Surface *vComponent = &_components[2].surface;
+
+	// The components have all been upsampled to the full image size
+	assert(uComponent->pitch == vComponent->pitch);
+	YUVToRGBMan.convert444(dst, format, (const byte *)yComponent->pixels, (const byte *)uComponent->pixels, (const byte *)vComponent->pixels,
+	                       _w, _h, yComponent->pitch, uComponent->pitch);
+
+	return true;
+}
+
 void JPEG::reset() {
 	// Reset member variables
 	_stream = NULL;
@@ -126,6 +144,7 @@ void JPEG::reset() {
 	delete[] _scanComp; _scanComp = NULL;
 	_numScanComp = 0;
 	_currentComp = NULL;
+	_restartInterval = 0;
 
 	// Free the quantization tables
 	for (int i = 0; i < JPEG_MAX_QUANT_TABLES; i++) {
@@ -139,6 +158,7 @@ void JPEG::reset() {
 		delete[] _huff[i].values; _huff[i].values = NULL;
 		delete[] _huff[i].sizes; _huff[i].sizes = NULL;
 		delete[] _huff[i].codes; _huff[i].codes = NULL;
+		delete[] _huff[i].lookup; _huff[i].lookup = NULL;
 	}
 }
 
@@ -207,6 +227,9 @@ bool JPEG::read(Common::SeekableReadStream *stream) {
 		case 0xDB: // Define Quantization Tables
 			ok = readDQT();
 			break;
+		case 0xDD: // Define Restart Interval
+			ok = readDRI();
+			break;
 		case 0xE0: // JFIF/JFXX segment
 			ok = readJFIF();
 			break;
@@ -307,6 +330,7 @@ bool JPEG::readDHT() {
 		delete[] _huff[tableNum].values; _huff[tableNum].values = NULL;
 		delete[] _huff[tableNum].sizes; _huff[tableNum].sizes = NULL;
 		delete[] _huff[tableNum].codes;	_huff[tableNum].codes = NULL;
+		delete[] _huff[tableNum].lookup; _huff[tableNum].lookup = NULL;
 
 		// Read the number of values for each length
 		uint8 numValues[16];
@@ -347,6 +371,20 @@ bool JPEG::readDHT() {
 			curCode++;
 			cur++;
 		}
+
+		// Build the lookup table for the short codes. A code of n bits
+		// fills all the entries starting with it.
+		_huff[tableNum].lookup = new uint16[1 << kHuffLookupBits];
+		memset(_huff[tableNum].lookup, 0, sizeof(uint16) << kHuffLookupBits);
+
+		for (cur = 0; cur < _huff[tableNum].count && _huff[tableNum].sizes[cur] <= kHuffLookupBits; cur++) {
+			const uint8 shift = kHuffLookupBits - _huff[tableNum].sizes[cur];
+			const uint16 entry = (_huff[tableNum].sizes[cur] << 8) | _huff[tableNum].values[cur];
+			const uint16 first = _huff[tableNum].codes[cur] << shift;
+
+			for (uint16 i = 0; i < (1 << shift); i++)
+				_huff[tableNum].lookup[first + i] = entry;
+		}
 	}
 
 	return true;
@@ -429,7 +467,10 @@ bool JPEG::readSOS() {
 	}
 
 	// Entropy coded sequence starts, initialize Huffman decoder
+	_bitsData = 0;
 	_bitsNumber = 0;
+	_bitsSizes = 0;
+	_bitsMarker = false;
 
 	// Read all the scan MCUs
 	uint16 xMCU = _w / (_maxFactorH * 8);
@@ -447,9 +488,24 @@ bool JPEG::readSOS() {
 	}
 
 	bool ok = true;
-	for (int y = 0; ok && (y < yMCU); y++)
-		for (int x = 0; ok && (x < xMCU); x++)
-			ok = readMCU(x, y);
+	uint16 mcusLeft = _restartInterval;
+	for (int y = 0; ok && (y < yMCU); y++) {
+		for (int x = 0; ok && (x < xMCU); x++) {
+			if (_restartInterval != 0) {
+				if (mcusLeft == 0) {
+					ok = readRST();
+					mcusLeft = _restartInterval;
+				}
+				mcusLeft--;
+			}
+
+			if (ok)
+				ok = readMCU(x, y);
+		}
+	}
+
+	// Give back what the bit reader read ahead, the next marker follows
+	rewindBits();
 
 	// Trim Component surfaces back to image height and width
 	// Note: Code using jpeg must use surface.pitch correctly...
@@ -491,6 +547,45 @@ bool JPEG::readDQT() {
 	return true;
 }
 
+// Marker 0xDD (Define Restart Interval)
+bool JPEG::readDRI() {
+	debug(5, "JPEG: readDRI");
+	if (_stream->readUint16BE() != 4) {
+		warning("JPEG: Invalid DRI segment size");
+		return false;
+	}
+
+	_restartInterval = _stream->readUint16BE();
+	return true;
+}
+
+// Markers 0xD0-0xD7 (Restart), found in the entropy coded data
+bool JPEG::readRST() {
+	// Drop the bits padding the previous interval
+	rewindBits();
+	_bitsMarker = false;
+
+	uint8 marker = _stream->readByte();
+	if (marker != 0xFF) {
+		warning("JPEG: Invalid restart marker[0]: 0x%02X", marker);
+		return false;
+	}
+
+	while (marker == 0xFF && !_stream->eos())
+		marker = _stream->readByte();
+
+	if ((marker & 0xF8) != 0xD0) {
+		warning("JPEG: Invalid restart marker[1]: 0x%02X", marker);
+		return false;
+	}
+
+	// Each interval is coded independently
+	for (uint16 c = 0; c < _numScanComp; c++)
+		_scanComp[c]->DCpredictor = 0;
+
+	return true;
+}
+
 bool JPEG::readMCU(uint16 xMCU, uint16 yMCU) {
 	bool ok = true;
 	for (int c = 0; ok && (c < _numComp); c++) {
@@ -506,38 +601,135 @@ bool JPEG::readMCU(uint16 xMCU, uint16 yMCU) {
 	return ok;
 }
 
-void JPEG::idct8x8(float result[64], const int16 dct[64]) {
-	float tmp[64];
+// Integer IDCT with the Loeffler-Ligtenberg-Moschytz factorization, as
+// used by the IJG "islow" IDCT. The result is level shifted and clipped.
+void JPEG::idct8x8(byte result[64], const int16 dct[64]) {
+	int32 tmp[64];
 
-	// Apply 1D IDCT to rows
-	for (int y = 0; y < 8; y++) {
-		for (int x = 0; x < 8; x++) {
-			tmp[y + x * 8] = dct[0] * _idct8x8[x][0]
-							+ dct[1] * _idct8x8[x][1]
-							+ dct[2] * _idct8x8[x][2]
-							+ dct[3] * _idct8x8[x][3]
-							+ dct[4] * _idct8x8[x][4]
-							+ dct[5] * _idct8x8[x][5]
-							+ dct[6] * _idct8x8[x][6]
-							+ dct[7] * _idct8x8[x][7];
+	// Apply 1D IDCT to columns. The results are scaled up by kIDCTPass1Bits
+	for (int x = 0; x < 8; x++) {
+		const int16 *in = dct + x;
+		int32 *out = tmp + x;
+
+		// Columns without AC coefficients are very common
+		if (!in[8] && !in[16] && !in[24] && !in[32] && !in[40] && !in[48] && !in[56]) {
+			const int32 dc = in[0] << kIDCTPass1Bits;
+			for (int y = 0; y < 8; y++)
+				out[y * 8] = dc;
+			continue;
 		}
 
-		dct += 8;
+		// Even part
+		int32 z2 = in[16];
+		int32 z3 = in[48];
+		int32 z1 = (z2 + z3) * kFix_0_541196100;
+		int32 tmp2 = z1 - z3 * kFix_1_847759065;
+		int32 tmp3 = z1 + z2 * kFix_0_765366865;
+
+		int32 tmp0 = (in[0] + in[32]) << kIDCTConstBits;
+		int32 tmp1 = (in[0] - in[32]) << kIDCTConstBits;
+
+		const int32 tmp10 = tmp0 + tmp3;
+		const int32 tmp13 = tmp0 - tmp3;
+		const int32 tmp11 = tmp1 + tmp2;
+		const int32 tmp12 = tmp1 - tmp2;
+
+		// Odd part
+		tmp0 = in[56];
+		tmp1 = in[40];
+		tmp2 = in[24];
+		tmp3 = in[8];
+
+		z1 = tmp0 + tmp3;
+		z2 = tmp1 + tmp2;
+		z3 = tmp0 + tmp2;
+		int32 z4 = tmp1 + tmp3;
+		const int32 z5 = (z3 + z4) * kFix_1_175875602;
+
+		tmp0 *= kFix_0_298631336;
+		tmp1 *= kFix_2_053119869;
+		tmp2 *= kFix_3_072711026;
+		tmp3 *= kFix_1_501321110;
+		z1 *= -kFix_0_899976223;
+		z2 *= -kFix_2_562915447;
+		z3 = z3 * -kFix_1_961570560 + z5;
+		z4 = z4 * -kFix_0_390180644 + z5;
+
+		tmp0 += z1 + z3;
+		tmp1 += z2 + z4;
+		tmp2 += z2 + z3;
+		tmp3 += z1 + z4;
+
+		const int shift = kIDCTConstBits - kIDCTPass1Bits;
+		const int32 round = 1 << (shift - 1);
+		out[ 0] = (tmp10 + tmp3 + round) >> shift;
+		out[56] = (tmp10 - tmp3 + round) >> shift;
+		out[ 8] = (tmp11 + tmp2 + round) >> shift;
+		out[48] = (tmp11 - tmp2 + round) >> shift;
+		out[16] = (tmp12 + tmp1 + round) >> shift;
+		out[40] = (tmp12 - tmp1 + round) >> shift;
+		out[24] = (tmp13 + tmp0 + round) >> shift;
+		out[32] = (tmp13 - tmp0 + round) >> shift;
 	}
 
-	// Apply 1D IDCT to columns
-	for (int x = 0; x < 8; x++) {
-		const float *u = tmp + x * 8;
-		for (int y = 0; y < 8; y++) {
-			result[y * 8 + x] = u[0] * _idct8x8[y][0]
-								+ u[1] * _idct8x8[y][1]
-								+ u[2] * _idct8x8[y][2]
-								+ u[3] * _idct8x8[y][3]
-								+ u[4] * _idct8x8[y][4]
-								+ u[5] * _idct8x8[y][5]
-								+ u[6] * _idct8x8[y][6]
-								+ u[7] * _idct8x8[y][7];
-		}
+	// Apply 1D IDCT to rows, removing the scaling of both passes and
+	// the factor of 8 of the 2D transformation
+	for (int y = 0; y < 8; y++) {
+		const int32 *in = tmp + y * 8;
+		byte *out = result + y * 8;
+
+		// Even part
+		int32 z2 = in[2];
+		int32 z3 = in[6];
+		int32 z1 = (z2 + z3) * kFix_0_541196100;
+		int32 tmp2 = z1 - z3 * kFix_1_847759065;
+		int32 tmp3 = z1 + z2 * kFix_0_765366865;
+
+		int32 tmp0 = (in[0] + in[4]) << kIDCTConstBits;
+		int32 tmp1 = (in[0] - in[4]) << kIDCTConstBits;
+
+		const int32 tmp10 = tmp0 + tmp3;
+		const int32 tmp13 = tmp0 - tmp3;
+		const int32 tmp11 = tmp1 + tmp2;
+		const int32 tmp12 = tmp1 - tmp2;
+
+		// Odd part
+		tmp0 = in[7];
+		tmp1 = in[5];
+		tmp2 = in[3];
+		tmp3 = in[1];
+
+		z1 = tmp0 + tmp3;
+		z2 = tmp1 + tmp2;
+		z3 = tmp0 + tmp2;
+		int32 z4 = tmp1 + tmp3;
+		const int32 z5 = (z3 + z4) * kFix_1_175875602;
+
+		tmp0 *= kFix_0_298631336;
+		tmp1 *= kFix_2_053119869;
+		tmp2 *= kFix_3_072711026;
+		tmp3 *= kFix_1_501321110;
+		z1 *= -kFix_0_899976223;
+		z2 *= -kFix_2_562915447;
+		z3 = z3 * -kFix_1_961570560 + z5;
+		z4 = z4 * -kFix_0_390180644 + z5;
+
+		tmp0 += z1 + z3;
+		tmp1 += z2 + z4;
+		tmp2 += z2 + z3;
+		tmp3 += z1 + z4;
+
+		// Level shift to make the values unsigned
+		const int shift = kIDCTConstBits + kIDCTPass1Bits + 3;
+		const int32 round = (1 << (shift - 1)) + (128 << shift);
+		out[0] = CLIP<int32>((tmp10 + tmp3 + round) >> shift, 0, 255);
+		out[7] = CLIP<int32>((tmp10 - tmp3 + round) >> shift, 0, 255);
+		out[1] = CLIP<int32>((tmp11 + tmp2 + round) >> shift, 0, 255);
+		out[6] = CLIP<int32>((tmp11 - tmp2 + round) >> shift, 0, 255);
+		out[2] = CLIP<int32>((tmp12 + tmp1 + round) >> shift, 0, 255);
+		out[5] = CLIP<int32>((tmp12 - tmp1 + round) >> shift, 0, 255);
+		out[3] = CLIP<int32>((tmp13 + tmp0 + round) >> shift, 0, 255);
+		out[4] = CLIP<int32>((tmp13 - tmp0 + round) >> shift, 0, 255);
 	}
 }
 
@@ -567,20 +759,9 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 	}
 
 	// Apply the IDCT
-	float result[64];
+	byte result[64];
 	idct8x8(result, DCT);
 
-	// Level shift to make the values unsigned
-	for (int i = 0; i < 64; i++) {
-		result[i] = result[i] + 128;
-
-		if (result[i] < 0)
-			result[i] = 0;
-
-		if (result[i] > 255)
-			result[i] = 255;
-	}
-
 	// Paint the component surface
 	uint8 scalingV = _maxFactorV / _currentComp->factorV;
 	uint8 scalingH = _maxFactorH / _currentComp->factorH;
@@ -589,6 +770,14 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 	x <<= 3;
 	y <<= 3;
 
+	if (scalingV == 1 && scalingH == 1) {
+		// Not subsampled, copy whole lines
+		for (uint8 j = 0; j < 8; j++)
+			memcpy(_currentComp->surface.getBasePtr(x, y + j), result + j * 8, 8);
+
+		return true;
+	}
+
 	for (uint8 j = 0; j < 8; j++) {
 		for (uint16 sV = 0; sV < scalingV; sV++) {
 			// Get the beginning of the block line
@@ -596,7 +785,7 @@ bool JPEG::readDataUnit(uint16 x, uint16 y) {
 
 			for (uint8 i = 0; i < 8; i++) {
 				for (uint16 sH = 0; sH < scalingH; sH++) {
-					*ptr = (byte)(result[j * 8 + i]);
+					*ptr = result[j * 8 + i];
 					ptr++;
 				}
 			}
@@ -648,78 +837,94 @@ void JPEG::readAC(int16 *out) {
 }
 
 int16 JPEG::readSignedBits(uint8 numBits) {
-	uint16 ret = 0;
+	if (numBits == 0)
+		return 0;
 	if (numBits > 16) error("requested %d bits", numBits); //XXX
 
-	// MSB=0 for negatives, 1 for positives
-	for (int i = 0; i < numBits; i++)
-		ret = (ret << 1) + readBit();
+	fillBits();
+	_bitsNumber -= numBits;
+	uint16 ret = (_bitsData >> _bitsNumber) & ((1 << numBits) - 1);
 
+	// MSB=0 for negatives, 1 for positives
 	// Extend sign bits (PAG109)
 	if (!(ret >> (numBits - 1)))
-	{
-		uint16 tmp = ((uint16)-1 << numBits) + 1;
-		ret = ret + tmp;
-	}
+		ret -= (1 << numBits) - 1;
+
 	return ret;
 }
 
-// TODO: optimize?
 uint8 JPEG::readHuff(uint8 table) {
-	bool foundCode = false;
-	uint8 val = 0;
-
-	uint8 cur = 0;
-	uint8 codeSize = 1;
-	uint16 code = readBit();
-	while (!foundCode) {
-		// Prepare a code of the current size
-		while (codeSize < _huff[table].sizes[cur]) {
-			code = (code << 1) + readBit();
-			codeSize++;
-		}
+	const HuffmanTable &huff = _huff[table];
 
-		// Compare the codes of the current size
-		while (!foundCode && (codeSize == _huff[table].sizes[cur])) {
-			if (code == _huff[table].codes[cur]) {
-				// Found the code
-				val = _huff[table].values[cur];
-				foundCode = true;
-			} else {
-				// Continue reading
-				cur++;
-			}
+	fillBits();
+
+	// Most codes are short enough to be found with a single lookup
+	const uint16 entry = huff.lookup[(_bitsData >> (_bitsNumber - kHuffLookupBits)) & ((1 << kHuffLookupBits) - 1)];
+	if (entry) {
+		_bitsNumber -= entry >> 8;
+		return entry & 0xFF;
+	}
+
+	// Compare the longer codes one by one
+	for (uint8 cur = 0; cur < huff.count; cur++) {
+		const uint8 codeSize = huff.sizes[cur];
+		if (codeSize <= kHuffLookupBits)
+			continue;
+
+		if (((_bitsData >> (_bitsNumber - codeSize)) & ((1 << codeSize) - 1)) == huff.codes[cur]) {
+			_bitsNumber -= codeSize;
+			return huff.values[cur];
 		}
 	}
 
-	return val;
+	warning("JPEG: Invalid Huffman code");
+	_bitsNumber -= 16;
+	return 0;
 }
 
-uint8 JPEG::readBit() {
-	// Read a whole byte if necessary
-	if (_bitsNumber == 0) {
-		_bitsData = _stream->readByte();
-		_bitsNumber = 8;
-
-		// Detect markers
-		if (_bitsData == 0xFF) {
-			uint8 byte2 = _stream->readByte();
-
-			// A stuffed 0 validates the previous byte
-			if (byte2 != 0) {
-				if (byte2 == 0xDC) {
-					// DNL marker: Define Number of Lines
-					// TODO: terminate scan
-					printf("DNL marker detected: terminate scan\n");
+void JPEG::fillBits() {
+	// Keep at least 25 bits buffered: enough for any code or value
+	while (_bitsNumber <= 24) {
+		uint8 data = 0;
+		uint8 size = 0;
+
+		if (!_bitsMarker) {
+			data = _stream->readByte();
+			size = 1;
+
+			if (_stream->eos()) {
+				data = 0;
+				size = 0;
+				_bitsMarker = true;
+			} else if (data == 0xFF) {
+				// A stuffed 0 validates the previous byte
+				if (_stream->readByte() == 0) {
+					size = 2;
 				} else {
-					printf("Error: marker 0x%02X read in entropy data\n", byte2);
+					// This is a marker, it terminates the entropy coded data.
+					// Leave it in the stream and pad the remaining bits with 0.
+					_stream->seek(-2, SEEK_CUR);
+					data = 0;
+					size = 0;
+					_bitsMarker = true;
 				}
 			}
 		}
+
+		_bitsData = (_bitsData << 8) | data;
+		_bitsSizes = (_bitsSizes << 2) | size;
+		_bitsNumber += 8;
 	}
-	_bitsNumber--;
+}
 
-	return (_bitsData & (1 << _bitsNumber)) ? 1 : 0;
+void JPEG::rewindBits() {
+	// Seek back over all the whole bytes which were buffered but not used
+	for (uint8 i = 0; i < _bitsNumber / 8; i++)
+		_stream->seek(-((_bitsSizes >> (i * 2)) & 3), SEEK_CUR);
+
+	_bitsData = 0;
+	_bitsNumber = 0;
+	_bitsSizes = 0;
 }
 
 Surface *JPEG::getComponent(uint c) {
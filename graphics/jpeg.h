@@ -52,6 +52,13 @@ public:
 	Surface *getComponent(uint c);
 	Surface *getSurface(const PixelFormat &format);
 
+	/**
+	 * Converts the image into an already allocated surface, which has to
+	 * be at least as big as the image and use the given pixel format.
+	 * This avoids allocating a new surface for every decoded image.
+	 */
+	bool convertToSurface(Surface *dst, const PixelFormat &format);
+
 private:
 	void reset();
 
@@ -87,6 +94,9 @@ private:
 	uint8 _maxFactorV;
 	uint8 _maxFactorH;
 
+	// Number of MCUs between restart markers, 0 if there are none
+	uint16 _restartInterval;
+
 	// Quantization tables
 	uint16 *_quant[JPEG_MAX_QUANT_TABLES];
 
@@ -96,14 +106,24 @@ private:
 		uint8 *values;
 		uint8 *sizes;
 		uint16 *codes;
+
+		// Codes of up to kHuffLookupBits bits, indexed by the next bits
+		// of the stream: (code size << 8) | value, or 0 for longer codes
+		uint16 *lookup;
 	} _huff[2 * JPEG_MAX_HUFF_TABLES];
 
+	enum {
+		kHuffLookupBits = 9
+	};
+
 	// Marker read functions
 	bool readJFIF();
 	bool readSOF0();
 	bool readDHT();
 	bool readSOS();
 	bool readDQT();
+	bool readDRI();
+	bool readRST();
 
 	// Helper functions
 	bool readMCU(uint16 xMCU, uint16 yMCU);
@@ -114,12 +134,15 @@ private:
 
 	// Huffman decoding
 	uint8 readHuff(uint8 table);
-	uint8 readBit();
-	uint8 _bitsData;
-	uint8 _bitsNumber;
+	void fillBits();
+	void rewindBits();
+	uint32 _bitsData;   ///< Bit buffer, the oldest bits are the most significant ones
+	uint8 _bitsNumber;  ///< Number of valid bits in _bitsData
+	uint8 _bitsSizes;   ///< Number of stream bytes of each of the last 4 buffered bytes (2 bits each)
+	bool _bitsMarker;   ///< A marker ended the entropy coded data
 
 	// Inverse Discrete Cosine Transformation
-	void idct8x8(float dst[64], const int16 src[64]);
+	void idct8x8(byte dst[64], const int16 src[64]);
 };
 
 } // End of Graphics namespace
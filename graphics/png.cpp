@@ -27,6 +27,7 @@
 #include "graphics/png.h"
 #include "graphics/pixelformat.h"
 
+#include "common/array.h"
 #include "common/endian.h"
 #include "common/memstream.h"
 #include "common/stream.h"
@@ -101,8 +102,84 @@ enum PNGFilters {
 
 #define PNG_HEADER(a, b, c, d) CONSTANT_LE_32(d | (c << 8) | (b << 16) | (a << 24))
 
-PNG::PNG() : _compressedBuffer(0), _compressedBufferSize(0), 
-			_unfilteredSurface(0), _transparentColorSpecified(false) {
+/**
+ * Presents the contents of all the IDAT chunks of a PNG file as one
+ * continuous stream, reading them straight from the file stream. This
+ * lets the image data be inflated without first gathering all of the
+ * compressed data in a separate buffer.
+ */
+class PNGImageDataStream : public Common::SeekableReadStream {
+public:
+	struct Chunk {
+		uint32 offset;	// Position of the chunk data in the file stream
+		uint32 length;
+	};
+
+	PNGImageDataStream(Common::SeekableReadStream *parentStream, const Common::Array<Chunk> &chunks) :
+		_parentStream(parentStream), _chunks(chunks), _size(0), _pos(0), _eos(false) {
+
+		for (uint i = 0; i < _chunks.size(); i++)
+			_size += _chunks[i].length;
+	}
+
+	bool eos() const { return _eos; }
+	int32 pos() const { return _pos; }
+	int32 size() const { return _size; }
+
+	bool seek(int32 offset, int whence = SEEK_SET) {
+		int32 newPos = offset;
+		if (whence == SEEK_CUR)
+			newPos += _pos;
+		else if (whence == SEEK_END)
+			newPos += _size;
+
+		if (newPos < 0 || newPos > (int32)_size)
+			return false;
+
+		_pos = newPos;
+		_eos = false;
+		return true;
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		byte *dst = (byte *)dataPtr;
+		uint32 done = 0;
+		uint32 chunkStart = 0;
+
+		for (uint i = 0; i < _chunks.size() && done < dataSize; i++) {
+			const Chunk &chunk = _chunks[i];
+
+			if (_pos < chunkStart + chunk.length) {
+				const uint32 chunkPos = _pos - chunkStart;
+				const uint32 len = MIN(chunk.length - chunkPos, dataSize - done);
+
+				_parentStream->seek(chunk.offset + chunkPos);
+				const uint32 actual = _parentStream->read(dst + done, len);
+				done += actual;
+				_pos += actual;
+
+				if (actual != len)
+					break;
+			}
+
+			chunkStart += chunk.length;
+		}
+
+		if (done < dataSize)
+			_eos = true;
+
+		return done;
+	}
+
+private:
+	Common::SeekableReadStream *_parentStream;
+	Common::Array<Chunk> _chunks;
+	uint32 _size;
+	uint32 _pos;
+	bool _eos;
+};
+
+PNG::PNG() : _unfilteredSurface(0), _transparentColorSpecified(false) {
 }
 
 PNG::~PNG() {
@@ -115,88 +192,70 @@ PNG::~PNG() {
 Graphics::Surface *PNG::getSurface(const PixelFormat &format) {
 	Graphics::Surface *output = new Graphics::Surface();
 	output->create(_unfilteredSurface->w, _unfilteredSurface->h, format.bytesPerPixel);
-	byte *src = (byte *)_unfilteredSurface->pixels;
-	byte a = 0xFF;
-
-	if (_header.colorType != kIndexed) {
-		if (_header.colorType == kTrueColor || _header.colorType == kTrueColorWithAlpha) {
-			if (_unfilteredSurface->bytesPerPixel != 3 && _unfilteredSurface->bytesPerPixel != 4)
-				error("Unsupported truecolor PNG format");
-		} else if (_header.colorType == kGrayScale || _header.colorType == kGrayScaleWithAlpha) {
-			if (_unfilteredSurface->bytesPerPixel != 1 && _unfilteredSurface->bytesPerPixel != 2)
-				error("Unsupported grayscale PNG format");
-		}
 
-		for (uint16 i = 0; i < output->h; i++) {
-			for (uint16 j = 0; j < output->w; j++) {
-				if (format.bytesPerPixel == 2) {
-					if (_unfilteredSurface->bytesPerPixel == 1) {		// Grayscale
-						if (_transparentColorSpecified)
-							a = (src[0] == _transparentColor[0]) ? 0 : 0xFF;
-						*((uint16 *)output->getBasePtr(j, i)) = format.ARGBToColor(    a, src[0], src[0], src[0]);
-					} else if (_unfilteredSurface->bytesPerPixel == 2) {	// Grayscale + alpha
-						*((uint16 *)output->getBasePtr(j, i)) = format.ARGBToColor(src[1], src[0], src[0], src[0]);
-					} else if (_unfilteredSurface->bytesPerPixel == 3) {	// RGB
-						if (_transparentColorSpecified) {
-							bool isTransparentColor = (src[0] == _transparentColor[0] &&
-													   src[1] == _transparentColor[1] &&
-													   src[2] == _transparentColor[2]);
-							a = isTransparentColor ? 0 : 0xFF;
-						}
-						*((uint16 *)output->getBasePtr(j, i)) = format.ARGBToColor(     a, src[0], src[1], src[2]);
-					} else if (_unfilteredSurface->bytesPerPixel == 4) {	// RGBA
-						*((uint16 *)output->getBasePtr(j, i)) = format.ARGBToColor(src[3], src[0], src[1], src[2]);
-					}
-				} else {
-					if (_unfilteredSurface->bytesPerPixel == 1) {		// Grayscale
-						if (_transparentColorSpecified)
-							a = (src[0] == _transparentColor[0]) ? 0 : 0xFF;
-						*((uint32 *)output->getBasePtr(j, i)) = format.ARGBToColor(     a, src[0], src[0], src[0]);
-					} else if (_unfilteredSurface->bytesPerPixel == 2) {	// Grayscale + alpha
-						*((uint32 *)output->getBasePtr(j, i)) = format.ARGBToColor(src[1], src[0], src[0], src[0]);
-					} else if (_unfilteredSurface->bytesPerPixel == 3) {	// RGB
-						if (_transparentColorSpecified) {
-							bool isTransparentColor = (src[0] == _transparentColor[0] &&
-													   src[1] == _transparentColor[1] &&
-													   src[2] == _transparentColor[2]);
-							a = isTransparentColor ? 0 : 0xFF;
-						}
-						*((uint32 *)output->getBasePtr(j, i)) = format.ARGBToColor(     a, src[0], src[1], src[2]);
-					} else if (_unfilteredSurface->bytesPerPixel == 4) {	// RGBA
-						*((uint32 *)output->getBasePtr(j, i)) = format.ARGBToColor(src[3], src[0], src[1], src[2]);
-					}
-				}
-
-				src += _unfilteredSurface->bytesPerPixel;
+	if (_header.colorType == kTrueColor || _header.colorType == kTrueColorWithAlpha) {
+		if (_unfilteredSurface->bytesPerPixel != 3 && _unfilteredSurface->bytesPerPixel != 4)
+			error("Unsupported truecolor PNG format");
+	} else if (_header.colorType == kGrayScale || _header.colorType == kGrayScaleWithAlpha) {
+		if (_unfilteredSurface->bytesPerPixel != 1 && _unfilteredSurface->bytesPerPixel != 2)
+			error("Unsupported grayscale PNG format");
+	}
+
+	if (format.bytesPerPixel == 2)
+		convertSurface<uint16>(output, format);
+	else
+		convertSurface<uint32>(output, format);
+
+	return output;
+}
+
+template<typename PixelInt>
+void PNG::convertSurface(Graphics::Surface *output, const PixelFormat &format) {
+	const byte bytesPerPixel = _unfilteredSurface->bytesPerPixel;
+	const uint16 width = output->w;
+
+	// The pixel type decides the conversion once per row, not once per pixel
+	for (uint16 i = 0; i < output->h; i++) {
+		const byte *src = (const byte *)_unfilteredSurface->getBasePtr(0, i);
+		PixelInt *dst = (PixelInt *)output->getBasePtr(0, i);
+		PixelInt *dstEnd = dst + width;
+
+		if (_header.colorType == kIndexed) {
+			// Convert the indexed surface to the target pixel format
+			for (; dst < dstEnd; dst++, src++) {
+				const byte *entry = _palette + *src * 4;
+				*dst = format.ARGBToColor(entry[3], entry[0], entry[1], entry[2]);
 			}
-		}
-	} else {
-		byte index, r, g, b;
-
-		// Convert the indexed surface to the target pixel format
-		for (uint16 i = 0; i < output->h; i++) {
-			for (uint16 j = 0; j < output->w; j++) {
-				index = *src;
-				r = _palette[index * 4 + 0];
-				g = _palette[index * 4 + 1];
-				b = _palette[index * 4 + 2];
-				a = _palette[index * 4 + 3];
-
-				if (format.bytesPerPixel == 2)
-					*((uint16 *)output->getBasePtr(j, i)) = format.ARGBToColor(a, r, g, b);
-				else
-					*((uint32 *)output->getBasePtr(j, i)) = format.ARGBToColor(a, r, g, b);
-
-				src++;
+		} else if (bytesPerPixel == 1) {		// Grayscale
+			for (; dst < dstEnd; dst++, src++) {
+				byte a = 0xFF;
+				if (_transparentColorSpecified && src[0] == _transparentColor[0])
+					a = 0;
+				*dst = format.ARGBToColor(a, src[0], src[0], src[0]);
+			}
+		} else if (bytesPerPixel == 2) {	// Grayscale + alpha
+			for (; dst < dstEnd; dst++, src += 2)
+				*dst = format.ARGBToColor(src[1], src[0], src[0], src[0]);
+		} else if (bytesPerPixel == 3) {	// RGB
+			for (; dst < dstEnd; dst++, src += 3) {
+				byte a = 0xFF;
+				if (_transparentColorSpecified &&
+				    src[0] == _transparentColor[0] &&
+				    src[1] == _transparentColor[1] &&
+				    src[2] == _transparentColor[2])
+					a = 0;
+				*dst = format.ARGBToColor(a, src[0], src[1], src[2]);
 			}
+		} else if (bytesPerPixel == 4) {	// RGBA
+			for (; dst < dstEnd; dst++, src += 4)
+				*dst = format.ARGBToColor(src[3], src[0], src[1], src[2]);
 		}
 	}
-
-	return output;
 }
 
 bool PNG::read(Common::SeekableReadStream *str) {
 	uint32 chunkLength = 0, chunkType = 0;
+	Common::Array<PNGImageDataStream::Chunk> imageDataChunks;
 	_stream = str;
 
 	// First, check the PNG signature
@@ -219,24 +278,15 @@ bool PNG::read(Common::SeekableReadStream *str) {
 		case kChunkIHDR:
 			readHeaderChunk();
 			break;
-		case kChunkIDAT:
-			if (_compressedBufferSize == 0) {
-				_compressedBufferSize += chunkLength;
-				_compressedBuffer = new byte[_compressedBufferSize];
-				_stream->read(_compressedBuffer, chunkLength);
-			} else {
-				// Expand the buffer
-				uint32 prevSize = _compressedBufferSize;
-				_compressedBufferSize += chunkLength;
-				byte *tmp = new byte[prevSize];
-				memcpy(tmp, _compressedBuffer, prevSize);
-				delete[] _compressedBuffer;
-				_compressedBuffer = new byte[_compressedBufferSize];
-				memcpy(_compressedBuffer, tmp, prevSize);
-				delete[] tmp;
-				_stream->read(_compressedBuffer + prevSize, chunkLength);
-			}
+		case kChunkIDAT: {
+			// Only remember where the data is, it is read while inflating
+			PNGImageDataStream::Chunk chunk;
+			chunk.offset = _stream->pos();
+			chunk.length = chunkLength;
+			imageDataChunks.push_back(chunk);
+			_stream->skip(chunkLength);
 			break;
+		}
 		case kChunkPLTE:	// only available in indexed PNGs
 			if (_header.colorType != kIndexed)
 				error("A palette chunk has been found in a non-indexed PNG file");
@@ -261,44 +311,45 @@ bool PNG::read(Common::SeekableReadStream *str) {
 			_stream->skip(4);	// skip the chunk CRC checksum
 	}
 
-	// We no longer need the file stream, thus close it here
-	delete _stream;
-	_stream = 0;
-
-	// Unpack the compressed buffer
-	Common::MemoryReadStream *compData = new Common::MemoryReadStream(_compressedBuffer, _compressedBufferSize, DisposeAfterUse::YES);
+	// Inflate the image data directly from the IDAT chunks of the file
+	PNGImageDataStream *compData = new PNGImageDataStream(_stream, imageDataChunks);
 	_imageData = Common::wrapCompressedReadStream(compData);
-	
+
 	// Construct the final image
 	constructImage();
 
-	// Close the uncompressed stream, which will also delete the memory stream,
-	// and thus the original compressed buffer
+	// Close the uncompressed stream, which will also delete the image
+	// data stream
 	delete _imageData;
+	_imageData = 0;
+
+	// We no longer need the file stream, thus close it here
+	delete _stream;
+	_stream = 0;
 
 	return true;
 }
 
 /**
  * Paeth predictor, used by PNG filter type 4
- * The parameters are of signed 16-bit integers, but should come
- * from unsigned chars. The integers  are only needed to make
- * the paeth calculation correct.
+ * The parameters are of signed integers, but should come from unsigned
+ * chars. The integers are only needed to make the paeth calculation
+ * correct.
  *
  * Taken from lodePNG, with a slight patch:
  * http://www.atalasoft.com/cs/blogs/stevehawley/archive/2010/02/23/libpng-you-re-doing-it-wrong.aspx
  */
-byte PNG::paethPredictor(int16 a, int16 b, int16 c) {
-  int16 pa = ABS<int16>(b - c);
-  int16 pb = ABS<int16>(a - c);
-  int16 pc = ABS<int16>(a + b - c - c);
-    
-  if (pa <= MIN<int16>(pb, pc))
-	  return (byte)a;
-  else if (pb <= pc)
-	  return (byte)b;
-  else
-	  return (byte)c;
+static inline byte paethPredictor(int a, int b, int c) {
+	const int pa = ABS(b - c);
+	const int pb = ABS(a - c);
+	const int pc = ABS(a + b - c - c);
+
+	if (pa <= pb && pa <= pc)
+		return (byte)a;
+	else if (pb <= pc)
+		return (byte)b;
+	else
+		return (byte)c;
 }
 
 /**
@@ -306,55 +357,53 @@ byte PNG::paethPredictor(int16 a, int16 b, int16 c) {
  * PNG filters are defined in: http://www.w3.org/TR/PNG/#9Filters
  * Note that filters are always applied to bytes
  *
- * Taken from lodePNG
+ * Based on lodePNG. The first pixel of the line has no left neighbour, so
+ * it is handled separately, which keeps the inner loops free of checks.
  */
-void PNG::unfilterScanLine(byte *dest, const byte *scanLine, const byte *prevLine, uint16 byteWidth, byte filterType, uint16 length) {
-	uint16 i;
+void PNG::unfilterScanLine(byte *dest, const byte *scanLine, const byte *prevLine, uint16 byteWidth, byte filterType, uint32 length) {
+	// The left neighbours of each byte, in the already unfiltered output
+	const byte *left = dest;
+	uint32 i;
 
 	switch (filterType) {
 	case kFilterNone:		// no change
-		for (i = 0; i < length; i++)
-			dest[i] = scanLine[i];
+		memcpy(dest, scanLine, length);
 		break;
 	case kFilterSub:		// add the bytes to the left
-		for (i = 0; i < byteWidth; i++)
-			dest[i] = scanLine[i];
+		memcpy(dest, scanLine, byteWidth);
 		for (i = byteWidth; i < length; i++)
-			dest[i] = scanLine[i] + dest[i - byteWidth];
+			dest[i] = scanLine[i] + left[i - byteWidth];
 		break;
 	case kFilterUp:			// add the bytes of the above scanline
 		if (prevLine) {
 			for (i = 0; i < length; i++)
 				dest[i] = scanLine[i] + prevLine[i];
 		} else {
-			for (i = 0; i < length; i++)
-				dest[i] = scanLine[i];
+			memcpy(dest, scanLine, length);
 		}
 		break;
 	case kFilterAverage:	// average value of the left and top left
 		if (prevLine) {
 			for (i = 0; i < byteWidth; i++)
-				dest[i] = scanLine[i] + prevLine[i] / 2;
+				dest[i] = scanLine[i] + (prevLine[i] >> 1);
 			for (i = byteWidth; i < length; i++)
-				dest[i] = scanLine[i] + ((dest[i - byteWidth] + prevLine[i]) / 2);
+				dest[i] = scanLine[i] + ((left[i - byteWidth] + prevLine[i]) >> 1);
 		} else {
-			for (i = 0; i < byteWidth; i++)
-				dest[i] = scanLine[i];
+			memcpy(dest, scanLine, byteWidth);
 			for (i = byteWidth; i < length; i++)
-				dest[i] = scanLine[i] + dest[i - byteWidth] / 2;
+				dest[i] = scanLine[i] + (left[i - byteWidth] >> 1);
 		}
 		break;
 	case kFilterPaeth:		// Paeth filter: http://www.w3.org/TR/PNG/#9Filter-type-4-Paeth
 		if (prevLine) {
-			for(i = 0; i < byteWidth; i++)
-				dest[i] = (scanLine[i] + prevLine[i]); // paethPredictor(0, prevLine[i], 0) is always prevLine[i]
-			for(i = byteWidth; i < length; i++)
-				dest[i] = (scanLine[i] + paethPredictor(dest[i - byteWidth], prevLine[i], prevLine[i - byteWidth]));
+			for (i = 0; i < byteWidth; i++)
+				dest[i] = scanLine[i] + prevLine[i]; // paethPredictor(0, prevLine[i], 0) is always prevLine[i]
+			for (i = byteWidth; i < length; i++)
+				dest[i] = scanLine[i] + paethPredictor(left[i - byteWidth], prevLine[i], prevLine[i - byteWidth]);
 		} else {
-			for(i = 0; i < byteWidth; i++)
-				dest[i] = scanLine[i];
-			for(i = byteWidth; i < length; i++)
-				dest[i] = (scanLine[i] + dest[i - byteWidth]); // paethPredictor(dest[i - byteWidth], 0, 0) is always dest[i - byteWidth]
+			memcpy(dest, scanLine, byteWidth);
+			for (i = byteWidth; i < length; i++)
+				dest[i] = scanLine[i] + left[i - byteWidth]; // paethPredictor(dest[i - byteWidth], 0, 0) is always dest[i - byteWidth]
 		}
 		break;
 	default:
@@ -370,7 +419,7 @@ void PNG::constructImage() {
 	byte *scanLine;
 	byte *prevLine = 0;
 	byte filterType;
-	uint16 scanLineWidth = (_header.width * getNumColorChannels() * _header.bitDepth + 7) / 8;
+	uint32 scanLineWidth = (_header.width * getNumColorChannels() * _header.bitDepth + 7) / 8;
 
 	if (_unfilteredSurface) {
 		_unfilteredSurface->free();
@@ -384,6 +433,7 @@ void PNG::constructImage() {
 	switch(_header.interlaceType) {
 	case kNonInterlaced:
 		for (uint16 y = 0; y < _unfilteredSurface->h; y++) {
+			// Rows are inflated one at a time, straight from the file data
 			filterType = _imageData->readByte();
 			_imageData->read(scanLine, scanLineWidth);
 			unfilterScanLine(dest, scanLine, prevLine, _unfilteredSurface->bytesPerPixel, filterType, scanLineWidth);
@@ -136,8 +136,10 @@ private:
 	void readTransparencyChunk(uint32 chunkLength);
 
 	void constructImage();
-	void unfilterScanLine(byte *dest, const byte *scanLine, const byte *prevLine, uint16 byteWidth, byte filterType, uint16 length);
-	byte paethPredictor(int16 a, int16 b, int16 c);
+	void unfilterScanLine(byte *dest, const byte *scanLine, const byte *prevLine, uint16 byteWidth, byte filterType, uint32 length);
+
+	template<typename PixelInt>
+	void convertSurface(Graphics::Surface *output, const PixelFormat &format);
 
 	// The original file stream
 	Common::SeekableReadStream *_stream;
@@ -151,9 +153,6 @@ private:
 	uint16 _transparentColor[3];
 	bool _transparentColorSpecified;
 
-	byte *_compressedBuffer;
-	uint32 _compressedBufferSize;
-
 	Graphics::Surface *_unfilteredSurface;
 };
 
@@ -109,18 +109,23 @@ bool loadThumbnail(Common::SeekableReadStream &in, Graphics::Surface &to) {
 
 	to.create(header.width, header.height, sizeof(OverlayColor));
 
+	// Read all the pixel data at once, instead of each pixel separately
+	const uint32 pixelCount = to.w * to.h;
+	byte *data = new byte[pixelCount * 2];
+	in.read(data, pixelCount * 2);
+
 	OverlayColor *pixels = (OverlayColor *)to.pixels;
 	Graphics::PixelFormat format = g_system->getOverlayFormat();
-	for (int y = 0; y < to.h; ++y) {
-		for (int x = 0; x < to.w; ++x) {
-			uint8 r, g, b;
-			colorToRGB<ColorMasks<565> >(in.readUint16BE(), r, g, b);
-
-			// converting to current OSystem Color
-			*pixels++ = format.RGBToColor(r, g, b);
-		}
+	for (uint32 p = 0; p < pixelCount; ++p) {
+		uint8 r, g, b;
+		colorToRGB<ColorMasks<565> >(READ_BE_UINT16(data + p * 2), r, g, b);
+
+		// converting to current OSystem Color
+		*pixels++ = format.RGBToColor(r, g, b);
 	}
 
+	delete[] data;
+
 	return true;
 }
 
@@ -160,11 +165,17 @@ bool saveThumbnail(Common::WriteStream &out, const Graphics::Surface &thumb) {
 	out.writeByte(header.bpp);
 
 	// TODO: for later this shouldn't be casted to uint16...
-	uint16 *pixels = (uint16 *)thumb.pixels;
-	for (uint16 p = 0; p < thumb.w*thumb.h; ++p, ++pixels)
-		out.writeUint16BE(*pixels);
+	// The pixels are converted into one buffer, which is written at once
+	const uint32 pixelCount = thumb.w * thumb.h;
+	byte *data = new byte[pixelCount * 2];
+	const uint16 *pixels = (const uint16 *)thumb.pixels;
+	for (uint32 p = 0; p < pixelCount; ++p)
+		WRITE_BE_UINT16(data + p * 2, pixels[p]);
 
-	return true;
+	const bool success = (out.write(data, pixelCount * 2) == pixelCount * 2);
+	delete[] data;
+
+	return success;
 }
 
 } // End of namespace Graphics
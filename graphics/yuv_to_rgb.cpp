@@ -0,0 +1,177 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+// The table layout is the one of the YUV overlay code in SDL, which was
+// derived from the Berkeley mpeg_play sources, and used to live in the
+// MPEG player. See video/mpeg_player.cpp for the copyright notices of that
+// code. The coefficients are the ones of Graphics::YUV2RGB().
+
+#include "graphics/yuv_to_rgb.h"
+
+DECLARE_SINGLETON(Graphics::YUVToRGBManager);
+
+namespace Graphics {
+
+YUVToRGBLookup::YUVToRGBLookup(const PixelFormat &format) : _format(format) {
+	uint32 *r_2_pix = &_rgbToPix[0 * 768];
+	uint32 *g_2_pix = &_rgbToPix[1 * 768];
+	uint32 *b_2_pix = &_rgbToPix[2 * 768];
+
+	int16 *Cr_r_tab = &_colorTab[0 * 256];
+	int16 *Cr_g_tab = &_colorTab[1 * 256];
+	int16 *Cb_g_tab = &_colorTab[2 * 256];
+	int16 *Cb_b_tab = &_colorTab[3 * 256];
+
+	// The chroma offsets, which also select the component table
+	for (int i = 0; i < 256; i++) {
+		Cr_r_tab[i] =  ((1357 * (i - 128)) >> 10) + 0 * 768 + 256;
+		Cr_g_tab[i] = -(( 691 * (i - 128)) >> 10) + 1 * 768 + 256;
+		Cb_g_tab[i] = -(( 333 * (i - 128)) >> 10);
+		Cb_b_tab[i] =  ((1715 * (i - 128)) >> 10) + 2 * 768 + 256;
+	}
+
+	// The component values, clipped below 0 and above 255, so that
+	// no overflow checks are needed
+	for (int i = 0; i < 768; i++) {
+		const int c = CLIP(i - 256, 0, 255);
+		r_2_pix[i] = format.RGBToColor(c, 0, 0);
+		g_2_pix[i] = format.RGBToColor(0, c, 0);
+		b_2_pix[i] = format.RGBToColor(0, 0, c);
+	}
+}
+
+YUVToRGBManager::YUVToRGBManager() {
+}
+
+YUVToRGBManager::~YUVToRGBManager() {
+	for (Common::List<YUVToRGBLookup *>::iterator it = _lookups.begin(); it != _lookups.end(); ++it)
+		delete *it;
+}
+
+const YUVToRGBLookup *YUVToRGBManager::getLookup(const PixelFormat &format) {
+	Common::StackLock lock(_mutex);
+
+	for (Common::List<YUVToRGBLookup *>::iterator it = _lookups.begin(); it != _lookups.end(); ++it)
+		if ((*it)->getFormat() == format)
+			return *it;
+
+	YUVToRGBLookup *lookup = new YUVToRGBLookup(format);
+	_lookups.push_back(lookup);
+	return lookup;
+}
+
+void YUVToRGBManager::convert444(Surface *dst, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+                                 int yWidth, int yHeight, int yPitch, int uvPitch, int scale) {
+	convert(dst, format, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, 0, 0, scale);
+}
+
+void YUVToRGBManager::convert422(Surface *dst, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+                                 int yWidth, int yHeight, int yPitch, int uvPitch, int scale) {
+	convert(dst, format, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, 1, 0, scale);
+}
+
+void YUVToRGBManager::convert420(Surface *dst, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+                                 int yWidth, int yHeight, int yPitch, int uvPitch, int scale) {
+	convert(dst, format, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, 1, 1, scale);
+}
+
+/**
+ * Convert one line. With horizontally subsampled chroma, the chroma
+ * offsets are looked up once for both pixels sharing them.
+ */
+template<typename PixelInt, int kShiftX>
+static void convertLine(PixelInt *dst, const uint32 *rgbToPix, const int16 *colorTab, const byte *y, const byte *u, const byte *v, int width) {
+	const PixelInt *dstEnd = dst + width;
+
+	while (dst < dstEnd) {
+		const int16 cr_r  = colorTab[*v + 0 * 256];
+		const int16 crb_g = colorTab[*v + 1 * 256] + colorTab[*u + 2 * 256];
+		const int16 cb_b  = colorTab[*u + 3 * 256];
+		u++;
+		v++;
+
+		const uint32 *L = &rgbToPix[*y++];
+		*dst++ = L[cr_r] | L[crb_g] | L[cb_b];
+
+		if (kShiftX && dst < dstEnd) {
+			L = &rgbToPix[*y++];
+			*dst++ = L[cr_r] | L[crb_g] | L[cb_b];
+		}
+	}
+}
+
+template<typename PixelInt, int kShiftX>
+static void convertImage(Surface *dst, const uint32 *rgbToPix, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+                         int yWidth, int yHeight, int yPitch, int uvPitch, int uvShiftY, int scale) {
+	byte *dstRow = (byte *)dst->pixels;
+
+	for (int h = 0; h < yHeight; h++) {
+		const int uvOffset = (h >> uvShiftY) * uvPitch;
+		PixelInt *line = (PixelInt *)dstRow;
+
+		convertLine<PixelInt, kShiftX>(line, rgbToPix, colorTab, ySrc, uSrc + uvOffset, vSrc + uvOffset, yWidth);
+
+		if (scale > 1) {
+			// Widen the line in place, from right to left
+			for (int x = yWidth - 1; x >= 0; x--) {
+				const PixelInt color = line[x];
+				for (int i = 0; i < scale; i++)
+					line[x * scale + i] = color;
+			}
+
+			// And repeat it
+			for (int i = 1; i < scale; i++)
+				memcpy(dstRow + i * dst->pitch, dstRow, yWidth * scale * sizeof(PixelInt));
+		}
+
+		ySrc += yPitch;
+		dstRow += dst->pitch * scale;
+	}
+}
+
+void YUVToRGBManager::convert(Surface *dst, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+                              int yWidth, int yHeight, int yPitch, int uvPitch, int uvShiftX, int uvShiftY, int scale) {
+	assert(dst && dst->pixels);
+	assert(dst->bytesPerPixel == 2 || dst->bytesPerPixel == 4);
+	assert(dst->bytesPerPixel == format.bytesPerPixel);
+	assert(scale >= 1);
+	assert(dst->w >= yWidth * scale && dst->h >= yHeight * scale);
+
+	const YUVToRGBLookup *lookup = getLookup(format);
+
+	if (dst->bytesPerPixel == 2) {
+		if (uvShiftX)
+			convertImage<uint16, 1>(dst, lookup->_rgbToPix, lookup->_colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, uvShiftY, scale);
+		else
+			convertImage<uint16, 0>(dst, lookup->_rgbToPix, lookup->_colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, uvShiftY, scale);
+	} else {
+		if (uvShiftX)
+			convertImage<uint32, 1>(dst, lookup->_rgbToPix, lookup->_colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, uvShiftY, scale);
+		else
+			convertImage<uint32, 0>(dst, lookup->_rgbToPix, lookup->_colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, uvShiftY, scale);
+	}
+}
+
+} // End of namespace Graphics
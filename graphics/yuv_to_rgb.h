@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+/*
+ * YUV to RGB conversion used in engines:
+ *  - groovie
+ *  - sword25
+ * and in the JPEG decoder and several video codecs.
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_H
+#define GRAPHICS_YUV_TO_RGB_H
+
+#include "common/scummsys.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+
+namespace Graphics {
+
+/**
+ * Lookup tables converting YUV colors into one pixel format. The results
+ * are identical to converting with YUV2RGB() and PixelFormat::RGBToColor().
+ *
+ * The tables are owned by the YUVToRGBManager, which creates them.
+ */
+class YUVToRGBLookup {
+public:
+	/** Convert a single YUV color into a pixel of the lookup's format. */
+	inline uint32 convert(byte y, byte u, byte v) const {
+		const uint32 *l = &_rgbToPix[y];
+		return l[_colorTab[v + 0 * 256]] | l[_colorTab[v + 1 * 256] + _colorTab[u + 2 * 256]] | l[_colorTab[u + 3 * 256]];
+	}
+
+	const PixelFormat &getFormat() const { return _format; }
+
+private:
+	friend class YUVToRGBManager;
+	YUVToRGBLookup(const PixelFormat &format);
+
+	PixelFormat _format;
+
+	// The red, green and blue components of each intensity, clipped
+	// outside of 0-255. Indexed by the luminance plus the chroma offsets
+	// from _colorTab, which already point at the right component.
+	uint32 _rgbToPix[3 * 768];
+
+	// Cr->R, Cr->G, Cb->G and Cb->B offsets, 256 entries each
+	int16 _colorTab[4 * 256];
+};
+
+class YUVToRGBManager : public Common::Singleton<YUVToRGBManager> {
+public:
+	/**
+	 * Get the lookup tables for the given pixel format, creating them if
+	 * needed. The tables stay valid as long as the manager exists.
+	 */
+	const YUVToRGBLookup *getLookup(const PixelFormat &format);
+
+	/**
+	 * Convert a YUV image without chroma subsampling into a surface.
+	 *
+	 * @param dst      the surface to draw into, which has to be at least
+	 *                 (yWidth * scale) x (yHeight * scale) pixels large,
+	 *                 and use 2 or 4 bytes per pixel
+	 * @param format   the pixel format of the surface
+	 * @param ySrc     the luminance plane
+	 * @param uSrc     the Cb plane
+	 * @param vSrc     the Cr plane
+	 * @param yWidth   the width of the image
+	 * @param yHeight  the height of the image
+	 * @param yPitch   the pitch of the luminance plane
+	 * @param uvPitch  the pitch of both chroma planes
+	 * @param scale    each pixel is drawn as a scale x scale block
+	 */
+	void convert444(Surface *dst, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+	                int yWidth, int yHeight, int yPitch, int uvPitch, int scale = 1);
+
+	/**
+	 * Convert a YUV image with half horizontal chroma resolution into a
+	 * surface. The parameters are the same as for convert444().
+	 */
+	void convert422(Surface *dst, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+	                int yWidth, int yHeight, int yPitch, int uvPitch, int scale = 1);
+
+	/**
+	 * Convert a YUV image with half horizontal and vertical chroma
+	 * resolution into a surface. The parameters are the same as for
+	 * convert444().
+	 */
+	void convert420(Surface *dst, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+	                int yWidth, int yHeight, int yPitch, int uvPitch, int scale = 1);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	YUVToRGBManager();
+	~YUVToRGBManager();
+
+	void convert(Surface *dst, const PixelFormat &format, const byte *ySrc, const byte *uSrc, const byte *vSrc,
+	             int yWidth, int yHeight, int yPitch, int uvPitch, int uvShiftX, int uvShiftY, int scale);
+
+	Common::Mutex _mutex;
+	Common::List<YUVToRGBLookup *> _lookups;
+};
+
+} // End of namespace Graphics
+
+/** Shortcut for accessing the YUV to RGB manager. */
+#define YUVToRGBMan (Graphics::YUVToRGBManager::instance())
+
+#endif
@@ -28,6 +28,7 @@
 #include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/hashmap.h"
 #include "common/unzip.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
@@ -50,6 +51,9 @@ const char * const ThemeEngine::kImageLogo = "logo.bmp";
 const char * const ThemeEngine::kImageLogoSmall = "logo_small.bmp";
 const char * const ThemeEngine::kImageSearch = "search.bmp";
 
+/** Memory budget of the cache of rasterised widgets, in bytes */
+static const uint32 kWidgetCacheSize = 2 * 1024 * 1024;
+
 struct TextDrawData {
 	const Graphics::Font *_fontPtr;
 };
@@ -74,6 +78,9 @@ struct WidgetDrawData {
 
 	bool _buffer;
 
+	/** Whether the rasterised widget may be kept in the WidgetCache */
+	bool _cacheable;
+
 
 	/**
 	 * Calculates the background threshold offset of a given DrawData item.
@@ -83,6 +90,13 @@ struct WidgetDrawData {
 	 * value will be added when restoring the background of the widget.
 	 */
 	void calcBackgroundOffset();
+
+	/**
+	 * Checks whether all DrawSteps only draw inside the (extended) widget
+	 * area, so that the result can be stored in the WidgetCache.
+	 * Must be called after fully loading all DrawSteps of a DrawData item.
+	 */
+	void calcCacheable();
 };
 
 class ThemeItem {
@@ -144,6 +158,97 @@ protected:
 	bool _alpha;
 };
 
+/**
+ * Cache of rasterised DrawData items.
+ *
+ * Most DrawSteps blend with whatever is below them (shadows, bevels,
+ * alpha fills), so a rendition can only be reused on the same background.
+ * Widgets are therefore only cached when they get drawn right after their
+ * area was restored from the ThemeEngine backbuffer. Entries are keyed by
+ * the widget, its position and the generation of the backbuffer, which
+ * the ThemeEngine bumps whenever the backbuffer changes. A cache hit is
+ * then indistinguishable from actually rendering the DrawSteps, without
+ * looking at the background pixels at all.
+ *
+ * Entries are evicted in least recently used order once the cache grows
+ * beyond its memory budget. They reference the WidgetDrawData of the
+ * current theme and assume a fixed pixel format, so the whole cache must
+ * be flushed whenever the theme or the graphics mode changes.
+ */
+class WidgetCache {
+public:
+	WidgetCache(uint32 budget) : _budget(budget), _size(0) {}
+	~WidgetCache() { flush(); }
+
+	/**
+	 * Draws a previously cached rendition of a widget.
+	 *
+	 * @param data DrawData item of the widget.
+	 * @param dynamicData Dynamic data the widget is drawn with.
+	 * @param shadows Whether the renderer draws shadows.
+	 * @param backgroundGeneration Generation of the backbuffer the area was restored from.
+	 * @param surf Surface to draw on.
+	 * @param area Area affected by the widget, including its shadows.
+	 * @return true if the widget was found and drawn.
+	 */
+	bool draw(const WidgetDrawData *data, uint32 dynamicData, bool shadows, uint32 backgroundGeneration,
+	          Graphics::Surface *surf, const Common::Rect &area);
+
+	/**
+	 * Stores a rendered widget.
+	 *
+	 * @param surf Surface the widget was drawn on.
+	 * @see draw
+	 */
+	void store(const WidgetDrawData *data, uint32 dynamicData, bool shadows, uint32 backgroundGeneration,
+	           const Graphics::Surface *surf, const Common::Rect &area);
+
+	/** Checks whether a widget of the given area is worth caching. */
+	bool fits(const Common::Rect &area, int bytesPerPixel) const {
+		return (uint32)(area.width() * area.height() * bytesPerPixel) <= _budget / 8;
+	}
+
+	void flush();
+
+private:
+	struct Key {
+		const WidgetDrawData *data;
+		uint32 dynamicData;
+		uint32 backgroundGeneration;
+		Common::Rect area;
+		bool shadows;
+
+		bool operator==(const Key &k) const {
+			return data == k.data && dynamicData == k.dynamicData && backgroundGeneration == k.backgroundGeneration
+			    && area == k.area && shadows == k.shadows;
+		}
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &k) const {
+			return (uint)(size_t)k.data ^ (k.dynamicData * 31) ^ (k.backgroundGeneration * 17)
+			    ^ (k.area.left << 20) ^ (k.area.top << 10) ^ (k.area.right * 7) ^ (k.area.bottom * 13) ^ k.shadows;
+		}
+	};
+
+	struct Entry {
+		Key key;
+		Graphics::Surface pixels;
+	};
+
+	typedef Common::List<Entry *> EntryList;
+	typedef Common::HashMap<Key, EntryList::iterator, KeyHash> EntryMap;
+
+	Key makeKey(const WidgetDrawData *data, uint32 dynamicData, bool shadows, uint32 backgroundGeneration, const Common::Rect &area) const;
+	void remove(EntryMap::iterator i);
+
+	uint32 _budget;
+	uint32 _size;
+
+	EntryList _lru; ///< Most recently used entries first
+	EntryMap _entries;
+};
+
 
 
 /**********************************************************
@@ -222,9 +327,28 @@ void ThemeItemDrawData::drawSelf(bool draw, bool restore) {
 		_engine->restoreBackground(extendedRect);
 
 	if (draw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = _data->_steps.begin(); step != _data->_steps.end(); ++step)
-			_engine->renderer()->drawStep(_area, *step, _dynamicData);
+		Graphics::VectorRenderer *renderer = _engine->renderer();
+		Graphics::Surface *surf = renderer->getActiveSurface();
+		WidgetCache *cache = _engine->widgetCache();
+		const bool shadows = !renderer->shadowsDisabled();
+
+		const uint32 generation = _engine->backBufferGeneration();
+
+		// Only widgets drawn over the just restored backbuffer have a known
+		// background. Widgets partially outside the screen are clipped, so
+		// only whole widgets can be reused.
+		const bool useCache = cache && restore && _data->_cacheable
+		    && Common::Rect(surf->w, surf->h).contains(extendedRect)
+		    && cache->fits(extendedRect, surf->bytesPerPixel);
+
+		if (!useCache || !cache->draw(_data, _dynamicData, shadows, generation, surf, extendedRect)) {
+			Common::List<Graphics::DrawStep>::const_iterator step;
+			for (step = _data->_steps.begin(); step != _data->_steps.end(); ++step)
+				renderer->drawStep(_area, *step, _dynamicData);
+
+			if (useCache)
+				cache->store(_data, _dynamicData, shadows, generation, surf, extendedRect);
+		}
 	}
 
 	_engine->addDirtyRect(extendedRect);
@@ -258,17 +382,98 @@ void ThemeItemBitmap::drawSelf(bool draw, bool restore) {
 
 
 
+/**********************************************************
+ * WidgetCache functions
+ *********************************************************/
+WidgetCache::Key WidgetCache::makeKey(const WidgetDrawData *data, uint32 dynamicData, bool shadows, uint32 backgroundGeneration, const Common::Rect &area) const {
+	Key key;
+	key.data = data;
+	key.dynamicData = dynamicData;
+	key.backgroundGeneration = backgroundGeneration;
+	key.area = area;
+	key.shadows = shadows;
+	return key;
+}
+
+bool WidgetCache::draw(const WidgetDrawData *data, uint32 dynamicData, bool shadows, uint32 backgroundGeneration,
+                       Graphics::Surface *surf, const Common::Rect &area) {
+	EntryMap::iterator i = _entries.find(makeKey(data, dynamicData, shadows, backgroundGeneration, area));
+	if (i == _entries.end())
+		return false;
+
+	Entry *entry = *i->_value;
+
+	const int rowBytes = area.width() * surf->bytesPerPixel;
+	for (int y = 0; y < area.height(); ++y)
+		memcpy(surf->getBasePtr(area.left, area.top + y), entry->pixels.getBasePtr(0, y), rowBytes);
+
+	_lru.erase(i->_value);
+	_lru.push_front(entry);
+	i->_value = _lru.begin();
+
+	return true;
+}
+
+void WidgetCache::store(const WidgetDrawData *data, uint32 dynamicData, bool shadows, uint32 backgroundGeneration,
+                        const Graphics::Surface *surf, const Common::Rect &area) {
+	const Key key = makeKey(data, dynamicData, shadows, backgroundGeneration, area);
+
+	EntryMap::iterator i = _entries.find(key);
+	if (i != _entries.end())
+		remove(i);
+
+	Entry *entry = new Entry;
+	entry->key = key;
+	entry->pixels.create(area.width(), area.height(), surf->bytesPerPixel);
+
+	const int rowBytes = area.width() * surf->bytesPerPixel;
+	for (int y = 0; y < area.height(); ++y)
+		memcpy(entry->pixels.getBasePtr(0, y), surf->getBasePtr(area.left, area.top + y), rowBytes);
+
+	_lru.push_front(entry);
+	_entries[key] = _lru.begin();
+	_size += entry->pixels.pitch * entry->pixels.h;
+
+	while (_size > _budget && !_lru.empty())
+		remove(_entries.find(_lru.back()->key));
+}
+
+void WidgetCache::remove(EntryMap::iterator i) {
+	Entry *entry = *i->_value;
+
+	_size -= entry->pixels.pitch * entry->pixels.h;
+	_lru.erase(i->_value);
+	_entries.erase(i);
+
+	entry->pixels.free();
+	delete entry;
+}
+
+void WidgetCache::flush() {
+	for (EntryList::iterator i = _lru.begin(); i != _lru.end(); ++i) {
+		(*i)->pixels.free();
+		delete *i;
+	}
+
+	_lru.clear();
+	_entries.clear();
+	_size = 0;
+}
+
+
+
 /**********************************************************
  * ThemeEngine class
  *********************************************************/
 ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(0), _vectorRenderer(0),
 	_buffering(false), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
-	_font(0), _initOk(false), _themeOk(false), _enabled(false), _cursor(0) {
+	_font(0), _initOk(false), _themeOk(false), _enabled(false), _cursor(0), _backBufferGeneration(0) {
 
 	_system = g_system;
 	_parser = new ThemeParser(this);
 	_themeEval = new GUI::ThemeEval();
+	_widgetCache = new WidgetCache(kWidgetCacheSize);
 
 	_useCursor = false;
 
@@ -306,6 +511,7 @@ ThemeEngine::~ThemeEngine() {
 	_backBuffer.free();
 
 	unloadTheme();
+	delete _widgetCache;
 
 	// Release all graphics surfaces
 	for (ImagesMap::iterator i = _bitmaps.begin(); i != _bitmaps.end(); ++i) {
@@ -507,6 +713,10 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	delete _vectorRenderer;
 	_vectorRenderer = Graphics::createRenderer(mode);
 	_vectorRenderer->setSurface(&_screen);
+
+	// The cached widgets might have a different pixel format
+	_widgetCache->flush();
+	_backBufferGeneration++;
 }
 
 void WidgetDrawData::calcBackgroundOffset() {
@@ -523,6 +733,16 @@ void WidgetDrawData::calcBackgroundOffset() {
 	_backgroundOffset = maxShadow;
 }
 
+void WidgetDrawData::calcCacheable() {
+	_cacheable = !_steps.empty();
+	for (Common::List<Graphics::DrawStep>::const_iterator step = _steps.begin();
+	        step != _steps.end(); ++step) {
+		// Fills the whole surface instead of the widget area
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_FILLSURFACE)
+			_cacheable = false;
+	}
+}
+
 void ThemeEngine::restoreBackground(Common::Rect r) {
 	r.clip(_screen.w, _screen.h);
 	_vectorRenderer->blitSurface(&_backBuffer, r);
@@ -653,6 +873,7 @@ bool ThemeEngine::addDrawData(const Common::String &data, bool cached) {
 	_widgets[id] = new WidgetDrawData;
 	_widgets[id]->_buffer = kDrawDataDefaults[id].buffer;
 	_widgets[id]->_textDataId = kTextDataNone;
+	_widgets[id]->_cacheable = false;
 
 	return true;
 }
@@ -664,6 +885,9 @@ bool ThemeEngine::addDrawData(const Common::String &data, bool cached) {
 void ThemeEngine::loadTheme(const Common::String &themeId) {
 	unloadTheme();
 
+	// Cached widgets refer to the DrawData of the previous theme
+	_widgetCache->flush();
+
 	if (themeId == "builtin") {
 		_themeOk = loadDefaultXML();
 	} else {
@@ -681,6 +905,7 @@ void ThemeEngine::loadTheme(const Common::String &themeId) {
 			warning("Missing data asset: '%s'", kDrawDataDefaults[i].name);
 		} else {
 			_widgets[i]->calcBackgroundOffset();
+			_widgets[i]->calcCacheable();
 		}
 	}
 }
@@ -1205,6 +1430,7 @@ void ThemeEngine::updateScreen(bool render) {
 		_vectorRenderer->setSurface(&_screen);
 		memcpy(_screen.getBasePtr(0, 0), _backBuffer.getBasePtr(0, 0), _screen.pitch * _screen.h);
 		_bufferQueue.clear();
+		_backBufferGeneration++;
 	}
 
 	if (!_screenQueue.empty()) {
@@ -1272,6 +1498,7 @@ void ThemeEngine::openDialog(bool doBuffer, ShadingStyle style) {
 	}
 
 	memcpy(_backBuffer.getBasePtr(0, 0), _screen.getBasePtr(0, 0), _screen.pitch * _screen.h);
+	_backBufferGeneration++;
 	_vectorRenderer->setSurface(&_screen);
 }
 
@@ -51,6 +51,7 @@ class GuiObject;
 class ThemeEval;
 class ThemeItem;
 class ThemeParser;
+class WidgetCache;
 
 /**
  * DrawData sets enumeration.
@@ -461,6 +462,10 @@ public:
 
 	inline ThemeEval *getEvaluator() { return _themeEval; }
 	inline Graphics::VectorRenderer *renderer() { return _vectorRenderer; }
+	inline WidgetCache *widgetCache() { return _widgetCache; }
+
+	/** Changes whenever the contents of the backbuffer change */
+	inline uint32 backBufferGeneration() const { return _backBufferGeneration; }
 
 	inline bool supportsImages() const { return true; }
 	inline bool ownCursor() const { return _useCursor; }
@@ -602,6 +607,12 @@ protected:
 	/** Backbuffer surface. Stores previous states of the screen to blit back */
 	Graphics::Surface _backBuffer;
 
+	/** Already rasterised DrawData items, reused instead of rendering their DrawSteps again */
+	WidgetCache *_widgetCache;
+
+	/** See backBufferGeneration() */
+	uint32 _backBufferGeneration;
+
 	/** Sets whether the current drawing is being buffered (stored for later
 	    processing) or drawn directly to the screen. */
 	bool _buffering;
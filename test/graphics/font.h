@@ -0,0 +1,87 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/font.h"
+
+/*
+ * Two 4x4 glyphs: 'A' is a diagonal line, 'B' is filled.
+ */
+static const Graphics::bitmap_t font_test_bits[] = {
+	0x8000, 0x4000, 0x2000, 0x1000,
+	0xF000, 0xF000, 0xF000, 0xF000
+};
+
+static const Graphics::FontDesc font_test_desc = {
+	"test",         // name
+	4,              // maxwidth
+	4,              // height
+	4, 4, 0, 0,     // fbbw, fbbh, fbbx, fbby
+	4,              // ascent
+	'A',            // firstchar
+	2,              // size
+	font_test_bits, // bits
+	0,              // offset
+	0,              // width
+	0,              // bbx
+	'A',            // defaultchar
+	sizeof(font_test_bits) / sizeof(Graphics::bitmap_t) // bits_size
+};
+
+class FontTestSuite : public CxxTest::TestSuite
+{
+	private:
+	Graphics::Surface _surface;
+
+	int countPixels() {
+		int count = 0;
+		for (int y = 0; y < _surface.h; ++y)
+			for (int x = 0; x < _surface.w; ++x)
+				if (*(byte *)_surface.getBasePtr(x, y))
+					++count;
+		return count;
+	}
+
+	public:
+	void setUp() {
+		_surface.create(4, 4, 1);
+		memset(_surface.pixels, 0, _surface.pitch * _surface.h);
+	}
+
+	void tearDown() {
+		_surface.free();
+	}
+
+	void test_drawChar() {
+		Graphics::NewFont font(font_test_desc);
+
+		font.drawChar(&_surface, 'A', 0, 0, 1);
+		TS_ASSERT_EQUALS(countPixels(), 4);
+		for (int i = 0; i < 4; ++i)
+			TS_ASSERT_EQUALS(*(byte *)_surface.getBasePtr(i, i), 1);
+	}
+
+	void test_drawChar_clipped_top() {
+		Graphics::NewFont font(font_test_desc);
+
+		// Only the last two rows of the glyph are visible, at the top
+		font.drawChar(&_surface, 'A', 0, -2, 1);
+		TS_ASSERT_EQUALS(countPixels(), 2);
+		TS_ASSERT_EQUALS(*(byte *)_surface.getBasePtr(2, 0), 1);
+		TS_ASSERT_EQUALS(*(byte *)_surface.getBasePtr(3, 1), 1);
+
+		// Glyphs entirely above the surface draw nothing. 'B' is the last
+		// glyph, so skipping its rows must not read past the glyph data.
+		memset(_surface.pixels, 0, _surface.pitch * _surface.h);
+		font.drawChar(&_surface, 'B', 0, -4, 1);
+		font.drawChar(&_surface, 'B', 0, -100, 1);
+		TS_ASSERT_EQUALS(countPixels(), 0);
+	}
+
+	void test_drawChar_clipped_bottom() {
+		Graphics::NewFont font(font_test_desc);
+
+		font.drawChar(&_surface, 'B', 0, 3, 1);
+		TS_ASSERT_EQUALS(countPixels(), 4);
+		for (int i = 0; i < 4; ++i)
+			TS_ASSERT_EQUALS(*(byte *)_surface.getBasePtr(i, 3), 1);
+	}
+};
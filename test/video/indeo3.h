@@ -0,0 +1,166 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/endian.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+
+#include "backends/modular-backend.h"
+#include "graphics/yuv_to_rgb.h"
+#include "video/codecs/indeo3.h"
+
+/*
+ * Indeo 3 frames are built from a fixed pseudo-random sequence, so that
+ * no sample videos are needed. The digests were taken from the output of
+ * the decoder as it was before the block kernels were introduced, and
+ * make sure the output stays bit-exact.
+ */
+
+static const char *indeo3_test_digest[] = {
+	"05f904ded1c21738184225fe0556b9e9",
+	"e749bf42574946f0e719daf3dd61afae",
+	"5bf3d0246377fe601c1bcab629307974",
+	"5a25c56a9ab273030c259e6f3c23c73d",
+	"30e69b2bd4a153d351948a78c2a0dfc0",
+	"a6c2abb1d8f1e202233f01ed11f5591b",
+	"f78c08a1b4ac9bfc00c76057b217e72d",
+	"bfc7f2471b4c8fd5c04f7a1222b91149",
+	"772fcd68f7a2e142d030f7ea413a8cc7",
+	"59bf9d400fa0cd5952cb5403560f4a0f",
+	"3d6691beb580b52d6e6d4ff58aa631bc",
+	"3d6691beb580b52d6e6d4ff58aa631bc",
+	"0188557d074fdf28e96d2cf58fb3f6b1",
+	"5c93db52045269b256119a53c2bd2d1d",
+	"ec9ccb03925e43f5c4c876f1c1ca13f5",
+	"5ca6e465d3ce49bb37fd2fa0a4853f21"
+};
+
+/*
+ * The YUV to RGB manager needs mutexes, so provide a system without any
+ * real backend behind it.
+ */
+class Indeo3TestSystem : public ModularBackend {
+public:
+	MutexRef createMutex() { return 0; }
+	void lockMutex(MutexRef mutex) {}
+	void unlockMutex(MutexRef mutex) {}
+	void deleteMutex(MutexRef mutex) {}
+
+	uint32 getMillis() { return 0; }
+	void delayMillis(uint msecs) {}
+	void getTimeAndDate(TimeDate &t) const {}
+
+	Common::SeekableReadStream *createConfigReadStream() { return 0; }
+	Common::WriteStream *createConfigWriteStream() { return 0; }
+};
+
+class Indeo3TestSuite : public CxxTest::TestSuite {
+private:
+	Indeo3TestSystem *_system;
+
+	enum {
+		kFrameWidth  = 160,
+		kFrameHeight = 120,
+		kFrameSize   = 65536,
+		kFrameCount  = 16
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		// Own generator, rand() differs between platforms
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) & 0x7FFF;
+	}
+
+	void buildFrame(byte *data) {
+		static const uint32 planeOffsets[3] = { 1000, 30000, 45000 };
+
+		for (int i = 48; i < kFrameSize; i++)
+			data[i] = nextRandom();
+
+		// The four ids xor'd spell "FRMH", the last one is the frame length
+		WRITE_LE_UINT32(data +  0, 0x12345678);
+		WRITE_LE_UINT32(data +  4, 0);
+		WRITE_LE_UINT32(data +  8, MKID_BE('FRMH') ^ 0x12345678 ^ 1000);
+		WRITE_LE_UINT32(data + 12, 1000);
+
+		WRITE_LE_UINT16(data + 16, 0);
+		WRITE_LE_UINT16(data + 18, (nextRandom() & 1) ? 0x200 : 0); // Reference frame
+		WRITE_LE_UINT32(data + 20, 0);
+		data[24] = nextRandom() % 8;
+		data[25] = data[26] = data[27] = 0;
+		WRITE_LE_UINT16(data + 28, kFrameHeight);
+		WRITE_LE_UINT16(data + 30, kFrameWidth);
+		WRITE_LE_UINT32(data + 44, 0);
+
+		for (int p = 0; p < 3; p++) {
+			WRITE_LE_UINT32(data + 32 + p * 4, planeOffsets[p] - 16);
+
+			// 1024 bytes of correction vectors, followed by the bitstream
+			byte *plane = data + planeOffsets[p];
+			WRITE_LE_UINT32(plane, 512);
+
+			for (int i = 0; i < 1024; i++)
+				plane[4 + i] = (byte)((nextRandom() % 5) - 2);
+
+			// Make most codes terminate instead of splitting endlessly
+			for (int i = 0; i < 8000; i++)
+				if ((nextRandom() % 16) < 6)
+					plane[4 + 1024 + i] = 0xAA | (nextRandom() & 0x55 & nextRandom());
+		}
+	}
+
+	Common::String surfaceMD5(const Graphics::Surface *surface) {
+		// Hash the pixels as little endian, to get the same digest everywhere
+		const uint32 size = surface->w * surface->h * 2;
+		byte *pixels = (byte *)malloc(size);
+
+		for (int y = 0; y < surface->h; y++) {
+			const uint16 *src = (const uint16 *)surface->getBasePtr(0, y);
+			byte *dst = pixels + y * surface->w * 2;
+
+			for (int x = 0; x < surface->w; x++, dst += 2)
+				WRITE_LE_UINT16(dst, src[x]);
+		}
+
+		Common::MemoryReadStream stream(pixels, size, DisposeAfterUse::YES);
+		return Common::computeStreamMD5AsString(stream);
+	}
+
+public:
+	void setUp() {
+		_system = new Indeo3TestSystem();
+		g_system = _system;
+	}
+
+	void tearDown() {
+		Graphics::YUVToRGBManager::destroy();
+		g_system = 0;
+		delete _system;
+	}
+
+	void test_decodeImage() {
+		// Scale up by two, like the GK2 demo trailer
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		Video::Indeo3Decoder decoder(kFrameWidth * 2, kFrameHeight * 2, format);
+
+		byte *data = new byte[kFrameSize];
+		memset(data, 0, kFrameSize);
+		_seed = 1;
+
+		for (int i = 0; i < kFrameCount; i++) {
+			buildFrame(data);
+
+			Common::MemoryReadStream stream(data, kFrameSize);
+			const Graphics::Surface *surface = decoder.decodeImage(&stream);
+
+			TS_ASSERT(surface);
+			if (!surface)
+				break;
+
+			TS_ASSERT_EQUALS(surfaceMD5(surface), indeo3_test_digest[i]);
+		}
+
+		delete[] data;
+	}
+};
@@ -60,6 +60,16 @@ static uint16 getStreamType(uint32 tag) {
 	return tag & 0xffff;
 }
 
+static bool isVideoChunk(uint32 tag) {
+	const uint16 type = getStreamType(tag);
+	return type == 'dc' || type == 'id' || type == 'AM' || type == '32' || type == 'iv';
+}
+
+enum {
+	// How far the audio is queued ahead of the video, in milliseconds
+	kAudioLookAhead = 1000
+};
+
 AviDecoder::AviDecoder(Audio::Mixer *mixer, Audio::Mixer::SoundType soundType) : _mixer(mixer) {
 	_soundType = soundType;
 
@@ -69,7 +79,14 @@ AviDecoder::AviDecoder(Audio::Mixer *mixer, Audio::Mixer::SoundType soundType) :
 	_fileStream = NULL;
 	_audHandle = new Audio::SoundHandle();
 	_dirtyPalette = false;
+	_hasPaletteChanges = false;
+	_movieListStart = _movieListEnd = 0;
+	_lastIndexEntry = -1;
+	_curAudioChunk = 0;
+	_audioChunkSkip = 0;
+	_audioBytesQueued = 0;
 	memset(_palette, 0, sizeof(_palette));
+	memset(_initialPalette, 0, sizeof(_initialPalette));
 	memset(&_wvInfo, 0, sizeof(PCMWAVEFORMAT));
 	memset(&_bmInfo, 0, sizeof(BITMAPINFOHEADER));
 	memset(&_vidsHeader, 0, sizeof(AVIStreamHeader));
@@ -252,23 +269,35 @@ bool AviDecoder::loadStream(Common::SeekableReadStream *stream) {
 		nextTag = _fileStream->readUint32BE();
 	}
 
-	// Ignore the 'movi' LIST
+	// Remember where the 'movi' LIST is
 	if (nextTag == ID_LIST) {
-		_fileStream->readUint32BE(); // Skip size
+		uint32 listSize = _fileStream->readUint32LE();
 		if (_fileStream->readUint32BE() != ID_MOVI)
 			error ("Expected 'movi' LIST");
+
+		_movieListStart = _fileStream->pos();
+		_movieListEnd = _movieListStart + listSize - 4;
 	} else
 		error ("Expected 'movi' LIST");
 
+	// Locate all the chunks, so that they can be read in any order
+	if (!readIndex())
+		scanMovieList();
+
+	buildStreamIndex();
+	memcpy(_initialPalette, _palette, sizeof(_palette));
+
 	// Now, create the codec
 	_videoCodec = createCodec();
 
 	// Initialize the video stuff too
 	_audStream = createAudioStream();
-	if (_audStream)
+	if (_audStream) {
+		updateAudioBuffer();
 		_mixer->playStream(_soundType, _audHandle, _audStream);
+	}
 
-	debug (0, "Frames = %d, Dimensions = %d x %d", _header.totalFrames, _header.width, _header.height);
+	debug (0, "Frames = %d, Dimensions = %d x %d", getFrameCount(), _header.width, _header.height);
 	debug (0, "Frame Rate = %d", _vidsHeader.rate / _vidsHeader.scale);
 	if (_wvInfo.samplesPerSec != 0)
 		debug (0, "Sound Rate = %d", _wvInfo.samplesPerSec);
@@ -306,91 +335,219 @@ void AviDecoder::close() {
 	memset(&_audsHeader, 0, sizeof(AVIStreamHeader));
 	memset(&_ixInfo, 0, sizeof(AVIOLDINDEX));
 
+	_videoIndex.clear();
+	_audioIndex.clear();
+	_lastIndexEntry = -1;
+	_hasPaletteChanges = false;
+	_movieListStart = _movieListEnd = 0;
+
+	_curAudioChunk = 0;
+	_audioChunkSkip = 0;
+	_audioBytesQueued = 0;
+	_audioStartOffset = Audio::Timestamp();
+
 	reset();
 }
 
+bool AviDecoder::readIndex() {
+	// The 'idx1' chunk follows the 'movi' LIST
+	_fileStream->seek(_movieListEnd + (_movieListEnd & 1));
+	if (_fileStream->readUint32BE() != ID_IDX1 || _fileStream->eos())
+		return false;
+
+	runHandle(ID_IDX1);
+
+	const uint32 count = _ixInfo.size / 16;
+	bool valid = count != 0;
+
+	if (valid) {
+		// The offsets are relative to the 'movi' tag, or absolute in some files
+		const uint32 base = (_ixInfo.indices[0].offset < _movieListStart) ? _movieListStart - 4 : 0;
+		for (uint32 i = 0; i < count; i++)
+			_ixInfo.indices[i].offset += base;
+
+		// Make sure the index matches the file
+		_fileStream->seek(_ixInfo.indices[0].offset);
+		valid = _fileStream->readUint32BE() == _ixInfo.indices[0].id && !_fileStream->eos();
+	}
+
+	if (!valid) {
+		warning("Invalid AVI index, scanning the movie instead");
+		delete[] _ixInfo.indices;
+		memset(&_ixInfo, 0, sizeof(AVIOLDINDEX));
+	}
+
+	return valid;
+}
+
+void AviDecoder::scanMovieList() {
+	Common::Array<AVIOLDINDEX::Index> indices;
+	uint32 pos = _movieListStart;
+
+	while (pos + 8 <= _movieListEnd) {
+		_fileStream->seek(pos);
+
+		AVIOLDINDEX::Index index;
+		index.id = _fileStream->readUint32BE();
+		index.flags = 0;
+		index.offset = pos;
+		index.size = _fileStream->readUint32LE();
+
+		if (_fileStream->eos())
+			break;
+
+		if (index.id == ID_LIST) {
+			// Descend into the 'rec ' LISTs
+			pos += 12;
+			continue;
+		}
+
+		if (index.id != ID_JUNK)
+			indices.push_back(index);
+
+		pos += 8 + index.size + (index.size & 1); // Alignment
+	}
+
+	// Without key frame flags, only the first frame can be seeked to directly
+	_ixInfo.size = indices.size() * 16;
+	_ixInfo.indices = new AVIOLDINDEX::Index[indices.size()];
+	for (uint32 i = 0; i < indices.size(); i++)
+		_ixInfo.indices[i] = indices[i];
+}
+
+void AviDecoder::buildStreamIndex() {
+	_videoIndex.clear();
+	_audioIndex.clear();
+	_hasPaletteChanges = false;
+
+	for (uint32 i = 0; i < _ixInfo.size / 16; i++) {
+		const uint32 id = _ixInfo.indices[i].id;
+
+		if (isVideoChunk(id))
+			_videoIndex.push_back(i);
+		else if (getStreamType(id) == 'wb')
+			_audioIndex.push_back(i);
+		else if (getStreamType(id) == 'pc')
+			_hasPaletteChanges = true;
+	}
+
+	if (_videoIndex.size() != _header.totalFrames)
+		debug(0, "The AVI index has %d frames, the header %d", _videoIndex.size(), _header.totalFrames);
+}
+
 uint32 AviDecoder::getElapsedTime() const {
 	if (_audStream)
-		return _mixer->getSoundElapsedTime(*_audHandle);
+		return _mixer->getSoundElapsedTime(*_audHandle) + _audioStartOffset.msecs();
 
 	return FixedRateVideoDecoder::getElapsedTime();
 }
 
 const Graphics::Surface *AviDecoder::decodeNextFrame() {
-	uint32 nextTag = _fileStream->readUint32BE();
-
-	if (_fileStream->eos())
+	if (endOfVideo())
 		return NULL;
 
 	if (_curFrame == -1)
 		_startTime = g_system->getMillis();
 
-	if (nextTag == ID_LIST) {
-		// A list of audio/video chunks
-		uint32 listSize = _fileStream->readUint32LE() - 4;
-		int32 startPos = _fileStream->pos();
-
-		if (_fileStream->readUint32BE() != ID_REC)
-			error ("Expected 'rec ' LIST");
-
-		// Decode chunks in the list and see if we get a frame
-		const Graphics::Surface *frame = NULL;
-		while (_fileStream->pos() < startPos + (int32)listSize) {
-			const Graphics::Surface *temp = decodeNextFrame();
-			if (temp)
-				frame = temp;
-		}
+	_curFrame++;
+	updateAudioBuffer();
+
+	return decodeFrame(_curFrame);
+}
 
-		return frame;
-	} else if (getStreamType(nextTag) == 'wb') {
-		// Audio Chunk
-		uint32 chunkSize = _fileStream->readUint32LE();
-		queueAudioBuffer(chunkSize);
-		_fileStream->skip(chunkSize & 1); // Alignment
-	} else if (getStreamType(nextTag) == 'dc' || getStreamType(nextTag) == 'id' ||
-	           getStreamType(nextTag) == 'AM' || getStreamType(nextTag) == '32' ||
-			   getStreamType(nextTag) == 'iv') {
-		// Compressed Frame
-		_curFrame++;
-		uint32 chunkSize = _fileStream->readUint32LE();
-
-		if (chunkSize == 0) // Keep last frame on screen
-			return NULL;
-
-		Common::SeekableReadStream *frameData = _fileStream->readStream(chunkSize);
-		const Graphics::Surface *surface = _videoCodec->decodeImage(frameData);
-		delete frameData;
-		_fileStream->skip(chunkSize & 1); // Alignment
-		return surface;
-	} else if (getStreamType(nextTag) == 'pc') {
-		// Palette Change
-		_fileStream->readUint32LE(); // Chunk size, not needed here
-		byte firstEntry = _fileStream->readByte();
-		uint16 numEntries = _fileStream->readByte();
-		_fileStream->readUint16LE(); // Reserved
-
-		// 0 entries means all colors are going to be changed
-		if (numEntries == 0)
-			numEntries = 256;
-
-		for (uint16 i = firstEntry; i < numEntries + firstEntry; i++) {
-			_palette[i * 3] = _fileStream->readByte();
-			_palette[i * 3 + 1] = _fileStream->readByte();
-			_palette[i * 3 + 2] = _fileStream->readByte();
-			_fileStream->readByte(); // Flags that don't serve us any purpose
+const Graphics::Surface *AviDecoder::decodeFrame(uint32 frame) {
+	const uint32 entry = _videoIndex[frame];
+
+	// Apply the palette changes stored before the frame
+	if (_hasPaletteChanges) {
+		for (uint32 i = _lastIndexEntry + 1; i < entry; i++) {
+			if (getStreamType(_ixInfo.indices[i].id) == 'pc') {
+				_fileStream->seek(_ixInfo.indices[i].offset + 8);
+				handlePalChange();
+			}
 		}
+	}
+
+	_lastIndexEntry = entry;
+
+	const AVIOLDINDEX::Index &index = _ixInfo.indices[entry];
+
+	if (index.size == 0) // Keep last frame on screen
+		return NULL;
+
+	_fileStream->seek(index.offset + 8);
+	Common::SeekableReadStream *frameData = _fileStream->readStream(index.size);
+	const Graphics::Surface *surface = _videoCodec->decodeImage(frameData);
+	delete frameData;
+	return surface;
+}
+
+void AviDecoder::handlePalChange() {
+	byte firstEntry = _fileStream->readByte();
+	uint16 numEntries = _fileStream->readByte();
+	_fileStream->readUint16LE(); // Reserved
+
+	// 0 entries means all colors are going to be changed
+	if (numEntries == 0)
+		numEntries = 256;
+
+	for (uint16 i = firstEntry; i < numEntries + firstEntry; i++) {
+		_palette[i * 3] = _fileStream->readByte();
+		_palette[i * 3 + 1] = _fileStream->readByte();
+		_palette[i * 3 + 2] = _fileStream->readByte();
+		_fileStream->readByte(); // Flags that don't serve us any purpose
+	}
+
+	_dirtyPalette = true;
+}
+
+Audio::Timestamp AviDecoder::getFrameTime(uint32 frame) const {
+	return Audio::Timestamp(0, frame * _vidsHeader.scale, _vidsHeader.rate);
+}
+
+uint32 AviDecoder::findKeyFrame(uint32 frame) const {
+	while (frame > 0 && !(_ixInfo.indices[_videoIndex[frame]].flags & AVIIF_KEYFRAME))
+		frame--;
+
+	return frame;
+}
+
+void AviDecoder::seekToTime(Audio::Timestamp time) {
+	if (!isVideoLoaded() || getFrameCount() == 0)
+		return;
+
+	// The frame shown at that time
+	uint32 frame = time.convertToFramerate(_vidsHeader.rate).totalNumberOfFrames() / _vidsHeader.scale;
+	if (frame >= getFrameCount())
+		frame = getFrameCount() - 1;
 
+	// Decode from the key frame before it, unless we're already on the way
+	uint32 startFrame = findKeyFrame(frame);
+	if (_curFrame >= (int32)startFrame && _curFrame < (int32)frame)
+		startFrame = _curFrame + 1;
+
+	// Going back, the palette changes have to be applied again
+	if (_hasPaletteChanges && (int32)_videoIndex[startFrame] <= _lastIndexEntry) {
+		memcpy(_palette, _initialPalette, sizeof(_palette));
 		_dirtyPalette = true;
+		_lastIndexEntry = -1;
+	}
 
-		// No alignment necessary. It's always even.
-	} else if (nextTag == ID_JUNK) {
-		runHandle(ID_JUNK);
-	} else if (nextTag == ID_IDX1) {
-		runHandle(ID_IDX1);
-	} else
-		error("Tag = \'%s\', %d", tag2str(nextTag), _fileStream->pos());
+	for (uint32 i = startFrame; i < frame; i++)
+		decodeFrame(i);
 
-	return NULL;
+	_curFrame = (int32)frame - 1;
+
+	if (_audStream)
+		seekAudio(getFrameTime(frame));
+	else
+		_startTime = g_system->getMillis() - getFrameTime(frame).msecs();
+
+	resetPauseStartTime();
+}
+
+uint32 AviDecoder::getDuration() const {
+	return getFrameTime(getFrameCount()).msecs();
 }
 
 Codec *AviDecoder::createCodec() {
@@ -457,4 +614,70 @@ void AviDecoder::queueAudioBuffer(uint32 chunkSize) {
 	}
 }
 
+void AviDecoder::updateAudioBuffer() {
+	if (!_audStream)
+		return;
+
+	// Keep the audio a bit ahead of the next frame. With the last frame,
+	// queue what is left.
+	const bool lastFrame = _curFrame >= (int32)getFrameCount() - 1;
+	uint32 endByte = 0;
+	if (_wvInfo.avgBytesPerSec != 0)
+		endByte = getFrameTime(_curFrame + 1).addMsecs(kAudioLookAhead).convertToFramerate(_wvInfo.avgBytesPerSec).totalNumberOfFrames();
+
+	while (_curAudioChunk < _audioIndex.size()) {
+		if (!lastFrame && _wvInfo.avgBytesPerSec != 0 && _audioBytesQueued >= endByte)
+			break;
+
+		const AVIOLDINDEX::Index &index = _ixInfo.indices[_audioIndex[_curAudioChunk]];
+		const uint32 size = index.size - _audioChunkSkip;
+
+		_fileStream->seek(index.offset + 8 + _audioChunkSkip);
+		queueAudioBuffer(size);
+
+		_audioBytesQueued += size;
+		_audioChunkSkip = 0;
+		_curAudioChunk++;
+	}
+}
+
+void AviDecoder::seekAudio(const Audio::Timestamp &time) {
+	_mixer->stopHandle(*_audHandle);
+	_audStream = createAudioStream();
+
+	// Start with the block holding the audio at that time
+	uint32 startByte = 0;
+	if (_wvInfo.avgBytesPerSec != 0) {
+		startByte = time.convertToFramerate(_wvInfo.avgBytesPerSec).totalNumberOfFrames();
+		if (_wvInfo.blockAlign > 1)
+			startByte -= startByte % _wvInfo.blockAlign;
+	}
+
+	_curAudioChunk = 0;
+	_audioChunkSkip = 0;
+	_audioBytesQueued = 0;
+
+	while (_curAudioChunk < _audioIndex.size()) {
+		const uint32 chunkSize = _ixInfo.indices[_audioIndex[_curAudioChunk]].size;
+
+		if (_audioBytesQueued + chunkSize > startByte) {
+			_audioChunkSkip = startByte - _audioBytesQueued;
+			_audioBytesQueued = startByte;
+			break;
+		}
+
+		_audioBytesQueued += chunkSize;
+		_curAudioChunk++;
+	}
+
+	// The mixer counts the time from the start of the new stream
+	if (_wvInfo.avgBytesPerSec != 0)
+		_audioStartOffset = Audio::Timestamp(0, _audioBytesQueued, _wvInfo.avgBytesPerSec);
+	else
+		_audioStartOffset = Audio::Timestamp();
+
+	updateAudioBuffer();
+	_mixer->playStream(_soundType, _audHandle, _audStream);
+}
+
 } // End of namespace Video
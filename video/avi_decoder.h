@@ -26,6 +26,8 @@
 #ifndef VIDEO_AVI_PLAYER_H
 #define VIDEO_AVI_PLAYER_H
 
+#include "common/array.h"
+
 #include "video/video_decoder.h"
 #include "video/codecs/codec.h"
 #include "audio/audiostream.h"
@@ -110,7 +112,8 @@ struct AVIOLDINDEX {
 
 // Index Flags
 enum IndexFlags {
-	AVIIF_INDEX = 0x10
+	AVIIF_LIST = 0x01,
+	AVIIF_KEYFRAME = 0x10
 };
 
 // Audio Codecs
@@ -168,7 +171,7 @@ struct AVIStreamHeader {
  * Video decoder used in engines:
  *  - sci
  */
-class AviDecoder : public FixedRateVideoDecoder {
+class AviDecoder : public FixedRateVideoDecoder, public SeekableVideoDecoder {
 public:
 	AviDecoder(Audio::Mixer *mixer,
 			Audio::Mixer::SoundType soundType = Audio::Mixer::kPlainSoundType);
@@ -180,13 +183,17 @@ public:
 	bool isVideoLoaded() const { return _fileStream != 0; }
 	uint16 getWidth() const { return _header.width; }
 	uint16 getHeight() const { return _header.height; }
-	uint32 getFrameCount() const { return _header.totalFrames; }
+	uint32 getFrameCount() const { return _videoIndex.size(); }
 	uint32 getElapsedTime() const;
 	const Graphics::Surface *decodeNextFrame();
 	Graphics::PixelFormat getPixelFormat() const;
 	const byte *getPalette() { _dirtyPalette = false; return _palette; }
 	bool hasDirtyPalette() const { return _dirtyPalette; }
 
+	// SeekableVideoDecoder API
+	void seekToTime(Audio::Timestamp time);
+	uint32 getDuration() const;
+
 protected:
 	Common::Rational getFrameRate() const { return Common::Rational(_vidsHeader.rate, _vidsHeader.scale); }
 
@@ -199,7 +206,9 @@ private:
 	AVIStreamHeader _vidsHeader;
 	AVIStreamHeader _audsHeader;
 	byte _palette[3 * 256];
+	byte _initialPalette[3 * 256];
 	bool _dirtyPalette;
+	bool _hasPaletteChanges;
 
 	Common::SeekableReadStream *_fileStream;
 	bool _decodedHeader;
@@ -214,10 +223,35 @@ private:
 	void handleStreamHeader();
 	void handlePalChange();
 
+	// The chunks of the 'movi' LIST, as absolute offsets of their headers.
+	// Read from the 'idx1' chunk, or built by scanning the LIST without one.
+	uint32 _movieListStart;
+	uint32 _movieListEnd;
+	bool readIndex();
+	void scanMovieList();
+	void buildStreamIndex();
+
+	// Index entries of the video frames and audio chunks, in stream order
+	Common::Array<uint32> _videoIndex;
+	Common::Array<uint32> _audioIndex;
+	int32 _lastIndexEntry;
+
+	const Graphics::Surface *decodeFrame(uint32 frame);
+	Audio::Timestamp getFrameTime(uint32 frame) const;
+	uint32 findKeyFrame(uint32 frame) const;
+
 	Audio::SoundHandle *_audHandle;
 	Audio::QueuingAudioStream *_audStream;
 	Audio::QueuingAudioStream *createAudioStream();
 	void queueAudioBuffer(uint32 chunkSize);
+
+	// The audio is queued from the index, a bounded time ahead of the video
+	uint32 _curAudioChunk;
+	uint32 _audioChunkSkip;
+	uint32 _audioBytesQueued;
+	Audio::Timestamp _audioStartOffset;
+	void updateAudioBuffer();
+	void seekAudio(const Audio::Timestamp &time);
 };
 
 } // End of namespace Video
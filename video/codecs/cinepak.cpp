@@ -38,15 +38,29 @@ inline static void CPYUV2RGB(byte y, byte u, byte v, byte &r, byte &g, byte &b)
 	b = CLIP<int>(y + 2 * (u - 128), 0, 255);
 }
 
-#define PUT_PIXEL(offset, lum, u, v) \
-	if (_pixelFormat.bytesPerPixel != 1) { \
-		CPYUV2RGB(lum, u, v, r, g, b); \
-		if (_pixelFormat.bytesPerPixel == 2) \
-			*((uint16 *)_curFrame.surface->pixels + offset) = _pixelFormat.RGBToColor(r, g, b); \
-		else \
-			*((uint32 *)_curFrame.surface->pixels + offset) = _pixelFormat.RGBToColor(r, g, b); \
-	} else \
-		*((byte *)_curFrame.surface->pixels + offset) = lum
+// Draw a V1 block, where each pixel of the codebook covers 2x2 pixels.
+template<typename PixelInt>
+static inline void putV1Block(byte *dst, uint32 pitch, const CinepakCodebook &codebook) {
+	for (int i = 0; i < 4; i += 2) {
+		for (int row = 0; row < 2; row++, dst += pitch) {
+			PixelInt *line = (PixelInt *)dst;
+			line[0] = line[1] = codebook.pixels[i];
+			line[2] = line[3] = codebook.pixels[i + 1];
+		}
+	}
+}
+
+// Draw one quarter of a V4 block, where each codebook covers 2x2 pixels.
+template<typename PixelInt>
+static inline void putV4Quarter(byte *dst, uint32 pitch, const CinepakCodebook &codebook) {
+	PixelInt *line = (PixelInt *)dst;
+	line[0] = codebook.pixels[0];
+	line[1] = codebook.pixels[1];
+
+	line = (PixelInt *)(dst + pitch);
+	line[0] = codebook.pixels[2];
+	line[1] = codebook.pixels[3];
+}
 
 CinepakDecoder::CinepakDecoder(int bitsPerPixel) : Codec() {
 	_curFrame.surface = NULL;
@@ -180,36 +194,46 @@ void CinepakDecoder::loadCodebook(Common::SeekableReadStream *stream, uint16 str
 			if ((stream->pos() - startPos + n) > (int32)chunkSize)
 				break;
 
+			byte y[4];
 			for (byte j = 0; j < 4; j++)
-				codebook[i].y[j] = stream->readByte();
+				y[j] = stream->readByte();
+
+			// This codebook type indicates either greyscale or
+			// palettized video. For greyscale, default us to
+			// 128 for both u and v.
+			byte u = 128, v = 128;
 
 			if (n == 6) {
-				codebook[i].u  = stream->readByte() + 128;
-				codebook[i].v  = stream->readByte() + 128;
-			} else {
-				// This codebook type indicates either greyscale or
-				// palettized video. For greyscale, default us to
-				// 128 for both u and v.
-				codebook[i].u  = 128;
-				codebook[i].v  = 128;
+				u = stream->readByte() + 128;
+				v = stream->readByte() + 128;
 			}
+
+			for (byte j = 0; j < 4; j++)
+				codebook[i].pixels[j] = convertColor(y[j], u, v);
 		}
 	}
 }
 
+uint32 CinepakDecoder::convertColor(byte y, byte u, byte v) const {
+	// Palettized video just uses the luminance as the color index
+	if (_pixelFormat.bytesPerPixel == 1)
+		return y;
+
+	byte r, g, b;
+	CPYUV2RGB(y, u, v, r, g, b);
+	return _pixelFormat.RGBToColor(r, g, b);
+}
+
 void CinepakDecoder::decodeVectors(Common::SeekableReadStream *stream, uint16 strip, byte chunkID, uint32 chunkSize) {
 	uint32 flag = 0, mask = 0;
-	uint32 iy[4];
 	int32 startPos = stream->pos();
-	byte r = 0, g = 0, b = 0;
+	const uint32 pitch = _curFrame.surface->pitch;
+	const byte bytesPerPixel = _pixelFormat.bytesPerPixel;
 
 	for (uint16 y = _curFrame.strips[strip].rect.top; y < _curFrame.strips[strip].rect.bottom; y += 4) {
-		iy[0] = _curFrame.strips[strip].rect.left + y * _curFrame.width;
-		iy[1] = iy[0] + _curFrame.width;
-		iy[2] = iy[1] + _curFrame.width;
-		iy[3] = iy[2] + _curFrame.width;
+		byte *dst = (byte *)_curFrame.surface->getBasePtr(_curFrame.strips[strip].rect.left, y);
 
-		for (uint16 x = _curFrame.strips[strip].rect.left; x < _curFrame.strips[strip].rect.right; x += 4) {
+		for (uint16 x = _curFrame.strips[strip].rect.left; x < _curFrame.strips[strip].rect.right; x += 4, dst += 4 * bytesPerPixel) {
 			if ((chunkID & 0x01) && !(mask >>= 1)) {
 				if ((stream->pos() - startPos + 4) > (int32)chunkSize)
 					return;
@@ -232,59 +256,31 @@ void CinepakDecoder::decodeVectors(Common::SeekableReadStream *stream, uint16 st
 						return;
 
 					// Get the codebook
-					CinepakCodebook codebook = _curFrame.strips[strip].v1_codebook[stream->readByte()];
-
-					PUT_PIXEL(iy[0] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 1, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 1, codebook.y[0], codebook.u, codebook.v);
-
-					PUT_PIXEL(iy[0] + 2, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 2, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 3, codebook.y[1], codebook.u, codebook.v);
-
-					PUT_PIXEL(iy[2] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 1, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 1, codebook.y[2], codebook.u, codebook.v);
-
-					PUT_PIXEL(iy[2] + 2, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 3, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 2, codebook.y[3], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 3, codebook.y[3], codebook.u, codebook.v);
+					const CinepakCodebook &codebook = _curFrame.strips[strip].v1_codebook[stream->readByte()];
+
+					if (bytesPerPixel == 1)
+						putV1Block<byte>(dst, pitch, codebook);
+					else if (bytesPerPixel == 2)
+						putV1Block<uint16>(dst, pitch, codebook);
+					else
+						putV1Block<uint32>(dst, pitch, codebook);
 				} else if (flag & mask) {
 					if ((stream->pos() - startPos + 4) > (int32)chunkSize)
 						return;
 
-					CinepakCodebook codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[0] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 1, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 1, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[0] + 2, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[0] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 2, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[1] + 3, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[2] + 0, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 1, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 0, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 1, codebook.y[3], codebook.u, codebook.v);
-
-					codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
-					PUT_PIXEL(iy[2] + 2, codebook.y[0], codebook.u, codebook.v);
-					PUT_PIXEL(iy[2] + 3, codebook.y[1], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 2, codebook.y[2], codebook.u, codebook.v);
-					PUT_PIXEL(iy[3] + 3, codebook.y[3], codebook.u, codebook.v);
+					for (int i = 0; i < 4; i++) {
+						const CinepakCodebook &codebook = _curFrame.strips[strip].v4_codebook[stream->readByte()];
+						byte *quarter = dst + (i >> 1) * 2 * pitch + (i & 1) * 2 * bytesPerPixel;
+
+						if (bytesPerPixel == 1)
+							putV4Quarter<byte>(quarter, pitch, codebook);
+						else if (bytesPerPixel == 2)
+							putV4Quarter<uint16>(quarter, pitch, codebook);
+						else
+							putV4Quarter<uint32>(quarter, pitch, codebook);
+					}
 				}
 			}
-
-			for (byte i = 0; i < 4; i++)
-				iy[i] += 4;
 		}
 	}
 }
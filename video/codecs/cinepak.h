@@ -36,9 +36,10 @@
 
 namespace Video {
 
+// The codebook entries are converted to the output format when they are
+// loaded, as they are usually drawn many times.
 struct CinepakCodebook {
-	byte y[4];
-	byte u, v;
+	uint32 pixels[4];
 };
 
 struct CinepakStrip {
@@ -73,6 +74,7 @@ private:
 	Graphics::PixelFormat _pixelFormat;
 
 	void loadCodebook(Common::SeekableReadStream *stream, uint16 strip, byte codebookType, byte chunkID, uint32 chunkSize);
+	uint32 convertColor(byte y, byte u, byte v) const;
 	void decodeVectors(Common::SeekableReadStream *stream, uint16 strip, byte chunkID, uint32 chunkSize);
 };
 
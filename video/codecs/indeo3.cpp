@@ -38,18 +38,28 @@
 #include "common/frac.h"
 #include "common/file.h"
 
-#include "graphics/conversion.h"
+#include "graphics/yuv_to_rgb.h"
 
 #include "video/codecs/indeo3.h"
 
 namespace Video {
 
 Indeo3Decoder::Indeo3Decoder(uint16 width, uint16 height) : _ModPred(0), _corrector_type(0) {
+	_pixelFormat = g_system->getScreenFormat();
+
+	init(width, height);
+}
+
+Indeo3Decoder::Indeo3Decoder(uint16 width, uint16 height, const Graphics::PixelFormat &format) :
+	_pixelFormat(format), _ModPred(0), _corrector_type(0) {
+
+	init(width, height);
+}
+
+void Indeo3Decoder::init(uint16 width, uint16 height) {
 	_iv_frame[0].the_buf = 0;
 	_iv_frame[1].the_buf = 0;
 
-	_pixelFormat = g_system->getScreenFormat();
-
 	_surface = new Graphics::Surface;
 	_surface->create(width, height, _pixelFormat.bytesPerPixel);
 
@@ -265,7 +275,12 @@ const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *
 
 	delete[] inData;
 
-	// Blit the frame onto the surface
+	outputFrame(fWidth, fHeight, chromaWidth);
+
+	return _surface;
+}
+
+void Indeo3Decoder::outputFrame(uint32 fWidth, uint32 fHeight, uint32 chromaWidth) {
 	const byte *srcY = _cur_frame->Ybuf;
 	const byte *srcU = _cur_frame->Ubuf;
 	const byte *srcV = _cur_frame->Vbuf;
@@ -276,63 +291,65 @@ const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *
 	const byte *srcUN = srcU + chromaWidth;
 	const byte *srcVN = srcV + chromaWidth;
 
-	uint32 scaleWidth  = _surface->w / fWidth;
-	uint32 scaleHeight = _surface->h / fHeight;
+	const uint32 scaleWidth  = _surface->w / fWidth;
+	const uint32 scaleHeight = _surface->h / fHeight;
+	const byte bytesPerPixel = _surface->bytesPerPixel;
+
+	const Graphics::YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(_pixelFormat);
 
 	for (uint32 y = 0; y < fHeight; y++) {
+		// The chroma of the outer pixels of each 4x4 block is averaged with
+		// the one of the neighbouring block. Vertically, the first and last
+		// lines use the block line above and below.
+		const byte *nearU = srcU;
+		const byte *nearV = srcV;
+
+		if ((y & 3) == 0) {
+			nearU = srcUP;
+			nearV = srcVP;
+		} else if ((y & 3) == 3) {
+			nearU = srcUN;
+			nearV = srcVN;
+		}
+
 		byte *rowDest = dest;
 
-		for (uint32 sH = 0; sH < scaleHeight; sH++) {
-			for (uint32 x = 0; x < fWidth; x++) {
-				uint32 xP = MAX<int32>((x >> 2) - 1, 0);
-				uint32 xN = MIN<int32>((x >> 2) + 1, chromaWidth - 1);
-
-				byte cY = srcY[x];
-				byte cU = srcU[x >> 2];
-				byte cV = srcV[x >> 2];
-
-				if        (((x % 4) == 0) && ((y % 4) == 0)) {
-					cU = (((uint32) cU) + ((uint32) srcUP[xP])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVP[xP])) / 2;
-				} else if (((x % 4) == 3) && ((y % 4) == 0)) {
-					cU = (((uint32) cU) + ((uint32) srcUP[xN])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVP[xN])) / 2;
-				} else if (((x % 4) == 0) && ((y % 4) == 3)) {
-					cU = (((uint32) cU) + ((uint32) srcUN[xP])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVN[xP])) / 2;
-				} else if (((x % 4) == 3) && ((y % 4) == 3)) {
-					cU = (((uint32) cU) + ((uint32) srcUN[xN])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVN[xN])) / 2;
-				} else if ( (x % 4) == 0) {
-					cU = (((uint32) cU) + ((uint32) srcU[xP])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcV[xP])) / 2;
-				} else if ( (x % 4) == 3) {
-					cU = (((uint32) cU) + ((uint32) srcU[xN])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcV[xN])) / 2;
-				} else if ( (y % 4) == 0) {
-					cU = (((uint32) cU) + ((uint32) srcUP[x >> 2])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVP[x >> 2])) / 2;
-				} else if ( (y % 4) == 3) {
-					cU = (((uint32) cU) + ((uint32) srcUN[x >> 2])) / 2;
-					cV = (((uint32) cV) + ((uint32) srcVN[x >> 2])) / 2;
-				}
+		for (uint32 x = 0; x < fWidth; x += 4) {
+			const uint32 c  = x >> 2;
+			const uint32 cP = (c > 0) ? c - 1 : 0;
+			const uint32 cN = MIN<uint32>(c + 1, chromaWidth - 1);
 
-				byte r = 0, g = 0, b = 0;
-				Graphics::YUV2RGB(cY, cU, cV, r, g, b);
+			byte cU[4], cV[4];
 
-				const uint32 color = _pixelFormat.RGBToColor(r, g, b);
+			cU[0] = (srcU[c] + nearU[cP]) / 2;
+			cV[0] = (srcV[c] + nearV[cP]) / 2;
+			cU[1] = cU[2] = (srcU[c] + nearU[c]) / 2;
+			cV[1] = cV[2] = (srcV[c] + nearV[c]) / 2;
+			cU[3] = (srcU[c] + nearU[cN]) / 2;
+			cV[3] = (srcV[c] + nearV[cN]) / 2;
 
-				for (uint32 sW = 0; sW < scaleWidth; sW++, rowDest += _surface->bytesPerPixel) {
-					if      (_surface->bytesPerPixel == 1)
-						*((uint8 *)rowDest) = (uint8)color;
-					else if (_surface->bytesPerPixel == 2)
-						*((uint16 *)rowDest) = (uint16)color;
+			const uint32 count = MIN<uint32>(4, fWidth - x);
+
+			for (uint32 i = 0; i < count; i++) {
+				const uint32 color = lookup->convert(srcY[x + i], cU[i], cV[i]);
+
+				if (bytesPerPixel == 2) {
+					for (uint32 sW = 0; sW < scaleWidth; sW++)
+						((uint16 *)rowDest)[sW] = (uint16)color;
+				} else if (bytesPerPixel == 1) {
+					for (uint32 sW = 0; sW < scaleWidth; sW++)
+						rowDest[sW] = (uint8)color;
 				}
-			}
 
-			dest += _surface->pitch;
+				rowDest += scaleWidth * bytesPerPixel;
+			}
 		}
 
+		// Scaled up lines are identical
+		for (uint32 sH = 1; sH < scaleHeight; sH++)
+			memcpy(dest + sH * _surface->pitch, dest, fWidth * scaleWidth * bytesPerPixel);
+
+		dest += scaleHeight * _surface->pitch;
 		srcY += fWidth;
 
 		if ((y & 3) == 3) {
@@ -349,8 +366,6 @@ const Graphics::Surface *Indeo3Decoder::decodeImage(Common::SeekableReadStream *
 			}
 		}
 	}
-
-	return _surface;
 }
 
 typedef struct {
@@ -407,6 +422,46 @@ typedef struct {
 	}                     \
 	lp2 = 4;
 
+/* ---------------------------------------------------------------------- */
+
+// Block kernels. Each uint32 holds four pixels, and blocks are one (4 pixels)
+// or two (8 pixels) words wide. The pitch is given in words.
+
+static inline void copyBlock(uint32 *dst, const uint32 *src, int rows, int pitch) {
+	for (; rows > 0; rows--, dst += pitch, src += pitch)
+		*dst = *src;
+}
+
+static inline void copyBlock2(uint32 *dst, const uint32 *src, int rows, int pitch) {
+	for (; rows > 0; rows--, dst += pitch, src += pitch) {
+		dst[0] = src[0];
+		dst[1] = src[1];
+	}
+}
+
+static inline void fillBlock(uint32 *dst, uint32 value, int rows, int pitch) {
+	for (; rows > 0; rows--, dst += pitch)
+		*dst = value;
+}
+
+static inline void fillBlock2(uint32 *dst, uint32 value1, uint32 value2, int rows, int pitch) {
+	for (; rows > 0; rows--, dst += pitch) {
+		dst[0] = value1;
+		dst[1] = value2;
+	}
+}
+
+// Add a correction delta to four pixels at once. The pixels only use their
+// upper 7 bits, so the halved values can't carry into their neighbours.
+static inline uint32 applyCorrection(uint32 pixels, uint32 delta) {
+	return FROM_LE_32(((FROM_LE_32(pixels) >> 1) + delta) << 1);
+}
+
+// Average four pixels with four others
+static inline uint32 averagePixels(uint32 pixels1, uint32 pixels2) {
+	return ((pixels1 >> 1) + (pixels2 >> 1)) & 0xFEFEFEFE;
+}
+
 void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 		const byte *buf1, uint32 fflags2, const byte *hdr,
 		const byte *buf2, int min_width_160) {
@@ -512,8 +567,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 
 			if (cmd == 0 || ref_vectors != NULL) {
 				for (lp1 = 0; lp1 < blks_width; lp1++) {
-					for (i = 0, j = 0; i < blks_height; i++, j += width_tbl[1])
-						((uint32 *)cur_frm_pos)[j] = ((uint32 *)ref_frm_pos)[j];
+					copyBlock((uint32 *)cur_frm_pos, (uint32 *)ref_frm_pos, blks_height, width_tbl[1]);
 					cur_frm_pos += 4;
 					ref_frm_pos += 4;
 				}
@@ -560,7 +614,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 
 								switch (correction_type_sp[0][k]) {
 									case 0:
-										*cur_lp = FROM_LE_32(((FROM_LE_32(*ref_lp) >> 1) + correction_lp[lp2 & 0x01][k]) << 1);
+										*cur_lp = applyCorrection(*ref_lp, correction_lp[lp2 & 0x01][k]);
 										lp2++;
 										break;
 									case 1:
@@ -583,15 +637,13 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 										break;
 									case 2:
 										if (lp2 == 0) {
-											for (i = 0, j = 0; i < 2; i++, j += width_tbl[1])
-												cur_lp[j] = ref_lp[j];
+											copyBlock(cur_lp, ref_lp, 2, width_tbl[1]);
 											lp2 += 2;
 										}
 										break;
 									case 3:
 										if (lp2 < 2) {
-											for (i = 0, j = 0; i < (3 - lp2); i++, j += width_tbl[1])
-												cur_lp[j] = ref_lp[j];
+											copyBlock(cur_lp, ref_lp, (3 - lp2), width_tbl[1]);
 											lp2 = 3;
 										}
 										break;
@@ -600,8 +652,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 											RLE_V3_CHECK(buf1,rle_v1,rle_v2,rle_v3)
 
 											if (rle_v1 == 1 || ref_vectors != NULL) {
-												for (i = 0, j = 0; i < 4; i++, j += width_tbl[1])
-													cur_lp[j] = ref_lp[j];
+												copyBlock(cur_lp, ref_lp, 4, width_tbl[1]);
 											}
 
 											RLE_V2_CHECK(buf1,rle_v2, rle_v3,lp2)
@@ -613,8 +664,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 									case 5:
 											LP2_CHECK(buf1,rle_v3,lp2)
 									case 4:
-										for (i = 0, j = 0; i < (4 - lp2); i++, j += width_tbl[1])
-											cur_lp[j] = ref_lp[j];
+										copyBlock(cur_lp, ref_lp, (4 - lp2), width_tbl[1]);
 										lp2 = 4;
 										break;
 
@@ -633,8 +683,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 											return;
 										}
 										if (ref_vectors != NULL) {
-											for (i = 0, j = 0; i < 4; i++, j += width_tbl[1])
-												cur_lp[j] = ref_lp[j];
+											copyBlock(cur_lp, ref_lp, 4, width_tbl[1]);
 										}
 										lp2 = 4;
 										break;
@@ -644,8 +693,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 										lv = (lv1 & 0x7F) << 1;
 										lv += (lv << 8);
 										lv += (lv << 16);
-										for (i = 0, j = 0; i < 4; i++, j += width_tbl[1])
-											cur_lp[j] = lv;
+										fillBlock(cur_lp, lv, 4, width_tbl[1]);
 
 										LV1_CHECK(buf1,rle_v3,lv1,lp2)
 										break;
@@ -679,11 +727,11 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 
 								switch (correction_type_sp[lp2 & 0x01][k]) {
 									case 0:
-										cur_lp[width_tbl[1]] = FROM_LE_32(((FROM_LE_32(*ref_lp) >> 1) + correction_lp[lp2 & 0x01][k]) << 1);
+										cur_lp[width_tbl[1]] = applyCorrection(*ref_lp, correction_lp[lp2 & 0x01][k]);
 										if (lp2 > 0 || flag1 == 0 || strip->ypos != 0)
-											cur_lp[0] = ((cur_lp[-width_tbl[1]] >> 1) + (cur_lp[width_tbl[1]] >> 1)) & 0xFEFEFEFE;
+											cur_lp[0] = averagePixels(cur_lp[-width_tbl[1]], cur_lp[width_tbl[1]]);
 										else
-											cur_lp[0] = FROM_LE_32(((FROM_LE_32(*ref_lp) >> 1) + correction_lp[lp2 & 0x01][k]) << 1);
+											cur_lp[0] = applyCorrection(*ref_lp, correction_lp[lp2 & 0x01][k]);
 										lp2++;
 										break;
 
@@ -694,7 +742,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 										((uint16 *)cur_lp)[width_tbl[2]+1] = FROM_LE_16(res);
 
 										if (lp2 > 0 || flag1 == 0 || strip->ypos != 0)
-											cur_lp[0] = ((cur_lp[-width_tbl[1]] >> 1) + (cur_lp[width_tbl[1]] >> 1)) & 0xFEFEFEFE;
+											cur_lp[0] = averagePixels(cur_lp[-width_tbl[1]], cur_lp[width_tbl[1]]);
 										else
 											cur_lp[0] = cur_lp[width_tbl[1]];
 										buf1++;
@@ -703,16 +751,14 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 
 									case 2:
 										if (lp2 == 0) {
-											for (i = 0, j = 0; i < 4; i++, j += width_tbl[1])
-												cur_lp[j] = *ref_lp;
+											fillBlock(cur_lp, *ref_lp, 4, width_tbl[1]);
 											lp2 += 2;
 										}
 										break;
 
 									case 3:
 										if (lp2 < 2) {
-											for (i = 0, j = 0; i < 6 - (lp2 * 2); i++, j += width_tbl[1])
-												cur_lp[j] = *ref_lp;
+											fillBlock(cur_lp, *ref_lp, 6 - (lp2 * 2), width_tbl[1]);
 											lp2 = 3;
 										}
 										break;
@@ -736,8 +782,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 											RLE_V3_CHECK(buf1,rle_v1,rle_v2,rle_v3)
 
 											if (rle_v1 == 1) {
-												for (i = 0, j = 0; i < 8; i++, j += width_tbl[1])
-													cur_lp[j] = ref_lp[j];
+												copyBlock(cur_lp, ref_lp, 8, width_tbl[1]);
 											}
 
 											RLE_V2_CHECK(buf1,rle_v2, rle_v3,lp2)
@@ -749,8 +794,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 									case 5:
 											LP2_CHECK(buf1,rle_v3,lp2)
 									case 4:
-										for (i = 0, j = 0; i < 8 - (lp2 * 2); i++, j += width_tbl[1])
-											cur_lp[j] = *ref_lp;
+										fillBlock(cur_lp, *ref_lp, 8 - (lp2 * 2), width_tbl[1]);
 										lp2 = 4;
 										break;
 
@@ -761,8 +805,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 										lv += (lv << 8);
 										lv += (lv << 16);
 
-										for (i = 0, j = 0; i < 4; i++, j += width_tbl[1])
-											cur_lp[j] = lv;
+										fillBlock(cur_lp, lv, 4, width_tbl[1]);
 
 										LV1_CHECK(buf1,rle_v3,lv1,lp2)
 										break;
@@ -808,11 +851,11 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 
 									switch (correction_type_sp[lp2 & 0x01][k]) {
 										case 0:
-											cur_lp[width_tbl[1]] = FROM_LE_32(((FROM_LE_32(lv1) >> 1) + correctionloworder_lp[lp2 & 0x01][k]) << 1);
-											cur_lp[width_tbl[1]+1] = FROM_LE_32(((FROM_LE_32(lv2) >> 1) + correctionhighorder_lp[lp2 & 0x01][k]) << 1);
+											cur_lp[width_tbl[1]] = applyCorrection(lv1, correctionloworder_lp[lp2 & 0x01][k]);
+											cur_lp[width_tbl[1]+1] = applyCorrection(lv2, correctionhighorder_lp[lp2 & 0x01][k]);
 											if (lp2 > 0 || strip->ypos != 0 || flag1 == 0) {
-												cur_lp[0] = ((cur_lp[-width_tbl[1]] >> 1) + (cur_lp[width_tbl[1]] >> 1)) & 0xFEFEFEFE;
-												cur_lp[1] = ((cur_lp[-width_tbl[1]+1] >> 1) + (cur_lp[width_tbl[1]+1] >> 1)) & 0xFEFEFEFE;
+												cur_lp[0] = averagePixels(cur_lp[-width_tbl[1]], cur_lp[width_tbl[1]]);
+												cur_lp[1] = averagePixels(cur_lp[-width_tbl[1]+1], cur_lp[width_tbl[1]+1]);
 											} else {
 												cur_lp[0] = cur_lp[width_tbl[1]];
 												cur_lp[1] = cur_lp[width_tbl[1]+1];
@@ -826,11 +869,11 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 												//warning("Glitch");
 												return;
 											}
-											cur_lp[width_tbl[1]] = FROM_LE_32(((FROM_LE_32(lv1) >> 1) + correctionloworder_lp[lp2 & 0x01][*buf1]) << 1);
-											cur_lp[width_tbl[1]+1] = FROM_LE_32(((FROM_LE_32(lv2) >> 1) + correctionloworder_lp[lp2 & 0x01][k]) << 1);
+											cur_lp[width_tbl[1]] = applyCorrection(lv1, correctionloworder_lp[lp2 & 0x01][*buf1]);
+											cur_lp[width_tbl[1]+1] = applyCorrection(lv2, correctionloworder_lp[lp2 & 0x01][k]);
 											if (lp2 > 0 || strip->ypos != 0 || flag1 == 0) {
-												cur_lp[0] = ((cur_lp[-width_tbl[1]] >> 1) + (cur_lp[width_tbl[1]] >> 1)) & 0xFEFEFEFE;
-												cur_lp[1] = ((cur_lp[-width_tbl[1]+1] >> 1) + (cur_lp[width_tbl[1]+1] >> 1)) & 0xFEFEFEFE;
+												cur_lp[0] = averagePixels(cur_lp[-width_tbl[1]], cur_lp[width_tbl[1]]);
+												cur_lp[1] = averagePixels(cur_lp[-width_tbl[1]+1], cur_lp[width_tbl[1]+1]);
 											} else {
 												cur_lp[0] = cur_lp[width_tbl[1]];
 												cur_lp[1] = cur_lp[width_tbl[1]+1];
@@ -842,17 +885,11 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 										case 2:
 											if (lp2 == 0) {
 												if (flag1 != 0) {
-													for (i = 0, j = width_tbl[1]; i < 3; i++, j += width_tbl[1]) {
-														cur_lp[j] = lv1;
-														cur_lp[j+1] = lv2;
-													}
-													cur_lp[0] = ((cur_lp[-width_tbl[1]] >> 1) + (cur_lp[width_tbl[1]] >> 1)) & 0xFEFEFEFE;
-													cur_lp[1] = ((cur_lp[-width_tbl[1]+1] >> 1) + (cur_lp[width_tbl[1]+1] >> 1)) & 0xFEFEFEFE;
+													fillBlock2(cur_lp + width_tbl[1], lv1, lv2, 3, width_tbl[1]);
+													cur_lp[0] = averagePixels(cur_lp[-width_tbl[1]], cur_lp[width_tbl[1]]);
+													cur_lp[1] = averagePixels(cur_lp[-width_tbl[1]+1], cur_lp[width_tbl[1]+1]);
 												} else {
-													for (i = 0, j = 0; i < 4; i++, j += width_tbl[1]) {
-														cur_lp[j] = lv1;
-														cur_lp[j+1] = lv2;
-													}
+													fillBlock2(cur_lp, lv1, lv2, 4, width_tbl[1]);
 												}
 												lp2 += 2;
 											}
@@ -861,17 +898,11 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 										case 3:
 											if (lp2 < 2) {
 												if (lp2 == 0 && flag1 != 0) {
-													for (i = 0, j = width_tbl[1]; i < 5; i++, j += width_tbl[1]) {
-														cur_lp[j] = lv1;
-														cur_lp[j+1] = lv2;
-													}
-													cur_lp[0] = ((cur_lp[-width_tbl[1]] >> 1) + (cur_lp[width_tbl[1]] >> 1)) & 0xFEFEFEFE;
-													cur_lp[1] = ((cur_lp[-width_tbl[1]+1] >> 1) + (cur_lp[width_tbl[1]+1] >> 1)) & 0xFEFEFEFE;
+													fillBlock2(cur_lp + width_tbl[1], lv1, lv2, 5, width_tbl[1]);
+													cur_lp[0] = averagePixels(cur_lp[-width_tbl[1]], cur_lp[width_tbl[1]]);
+													cur_lp[1] = averagePixels(cur_lp[-width_tbl[1]+1], cur_lp[width_tbl[1]+1]);
 												} else {
-													for (i = 0, j = 0; i < 6 - (lp2 * 2); i++, j += width_tbl[1]) {
-														cur_lp[j] = lv1;
-														cur_lp[j+1] = lv2;
-													}
+													fillBlock2(cur_lp, lv1, lv2, 6 - (lp2 * 2), width_tbl[1]);
 												}
 												lp2 = 3;
 											}
@@ -882,17 +913,11 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 												RLE_V3_CHECK(buf1,rle_v1,rle_v2,rle_v3)
 												if (rle_v1 == 1) {
 													if (flag1 != 0) {
-														for (i = 0, j = width_tbl[1]; i < 7; i++, j += width_tbl[1]) {
-															cur_lp[j] = lv1;
-															cur_lp[j+1] = lv2;
-														}
-														cur_lp[0] = ((cur_lp[-width_tbl[1]] >> 1) + (cur_lp[width_tbl[1]] >> 1)) & 0xFEFEFEFE;
-														cur_lp[1] = ((cur_lp[-width_tbl[1]+1] >> 1) + (cur_lp[width_tbl[1]+1] >> 1)) & 0xFEFEFEFE;
+														fillBlock2(cur_lp + width_tbl[1], lv1, lv2, 7, width_tbl[1]);
+														cur_lp[0] = averagePixels(cur_lp[-width_tbl[1]], cur_lp[width_tbl[1]]);
+														cur_lp[1] = averagePixels(cur_lp[-width_tbl[1]+1], cur_lp[width_tbl[1]+1]);
 													} else {
-														for (i = 0, j = 0; i < 8; i++, j += width_tbl[1]) {
-															cur_lp[j] = lv1;
-															cur_lp[j+1] = lv2;
-														}
+														fillBlock2(cur_lp, lv1, lv2, 8, width_tbl[1]);
 													}
 												}
 												RLE_V2_CHECK(buf1,rle_v2, rle_v3,lp2)
@@ -905,17 +930,11 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 												LP2_CHECK(buf1,rle_v3,lp2)
 										case 4:
 											if (lp2 == 0 && flag1 != 0) {
-												for (i = 0, j = width_tbl[1]; i < 7; i++, j += width_tbl[1]) {
-													cur_lp[j] = lv1;
-													cur_lp[j+1] = lv2;
-												}
-												cur_lp[0] = ((cur_lp[-width_tbl[1]] >> 1) + (cur_lp[width_tbl[1]] >> 1)) & 0xFEFEFEFE;
-												cur_lp[1] = ((cur_lp[-width_tbl[1]+1] >> 1) + (cur_lp[width_tbl[1]+1] >> 1)) & 0xFEFEFEFE;
+												fillBlock2(cur_lp + width_tbl[1], lv1, lv2, 7, width_tbl[1]);
+												cur_lp[0] = averagePixels(cur_lp[-width_tbl[1]], cur_lp[width_tbl[1]]);
+												cur_lp[1] = averagePixels(cur_lp[-width_tbl[1]+1], cur_lp[width_tbl[1]+1]);
 											} else {
-												for (i = 0, j = 0; i < 8 - (lp2 * 2); i++, j += width_tbl[1]) {
-													cur_lp[j] = lv1;
-													cur_lp[j+1] = lv2;
-												}
+												fillBlock2(cur_lp, lv1, lv2, 8 - (lp2 * 2), width_tbl[1]);
 											}
 											lp2 = 4;
 											break;
@@ -942,8 +961,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 											lv = (lv1 & 0x7F) << 1;
 											lv += (lv << 8);
 											lv += (lv << 16);
-											for (i = 0, j = 0; i < 8; i++, j += width_tbl[1])
-												cur_lp[j] = lv;
+											fillBlock(cur_lp, lv, 8, width_tbl[1]);
 											LV1_CHECK(buf1,rle_v3,lv1,lp2)
 											break;
 
@@ -970,39 +988,33 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 										case 0:
 											lv1 = correctionloworder_lp[lp2 & 0x01][k];
 											lv2 = correctionhighorder_lp[lp2 & 0x01][k];
-											cur_lp[0] = FROM_LE_32(((FROM_LE_32(ref_lp[0]) >> 1) + lv1) << 1);
-											cur_lp[1] = FROM_LE_32(((FROM_LE_32(ref_lp[1]) >> 1) + lv2) << 1);
-											cur_lp[width_tbl[1]] = FROM_LE_32(((FROM_LE_32(ref_lp[width_tbl[1]]) >> 1) + lv1) << 1);
-											cur_lp[width_tbl[1]+1] = FROM_LE_32(((FROM_LE_32(ref_lp[width_tbl[1]+1]) >> 1) + lv2) << 1);
+											cur_lp[0] = applyCorrection(ref_lp[0], lv1);
+											cur_lp[1] = applyCorrection(ref_lp[1], lv2);
+											cur_lp[width_tbl[1]] = applyCorrection(ref_lp[width_tbl[1]], lv1);
+											cur_lp[width_tbl[1]+1] = applyCorrection(ref_lp[width_tbl[1]+1], lv2);
 											lp2++;
 											break;
 
 										case 1:
 											lv1 = correctionloworder_lp[lp2 & 0x01][*buf1++];
 											lv2 = correctionloworder_lp[lp2 & 0x01][k];
-											cur_lp[0] = FROM_LE_32(((FROM_LE_32(ref_lp[0]) >> 1) + lv1) << 1);
-											cur_lp[1] = FROM_LE_32(((FROM_LE_32(ref_lp[1]) >> 1) + lv2) << 1);
-											cur_lp[width_tbl[1]] = FROM_LE_32(((FROM_LE_32(ref_lp[width_tbl[1]]) >> 1) + lv1) << 1);
-											cur_lp[width_tbl[1]+1] = FROM_LE_32(((FROM_LE_32(ref_lp[width_tbl[1]+1]) >> 1) + lv2) << 1);
+											cur_lp[0] = applyCorrection(ref_lp[0], lv1);
+											cur_lp[1] = applyCorrection(ref_lp[1], lv2);
+											cur_lp[width_tbl[1]] = applyCorrection(ref_lp[width_tbl[1]], lv1);
+											cur_lp[width_tbl[1]+1] = applyCorrection(ref_lp[width_tbl[1]+1], lv2);
 											lp2++;
 											break;
 
 										case 2:
 											if (lp2 == 0) {
-												for (i = 0, j = 0; i < 4; i++, j += width_tbl[1]) {
-													cur_lp[j] = ref_lp[j];
-													cur_lp[j+1] = ref_lp[j+1];
-												}
+												copyBlock2(cur_lp, ref_lp, 4, width_tbl[1]);
 												lp2 += 2;
 											}
 											break;
 
 										case 3:
 											if (lp2 < 2) {
-												for (i = 0, j = 0; i < 6 - (lp2 * 2); i++, j += width_tbl[1]) {
-													cur_lp[j] = ref_lp[j];
-													cur_lp[j+1] = ref_lp[j+1];
-												}
+												copyBlock2(cur_lp, ref_lp, 6 - (lp2 * 2), width_tbl[1]);
 												lp2 = 3;
 											}
 											break;
@@ -1010,10 +1022,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 										case 8:
 											if (lp2 == 0) {
 												RLE_V3_CHECK(buf1,rle_v1,rle_v2,rle_v3)
-												for (i = 0, j = 0; i < 8; i++, j += width_tbl[1]) {
-													((uint32 *)cur_frm_pos)[j] = ((uint32 *)ref_frm_pos)[j];
-													((uint32 *)cur_frm_pos)[j+1] = ((uint32 *)ref_frm_pos)[j+1];
-												}
+												copyBlock2((uint32 *)cur_frm_pos, (uint32 *)ref_frm_pos, 8, width_tbl[1]);
 												RLE_V2_CHECK(buf1,rle_v2, rle_v3,lp2)
 												break;
 											} else {
@@ -1025,10 +1034,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 												LP2_CHECK(buf1,rle_v3,lp2)
 										case 6:
 										case 4:
-											for (i = 0, j = 0; i < 8 - (lp2 * 2); i++, j += width_tbl[1]) {
-												cur_lp[j] = ref_lp[j];
-												cur_lp[j+1] = ref_lp[j+1];
-											}
+											copyBlock2(cur_lp, ref_lp, 8 - (lp2 * 2), width_tbl[1]);
 											lp2 = 4;
 											break;
 
@@ -1038,8 +1044,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 											lv = (lv1 & 0x7F) << 1;
 											lv += (lv << 8);
 											lv += (lv << 16);
-											for (i = 0, j = 0; i < 8; i++, j += width_tbl[1])
-												((uint32 *)cur_frm_pos)[j] = ((uint32 *)cur_frm_pos)[j+1] = lv;
+											fillBlock2((uint32 *)cur_frm_pos, lv, lv, 8, width_tbl[1]);
 											LV1_CHECK(buf1,rle_v3,lv1,lp2)
 											break;
 
@@ -1071,8 +1076,8 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 
 								switch (correction_type_sp[lp2 & 0x01][k]) {
 									case 0:
-										cur_lp[0] = FROM_LE_32(((FROM_LE_32(*ref_lp) >> 1) + correction_lp[lp2 & 0x01][k]) << 1);
-										cur_lp[width_tbl[1]] = FROM_LE_32(((FROM_LE_32(ref_lp[width_tbl[1]]) >> 1) + correction_lp[lp2 & 0x01][k]) << 1);
+										cur_lp[0] = applyCorrection(*ref_lp, correction_lp[lp2 & 0x01][k]);
+										cur_lp[width_tbl[1]] = applyCorrection(ref_lp[width_tbl[1]], correction_lp[lp2 & 0x01][k]);
 										lp2++;
 										break;
 
@@ -1098,16 +1103,14 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 
 									case 2:
 										if (lp2 == 0) {
-											for (i = 0, j = 0; i < 4; i++, j += width_tbl[1])
-												cur_lp[j] = ref_lp[j];
+											copyBlock(cur_lp, ref_lp, 4, width_tbl[1]);
 											lp2 += 2;
 										}
 										break;
 
 									case 3:
 										if (lp2 < 2) {
-											for (i = 0, j = 0; i < 6 - (lp2 * 2); i++, j += width_tbl[1])
-												cur_lp[j] = ref_lp[j];
+											copyBlock(cur_lp, ref_lp, 6 - (lp2 * 2), width_tbl[1]);
 											lp2 = 3;
 										}
 										break;
@@ -1116,8 +1119,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 										if (lp2 == 0) {
 											RLE_V3_CHECK(buf1,rle_v1,rle_v2,rle_v3)
 
-											for (i = 0, j = 0; i < 8; i++, j += width_tbl[1])
-												cur_lp[j] = ref_lp[j];
+											copyBlock(cur_lp, ref_lp, 8, width_tbl[1]);
 
 											RLE_V2_CHECK(buf1,rle_v2, rle_v3,lp2)
 											break;
@@ -1130,8 +1132,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 											LP2_CHECK(buf1,rle_v3,lp2)
 									case 4:
 									case 6:
-										for (i = 0, j = 0; i < 8 - (lp2 * 2); i++, j += width_tbl[1])
-											cur_lp[j] = ref_lp[j];
+										copyBlock(cur_lp, ref_lp, 8 - (lp2 * 2), width_tbl[1]);
 										lp2 = 4;
 										break;
 
@@ -1141,8 +1142,7 @@ void Indeo3Decoder::decodeChunk(byte *cur, byte *ref, int width, int height,
 										lv = (lv1 & 0x7F) << 1;
 										lv += (lv << 8);
 										lv += (lv << 16);
-										for (i = 0, j = 0; i < 4; i++, j += width_tbl[1])
-											cur_lp[j] = lv;
+										fillBlock(cur_lp, lv, 4, width_tbl[1]);
 										LV1_CHECK(buf1,rle_v3,lv1,lp2)
 										break;
 
@@ -44,6 +44,8 @@ namespace Video {
 class Indeo3Decoder : public Codec {
 public:
 	Indeo3Decoder(uint16 width, uint16 height);
+	/** Decode to the given pixel format instead of the screen format */
+	Indeo3Decoder(uint16 width, uint16 height, const Graphics::PixelFormat &format);
 	~Indeo3Decoder();
 
 	const Graphics::Surface *decodeImage(Common::SeekableReadStream *stream);
@@ -79,9 +81,12 @@ private:
 	byte *_ModPred;
 	uint16 *_corrector_type;
 
+	void init(uint16 width, uint16 height);
 	void buildModPred();
 	void allocFrames();
 
+	void outputFrame(uint32 fWidth, uint32 fHeight, uint32 chromaWidth);
+
 	void decodeChunk(byte *cur, byte *ref, int width, int height,
 			const byte *buf1, uint32 fflags2, const byte *hdr,
 			const byte *buf2, int min_width_160);
@@ -56,13 +56,12 @@ const Graphics::Surface *JPEGDecoder::decodeImage(Common::SeekableReadStream* st
 		_surface->create(_jpeg->getWidth(), _jpeg->getHeight(), _pixelFormat.bytesPerPixel);
 	}
 
-	Graphics::Surface *frame = _jpeg->getSurface(_pixelFormat);
-	assert(frame);
-
-	_surface->copyFrom(*frame);
-
-	frame->free();
-	delete frame;
+	// Convert straight into the frame surface, instead of going through
+	// a temporary surface for every frame
+	if (!_jpeg->convertToSurface(_surface, _pixelFormat)) {
+		warning("Failed to convert JPEG frame");
+		return 0;
+	}
 
 	return _surface;
 }
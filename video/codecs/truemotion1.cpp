@@ -99,6 +99,7 @@ TrueMotion1Decoder::TrueMotion1Decoder(uint16 width, uint16 height) {
 	_vertPred = new uint32[_width];
 
 	_buf = _mbChangeBits = _indexStream = 0;
+	_bufSize = 0;
 	_lastDeltaset = _lastVectable = -1;
 }
 
@@ -106,6 +107,7 @@ TrueMotion1Decoder::~TrueMotion1Decoder() {
 	_surface->free();
 	delete _surface;
 	delete[] _vertPred;
+	delete[] _buf;
 }
 
 void TrueMotion1Decoder::selectDeltaTables(int deltaTableIndex) {
@@ -163,7 +165,13 @@ void TrueMotion1Decoder::genVectorTable16(const byte *selVectorTable) {
 }
 
 void TrueMotion1Decoder::decodeHeader(Common::SeekableReadStream *stream) {
-	_buf = new byte[stream->size()];
+	// Keep the buffer between frames, it only needs to grow occasionally
+	if ((uint32)stream->size() > _bufSize) {
+		delete[] _buf;
+		_bufSize = stream->size();
+		_buf = new byte[_bufSize];
+	}
+
 	stream->read(_buf, stream->size());
 
 	byte headerBuffer[128];  // logical maximum size of the header
@@ -408,8 +416,6 @@ const Graphics::Surface *TrueMotion1Decoder::decodeImage(Common::SeekableReadStr
 	} else
 		decode16();
 
-	delete[] _buf;
-
 	return _surface;
 }
 
@@ -50,6 +50,7 @@ private:
 
 	int _mbChangeBitsRowSize;
 	byte *_buf, *_mbChangeBits, *_indexStream;
+	uint32 _bufSize;
 	int _indexStreamSize;
 
 	uint16 _width, _height;
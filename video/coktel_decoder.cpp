@@ -38,6 +38,9 @@
 
 static const uint32 kVideoCodecIndeo3 = MKID_BE('iv32');
 
+// How much frame data VMDs read ahead, in bytes
+static const uint32 kVMDReadAheadSize = 65536;
+
 namespace Video {
 
 CoktelDecoder::State::State() : flags(0), speechId(0) {
@@ -1493,6 +1496,7 @@ VMDDecoder::Part::Part() {
 VMDDecoder::Frame::Frame() {
 	parts  = 0;
 	offset = 0;
+	size   = 0;
 }
 
 VMDDecoder::Frame::~Frame() {
@@ -1542,7 +1546,8 @@ VMDDecoder::VMDDecoder(Audio::Mixer *mixer, Audio::Mixer::SoundType soundType) :
 	_soundBytesPerSample(0), _soundStereo(0), _soundHeaderSize(0), _soundDataSize(0),
 	_soundLastFilledFrame(0), _audioFormat(kAudioFormat8bitRaw),
 	_hasVideo(false), _videoCodec(0), _blitMode(0), _bytesPerPixel(0),
-	_firstFramePos(0), _videoBufferSize(0), _externalCodec(false), _codec(0),
+	_firstFramePos(0), _videoBufferSize(0), _frameData(0), _frameDataSize(0),
+	_frameDataStart(0), _frameDataLen(0), _externalCodec(false), _codec(0),
 	_subtitle(-1), _isPaletted(true) {
 
 	_videoBuffer   [0] = 0;
@@ -1910,12 +1915,18 @@ bool VMDDecoder::readFrameTable(int &numFiles) {
 	for (uint16 i = 0; i < _frameCount; i++) {
 		bool separator = false;
 
+		_frames[i].size = 0;
+
 		for (uint16 j = 0; j < _partsPerFrame; j++) {
 
 			_frames[i].parts[j].type    = (PartType) _stream->readByte();
 			_frames[i].parts[j].field_1 = _stream->readByte();
 			_frames[i].parts[j].size    = _stream->readUint32LE();
 
+			// Separators don't take up any space in the frame data
+			if (_frames[i].parts[j].type != kPartTypeSeparator)
+				_frames[i].size += _frames[i].parts[j].size;
+
 			if (_frames[i].parts[j].type == kPartTypeAudio) {
 
 				_frames[i].parts[j].flags = _stream->readByte();
@@ -2006,6 +2017,8 @@ void VMDDecoder::close() {
 	delete[] _videoBuffer[1];
 	delete[] _videoBuffer[2];
 
+	delete[] _frameData;
+
 	delete _codec;
 
 	_files.clear();
@@ -2046,6 +2059,11 @@ void VMDDecoder::close() {
 	_videoBufferLen[1] = 0;
 	_videoBufferLen[2] = 0;
 
+	_frameData      = 0;
+	_frameDataSize  = 0;
+	_frameDataStart = 0;
+	_frameDataLen   = 0;
+
 	_externalCodec = false;
 	_codec         = 0;
 
@@ -2080,9 +2098,11 @@ void VMDDecoder::processFrame() {
 
 	bool startSound = false;
 
-	for (uint16 i = 0; i < _partsPerFrame; i++) {
-		uint32 pos = _stream->pos();
+	// All parts of the frame are read at once, and decoded from memory
+	uint32 framePos = _stream->pos();
+	const byte *data = readFrameData(framePos, _frames[_curFrame].size);
 
+	for (uint16 i = 0; i < _partsPerFrame; i++) {
 		Part &part = _frames[_curFrame].parts[i];
 
 		if (part.type == kPartTypeAudio) {
@@ -2091,26 +2111,22 @@ void VMDDecoder::processFrame() {
 				// Next sound slice data
 
 				if (_soundEnabled) {
-					filledSoundSlice(part.size);
+					filledSoundSlice(data, part.size);
 
 					if (_soundStage == kSoundLoaded)
 						startSound = true;
-
-				} else
-					_stream->skip(part.size);
+				}
 
 			} else if (part.flags == 2) {
 				// Initial sound data (all slices)
 
 				if (_soundEnabled) {
-					uint32 mask = _stream->readUint32LE();
-					filledSoundSlices(part.size - 4, mask);
+					uint32 mask = READ_LE_UINT32(data);
+					filledSoundSlices(data + 4, part.size - 4, mask);
 
 					if (_soundStage == kSoundLoaded)
 						startSound = true;
-
-				} else
-					_stream->skip(part.size);
+				}
 
 			} else if (part.flags == 3) {
 				// Empty sound slice
@@ -2123,49 +2139,46 @@ void VMDDecoder::processFrame() {
 						startSound = true;
 				}
 
-				_stream->skip(part.size);
 			} else if (part.flags == 4) {
 				warning("VMDDecoder::processFrame(): TODO: Addy 5 sound type 4 (%d)", part.size);
 				disableSound();
-				_stream->skip(part.size);
 			} else {
 				warning("VMDDecoder::processFrame(): Unknown sound type %d", part.flags);
-				_stream->skip(part.size);
 			}
 
-			_stream->seek(pos + part.size);
+			data += part.size;
 
 		} else if ((part.type == kPartTypeVideo) && !_hasVideo) {
 
 			warning("VMDDecoder::processFrame(): Header claims there's no video, but video found (%d)", part.size);
-			_stream->skip(part.size);
+			data += part.size;
 
 		} else if ((part.type == kPartTypeVideo) && _hasVideo) {
 
+			const byte *videoData = data;
 			uint32 size = part.size;
 
 			// New palette
 			if (part.flags & 2) {
-				uint8 index = _stream->readByte();
-				uint8 count = _stream->readByte();
+				uint8 index = videoData[0];
+				uint8 count = videoData[1];
 
 				for (int j = 0; j < ((count + 1) * 3); j++)
-					_palette[index * 3 + j] = _stream->readByte() << 2;
-
-				_stream->skip((255 - count) * 3);
+					_palette[index * 3 + j] = videoData[2 + j] << 2;
 
 				_paletteDirty = true;
 
-				size -= (768 + 2);
+				videoData += 768 + 2;
+				size      -= 768 + 2;
 			}
 
-			_stream->read(_videoBuffer[0], size);
-			_videoBufferLen[0] = size;
-
+			// The video data is rendered straight from the frame data
 			Common::Rect rect(part.left, part.top, part.right + 1, part.bottom + 1);
-			if (renderFrame(rect))
+			if (renderFrame(rect, videoData, size))
 				_dirtyRects.push_back(rect);
 
+			data += part.size;
+
 		} else if (part.type == kPartTypeSeparator) {
 
 			// Ignore
@@ -2173,17 +2186,17 @@ void VMDDecoder::processFrame() {
 		} else if (part.type == kPartTypeFile) {
 
 			// Ignore
-			_stream->skip(part.size);
+			data += part.size;
 
 		} else if (part.type == kPartType4) {
 
 			// Unknown, ignore
-			_stream->skip(part.size);
+			data += part.size;
 
 		} else if (part.type == kPartTypeSubtitle) {
 
 			_subtitle = part.id;
-			_stream->skip(part.size);
+			data += part.size;
 
 		} else {
 
@@ -2193,6 +2206,8 @@ void VMDDecoder::processFrame() {
 		}
 	}
 
+	_stream->seek(framePos + _frames[_curFrame].size);
+
 	if (startSound && _soundEnabled) {
 		if (_hasSound && _audioStream) {
 			_mixer->playStream(_soundType, &_audioHandle, _audioStream,
@@ -2208,7 +2223,45 @@ void VMDDecoder::processFrame() {
 	}
 }
 
-bool VMDDecoder::renderFrame(Common::Rect &rect) {
+const byte *VMDDecoder::readFrameData(uint32 pos, uint32 size) {
+	// Already read ahead?
+	if ((pos >= _frameDataStart) && ((pos + size) <= (_frameDataStart + _frameDataLen)))
+		return _frameData + (pos - _frameDataStart);
+
+	// Read this frame, together with the ones following it that still fit.
+	// Bigger reads make playing several videos at once, which interleaves
+	// the reads of different files, a lot less seek-heavy.
+	uint32 readSize = size;
+	for (uint32 i = _curFrame + 1; i < _frameCount; i++) {
+		if ((readSize + _frames[i].size) > kVMDReadAheadSize)
+			break;
+
+		readSize += _frames[i].size;
+	}
+
+	if (readSize > _frameDataSize) {
+		delete[] _frameData;
+
+		_frameDataSize = readSize;
+		_frameData     = new byte[_frameDataSize];
+	}
+
+	_stream->seek(pos);
+
+	_frameDataStart = pos;
+	_frameDataLen   = _stream->read(_frameData, readSize);
+
+	// Don't leave garbage in a truncated frame
+	if (_frameDataLen < size)
+		memset(_frameData + _frameDataLen, 0, size - _frameDataLen);
+
+	return _frameData;
+}
+
+bool VMDDecoder::renderFrame(Common::Rect &rect, const byte *data, uint32 size) {
+	if (size == 0)
+		return false;
+
 	Common::Rect realRect, fakeRect;
 	if (!getRenderRects(rect, realRect, fakeRect))
 		return false;
@@ -2217,7 +2270,7 @@ bool VMDDecoder::renderFrame(Common::Rect &rect) {
 		if (!_codec)
 			return false;
 
-		Common::MemoryReadStream frameStream(_videoBuffer[0], _videoBufferLen[0]);
+		Common::MemoryReadStream frameStream(data, size);
 		const Graphics::Surface *codecSurf = _codec->decodeImage(&frameStream);
 		if (!codecSurf)
 			return false;
@@ -2229,9 +2282,8 @@ bool VMDDecoder::renderFrame(Common::Rect &rect) {
 		return true;
 	}
 
-	uint8  srcBuffer = 0;
-	byte  *dataPtr   = _videoBuffer[srcBuffer];
-	uint32 dataSize  = _videoBufferLen[srcBuffer] - 1;
+	const byte *dataPtr  = data;
+	uint32      dataSize = size - 1;
 
 	uint8 type = *dataPtr++;
 
@@ -2251,12 +2303,10 @@ bool VMDDecoder::renderFrame(Common::Rect &rect) {
 				return true;
 		}
 
-		srcBuffer = 1;
-		_videoBufferLen[srcBuffer] =
-			deLZ77(_videoBuffer[srcBuffer], dataPtr, dataSize, _videoBufferSize);
+		_videoBufferLen[1] = deLZ77(_videoBuffer[1], dataPtr, dataSize, _videoBufferSize);
 
-		dataPtr  = _videoBuffer[srcBuffer];
-		dataSize = _videoBufferLen[srcBuffer];
+		dataPtr  = _videoBuffer[1];
+		dataSize = _videoBufferLen[1];
 	}
 
 	Common::Rect      *blockRect = &fakeRect;
@@ -2431,14 +2481,14 @@ void VMDDecoder::emptySoundSlice(uint32 size) {
 	}
 }
 
-void VMDDecoder::filledSoundSlice(uint32 size) {
+void VMDDecoder::filledSoundSlice(const byte *data, uint32 size) {
 	byte *sound = 0;
 	if (_audioFormat == kAudioFormat8bitRaw)
-		sound = sound8bitRaw(size);
+		sound = sound8bitRaw(data, size);
 	else if (_audioFormat == kAudioFormat16bitDPCM)
-		sound = sound16bitDPCM(size);
+		sound = sound16bitDPCM(data, size);
 	else if (_audioFormat == kAudioFormat16bitADPCM)
-		sound = sound16bitADPCM(size);
+		sound = sound16bitADPCM(data, size);
 
 	if (sound) {
 		uint32 flags = 0;
@@ -2449,7 +2499,7 @@ void VMDDecoder::filledSoundSlice(uint32 size) {
 	}
 }
 
-void VMDDecoder::filledSoundSlices(uint32 size, uint32 mask) {
+void VMDDecoder::filledSoundSlices(const byte *data, uint32 size, uint32 mask) {
 	bool fillInfo[32];
 
 	uint8 max;
@@ -2465,14 +2515,20 @@ void VMDDecoder::filledSoundSlices(uint32 size, uint32 mask) {
 	if (n > 0)
 		extraSize /= n;
 
+	// Never read beyond the part, even if the header lies
+	const byte *dataEnd = data + size;
+
 	for (uint8 i = 0; i < max; i++)
-		if (fillInfo[i])
-			filledSoundSlice(_soundDataSize + extraSize);
-		else
+		if (fillInfo[i]) {
+			uint32 sliceSize = MIN<uint32>(_soundDataSize + extraSize, dataEnd - data);
+
+			filledSoundSlice(data, sliceSize);
+			data += sliceSize;
+		} else
 			emptySoundSlice(_soundDataSize * _soundBytesPerSample);
 
 	if (_soundSlicesCount > 32)
-		filledSoundSlice((_soundSlicesCount - 32) * _soundDataSize + _soundHeaderSize);
+		filledSoundSlice(data, MIN<uint32>((_soundSlicesCount - 32) * _soundDataSize + _soundHeaderSize, dataEnd - data));
 }
 
 uint8 VMDDecoder::evaluateMask(uint32 mask, bool *fillInfo, uint8 &max) {
@@ -2503,67 +2559,44 @@ byte *VMDDecoder::soundEmpty(uint32 &size) {
 	return soundBuf;
 }
 
-byte *VMDDecoder::sound8bitRaw(uint32 &size) {
-	if (!_audioStream) {
-		_stream->skip(size);
+byte *VMDDecoder::sound8bitRaw(const byte *data, uint32 &size) {
+	if (!_audioStream)
 		return 0;
-	}
 
 	byte *soundBuf = (byte *)malloc(size);
-	_stream->read(soundBuf, size);
+	memcpy(soundBuf, data, size);
 	unsignedToSigned(soundBuf, size);
 
 	return soundBuf;
 }
 
-byte *VMDDecoder::sound16bitDPCM(uint32 &size) {
-	if (!_audioStream) {
-		_stream->skip(size);
+byte *VMDDecoder::sound16bitDPCM(const byte *data, uint32 &size) {
+	uint32 headerSize = (_soundStereo > 0) ? 4 : 2;
+	if (!_audioStream || (size < headerSize))
 		return 0;
-	}
 
 	int32 init[2];
 
-	init[0] = _stream->readSint16LE();
-	size -= 2;
+	init[0] = (int16)READ_LE_UINT16(data);
 
-	if (_soundStereo > 0) {
-		init[1] = _stream->readSint16LE();
-		size -= 2;
-	}
+	if (_soundStereo > 0)
+		init[1] = (int16)READ_LE_UINT16(data + 2);
 
-	byte *data  = new byte[size];
-	byte *sound = 0;
+	size -= headerSize;
 
-	if (_stream->read(data, size) == size)
-		sound = deDPCM(data, size, init);
-
-	delete[] data;
-
-	return sound;
+	return deDPCM(data + headerSize, size, init);
 }
 
-byte *VMDDecoder::sound16bitADPCM(uint32 &size) {
-	if (!_audioStream) {
-		_stream->skip(size);
+byte *VMDDecoder::sound16bitADPCM(const byte *data, uint32 &size) {
+	if (!_audioStream || (size < 3))
 		return 0;
-	}
-
-	int32 init = _stream->readSint16LE();
-	size -= 2;
-
-	int32 index = _stream->readByte();
-	size--;
 
-	byte *data  = new byte[size];
-	byte *sound = 0;
-
-	if (_stream->read(data, size) == size)
-		sound = deADPCM(data, size, init, index);
+	int32 init  = (int16)READ_LE_UINT16(data);
+	int32 index = data[2];
 
-	delete[] data;
+	size -= 3;
 
-	return sound;
+	return deADPCM(data + 3, size, init, index);
 }
 
 byte *VMDDecoder::deDPCM(const byte *data, uint32 &size, int32 init[2]) {
@@ -423,6 +423,7 @@ private:
 
 	struct Frame {
 		uint32 offset;
+		uint32 size;
 		Part  *parts;
 
 		Frame();
@@ -471,6 +472,11 @@ private:
 
 	Graphics::Surface _8bppSurface[3]; ///< Fake 8bpp surfaces over the video buffers.
 
+	byte  *_frameData;      ///< Raw data of the frames read ahead.
+	uint32 _frameDataSize;  ///< Size of the frame data buffer.
+	uint32 _frameDataStart; ///< Position of the frame data within the stream.
+	uint32 _frameDataLen;   ///< Size of the frame data buffer filled.
+
 	bool _externalCodec;
 	Codec *_codec;
 
@@ -487,9 +493,10 @@ private:
 
 	// Frame decoding
 	void processFrame();
+	const byte *readFrameData(uint32 pos, uint32 size);
 
 	// Video
-	bool renderFrame(Common::Rect &rect);
+	bool renderFrame(Common::Rect &rect, const byte *data, uint32 size);
 	bool getRenderRects(const Common::Rect &rect,
 			Common::Rect &realRect, Common::Rect &fakeRect);
 	void blit16(const Graphics::Surface &srcSurf, Common::Rect &rect);
@@ -497,16 +504,16 @@ private:
 
 	// Sound
 	void emptySoundSlice  (uint32 size);
-	void filledSoundSlice (uint32 size);
-	void filledSoundSlices(uint32 size, uint32 mask);
+	void filledSoundSlice (const byte *data, uint32 size);
+	void filledSoundSlices(const byte *data, uint32 size, uint32 mask);
 
 	uint8 evaluateMask(uint32 mask, bool *fillInfo, uint8 &max);
 
 	// Generating sound slices
 	byte *soundEmpty     (uint32 &size);
-	byte *sound8bitRaw   (uint32 &size);
-	byte *sound16bitDPCM (uint32 &size);
-	byte *sound16bitADPCM(uint32 &size);
+	byte *sound8bitRaw   (const byte *data, uint32 &size);
+	byte *sound16bitDPCM (const byte *data, uint32 &size);
+	byte *sound16bitADPCM(const byte *data, uint32 &size);
 
 	// Sound decompression
 	byte *deDPCM (const byte *data, uint32 &size, int32 init[2]);
@@ -23,6 +23,7 @@
  *
  */
 
+#include "common/array.h"
 #include "common/debug.h"
 #include "common/endian.h"
 #include "common/archive.h"
@@ -38,6 +39,9 @@
 
 namespace Video {
 
+#define BLOCKW 4
+#define BLOCKH 4
+
 DXADecoder::DXADecoder() {
 	_fileStream = 0;
 	_surface = 0;
@@ -47,9 +51,6 @@ DXADecoder::DXADecoder() {
 	_frameBuffer2 = 0;
 	_scaledBuffer = 0;
 
-	_inBuffer = 0;
-	_inBufferSize = 0;
-
 	_decompBuffer = 0;
 	_decompBufferSize = 0;
 
@@ -61,6 +62,12 @@ DXADecoder::DXADecoder() {
 	_frameRate = 0;
 
 	_scaleMode = S_NONE;
+
+	_inflater = 0;
+
+	_dirtyBlocks = 0;
+	_blocksW = 0;
+	_blocksH = 0;
 }
 
 DXADecoder::~DXADecoder() {
@@ -122,6 +129,16 @@ bool DXADecoder::loadStream(Common::SeekableReadStream *stream) {
 			error("Error allocating scale buffer (size %u)", _frameSize);
 	}
 
+	_blocksW = (_width + BLOCKW - 1) / BLOCKW;
+	_blocksH = (_height + BLOCKH - 1) / BLOCKH;
+	_dirtyBlocks = (byte *)malloc(_blocksW * _blocksH);
+	if (!_dirtyBlocks)
+		error("Error allocating dirty block map (size %u)", _blocksW * _blocksH);
+
+#ifdef USE_ZLIB
+	_inflater = new Common::Inflater();
+#endif
+
 #ifdef DXA_EXPERIMENT_MAXD
 	// Check for an extended header
 	if (flags & 1) {
@@ -170,25 +187,30 @@ void DXADecoder::close() {
 	free(_frameBuffer1);
 	free(_frameBuffer2);
 	free(_scaledBuffer);
-	free(_inBuffer);
 	free(_decompBuffer);
+	free(_dirtyBlocks);
 
-	_inBuffer = 0;
 	_decompBuffer = 0;
+	_dirtyBlocks = 0;
+
+#ifdef USE_ZLIB
+	delete _inflater;
+#endif
+	_inflater = 0;
+
+	_dirtyRects.clear();
 
 	reset();
 }
 
 void DXADecoder::decodeZlib(byte *data, int size, int totalSize) {
 #ifdef USE_ZLIB
+	// Decompress straight from the file
 	unsigned long dstLen = totalSize;
-	Common::uncompress(data, &dstLen, _inBuffer, size);
+	_inflater->decompress(data, &dstLen, *_fileStream, size);
 #endif
 }
 
-#define BLOCKW 4
-#define BLOCKH 4
-
 void DXADecoder::decode12(int size) {
 #ifdef USE_ZLIB
 	if (_decompBuffer == NULL) {
@@ -209,6 +231,8 @@ void DXADecoder::decode12(int size) {
 			byte type = *dat++;
 			byte *b2 = _frameBuffer1 + bx + by * _width;
 
+			_dirtyBlocks[(by / BLOCKH) * _blocksW + bx / BLOCKW] = (type != 0) && (type != 5);
+
 			switch (type) {
 			case 0:
 				break;
@@ -322,6 +346,9 @@ void DXADecoder::decode13(int size) {
 			uint8 type = *codeBuf++;
 			uint8 *b2 = (uint8*)_frameBuffer1 + bx + by * _width;
 
+			byte &dirty = _dirtyBlocks[(by / BLOCKH) * _blocksW + bx / BLOCKW];
+			dirty = (type != 0);
+
 			switch (type) {
 			case 0:
 				break;
@@ -384,6 +411,8 @@ void DXADecoder::decode13(int size) {
 				static const int subY[4] = {0, 0, 2, 2};
 
 				uint8 subMask = *maskBuf++;
+				if (subMask == 0)
+					dirty = 0;
 
 				for (int subBlock = 0; subBlock < 4; subBlock++) {
 					int sx = bx + subX[subBlock], sy = by + subY[subBlock];
@@ -477,7 +506,60 @@ void DXADecoder::decode13(int size) {
 #endif
 }
 
+void DXADecoder::updateDirtyRects() {
+	_dirtyRects.clear();
+
+	// Join the changed blocks into horizontal runs, and the runs into
+	// rectangles with the same runs in the rows below
+	Common::Array<Common::Rect> rects;
+	Common::Array<uint> open, nextOpen;
+
+	const uint32 blocksH = MIN<uint32>(_blocksH, (_curHeight + BLOCKH - 1) / BLOCKH);
+
+	for (uint32 by = 0; by < blocksH; by++) {
+		const byte *dirty = _dirtyBlocks + by * _blocksW;
+
+		nextOpen.clear();
+
+		for (uint32 bx = 0; bx < _blocksW; ) {
+			if (!dirty[bx]) {
+				bx++;
+				continue;
+			}
+
+			uint32 start = bx;
+			while (bx < _blocksW && dirty[bx])
+				bx++;
+
+			Common::Rect rect(start * BLOCKW, by * BLOCKH,
+			                  MIN<uint32>(bx * BLOCKW, _width), MIN<uint32>((by + 1) * BLOCKH, _curHeight));
+
+			uint i;
+			for (i = 0; i < open.size(); i++) {
+				Common::Rect &above = rects[open[i]];
+				if (above.left == rect.left && above.right == rect.right) {
+					above.bottom = rect.bottom;
+					nextOpen.push_back(open[i]);
+					break;
+				}
+			}
+
+			if (i == open.size()) {
+				rects.push_back(rect);
+				nextOpen.push_back(rects.size() - 1);
+			}
+		}
+
+		open = nextOpen;
+	}
+
+	for (uint i = 0; i < rects.size(); i++)
+		_dirtyRects.push_back(rects[i]);
+}
+
 const Graphics::Surface *DXADecoder::decodeNextFrame() {
+	memset(_dirtyBlocks, 0, _blocksW * _blocksH);
+
 	uint32 tag = _fileStream->readUint32BE();
 	if (tag == MKID_BE('CMAP')) {
 		_fileStream->read(_palette, 256 * 3);
@@ -488,20 +570,12 @@ const Graphics::Surface *DXADecoder::decodeNextFrame() {
 	if (tag == MKID_BE('FRAM')) {
 		byte type = _fileStream->readByte();
 		uint32 size = _fileStream->readUint32BE();
-		if ((_inBuffer == NULL) || (_inBufferSize < size)) {
-			free(_inBuffer);
-			_inBuffer = (byte *)malloc(size);
-			memset(_inBuffer, 0, size);
-			if (_inBuffer == NULL)
-				error("Error allocating input buffer (size %u)", size);
-			_inBufferSize = size;
-		}
-
-		_fileStream->read(_inBuffer, size);
+		uint32 pos = _fileStream->pos();
 
 		switch (type) {
 		case 2:
 			decodeZlib(_frameBuffer1, size, _frameSize);
+			memset(_dirtyBlocks, 1, _blocksW * _blocksH);
 			break;
 		case 3:
 			decodeZlib(_frameBuffer2, size, _frameSize);
@@ -516,28 +590,48 @@ const Graphics::Surface *DXADecoder::decodeNextFrame() {
 			error("decodeFrame: Unknown compression type %d", type);
 		}
 
+		// The decompression doesn't necessarily read all of the frame
+		_fileStream->seek(pos + size);
+
 		if (type == 3) {
 			for (uint32 j = 0; j < _curHeight; ++j) {
+				byte *dirty = _dirtyBlocks + (j / BLOCKH) * _blocksW;
+
 				for (uint32 i = 0; i < _width; ++i) {
 					const int offs = j * _width + i;
-					_frameBuffer1[offs] ^= _frameBuffer2[offs];
+
+					if (_frameBuffer2[offs]) {
+						_frameBuffer1[offs] ^= _frameBuffer2[offs];
+						dirty[i / BLOCKW] = 1;
+					}
 				}
 			}
 		}
 	}
 
+	// Nothing is on the screen yet before the first frame
+	if (_curFrame == -1)
+		memset(_dirtyBlocks, 1, _blocksW * _blocksH);
+
+	updateDirtyRects();
+
+	// Only the changed parts need to be scaled again
+	Common::List<Common::Rect>::iterator rect;
+
 	switch (_scaleMode) {
 	case S_INTERLACED:
-		for (int cy = 0; cy < _curHeight; cy++) {
-			memcpy(&_scaledBuffer[2 * cy * _width], &_frameBuffer1[cy * _width], _width);
-			memset(&_scaledBuffer[((2 * cy) + 1) * _width], 0, _width);
-		}
+		// The odd lines stay black
+		for (rect = _dirtyRects.begin(); rect != _dirtyRects.end(); ++rect)
+			for (int cy = rect->top; cy < rect->bottom; cy++)
+				memcpy(&_scaledBuffer[2 * cy * _width + rect->left], &_frameBuffer1[cy * _width + rect->left], rect->width());
 		_surface->pixels = _scaledBuffer;
 		break;
 	case S_DOUBLE:
-		for (int cy = 0; cy < _curHeight; cy++) {
-			memcpy(&_scaledBuffer[2 * cy * _width], &_frameBuffer1[cy * _width], _width);
-			memcpy(&_scaledBuffer[((2 * cy) + 1) * _width], &_frameBuffer1[cy * _width], _width);
+		for (rect = _dirtyRects.begin(); rect != _dirtyRects.end(); ++rect) {
+			for (int cy = rect->top; cy < rect->bottom; cy++) {
+				memcpy(&_scaledBuffer[2 * cy * _width + rect->left], &_frameBuffer1[cy * _width + rect->left], rect->width());
+				memcpy(&_scaledBuffer[((2 * cy) + 1) * _width + rect->left], &_frameBuffer1[cy * _width + rect->left], rect->width());
+			}
 		}
 		_surface->pixels = _scaledBuffer;
 		break;
@@ -546,6 +640,13 @@ const Graphics::Surface *DXADecoder::decodeNextFrame() {
 		break;
 	}
 
+	if (_scaleMode != S_NONE) {
+		for (rect = _dirtyRects.begin(); rect != _dirtyRects.end(); ++rect) {
+			rect->top *= 2;
+			rect->bottom *= 2;
+		}
+	}
+
 	// Copy in the relevant info to the Surface
 	_surface->w = getWidth();
 	_surface->h = getHeight();
@@ -26,8 +26,15 @@
 #ifndef VIDEO_DXA_DECODER_H
 #define VIDEO_DXA_DECODER_H
 
+#include "common/list.h"
+#include "common/rect.h"
+
 #include "video/video_decoder.h"
 
+namespace Common {
+class Inflater;
+}
+
 namespace Video {
 
 /**
@@ -60,6 +67,13 @@ public:
 	 */
 	uint32 getSoundTag() { return _soundTag; }
 
+	/**
+	 * Get the areas of the last decoded frame that changed since the
+	 * previous one. Everything else is still the same, and doesn't have
+	 * to be drawn again.
+	 */
+	const Common::List<Common::Rect> &getDirtyRects() const { return _dirtyRects; }
+
 protected:
 	Common::Rational getFrameRate() const { return _frameRate; }
 
@@ -69,6 +83,7 @@ private:
 	void decodeZlib(byte *data, int size, int totalSize);
 	void decode12(int size);
 	void decode13(int size);
+	void updateDirtyRects();
 
 	enum ScaleMode {
 		S_NONE,
@@ -83,8 +98,6 @@ private:
 	byte *_frameBuffer1;
 	byte *_frameBuffer2;
 	byte *_scaledBuffer;
-	byte *_inBuffer;
-	uint32 _inBufferSize;
 	byte *_decompBuffer;
 	uint32 _decompBufferSize;
 	uint16 _curHeight;
@@ -94,6 +107,13 @@ private:
 	uint16 _width, _height;
 	uint32 _frameRate;
 	uint32 _frameCount;
+
+	Common::Inflater *_inflater;
+
+	// Which 4x4 blocks the last frame changed
+	byte *_dirtyBlocks;
+	uint32 _blocksW, _blocksH;
+	Common::List<Common::Rect> _dirtyRects;
 };
 
 } // End of namespace Video
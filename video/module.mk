@@ -8,6 +8,7 @@ MODULE_OBJS := \
 	mpeg_player.o \
 	qt_decoder.o \
 	smk_decoder.o \
+	threaded_decoder.o \
 	video_decoder.o \
 	codecs/cdtoons.o \
 	codecs/cinepak.o \
@@ -131,9 +131,6 @@ protected:
 	} _palettes[50];
 #else
 	OverlayColor *_overlay;
-	Graphics::PixelFormat _overlayFormat;
-	int16 *_colorTab;
-	OverlayColor *_rgbToPix;
 #endif
 
 public:
@@ -145,10 +142,6 @@ public:
 	void handleScreenChanged();
 	void updateScreen();
 
-#ifndef BACKEND_8BIT
-	void buildLookup();
-#endif
-
 	int getFrameWidth() { return _frameWidth; }
 	int getFrameHeight() { return _frameHeight; }
 
@@ -161,9 +154,6 @@ protected:
 	virtual void setPalette(byte *pal) = 0;
 #else
 	void plotYUV(int width, int height, byte *const *dat);
-	void plotYUV1x(int width, int height, byte *const *dat);
-	void plotYUV2x(int width, int height, byte *const *dat);
-	void plotYUV3x(int width, int height, byte *const *dat);
 #endif
 };
 
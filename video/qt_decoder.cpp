@@ -59,7 +59,8 @@ namespace Video {
 // QuickTimeDecoder
 ////////////////////////////////////////////
 
-QuickTimeDecoder::QuickTimeDecoder() {
+QuickTimeDecoder::QuickTimeDecoder(Audio::Mixer *mixer) {
+	_mixer = mixer ? mixer : g_system->getMixer();
 	_audStream = NULL;
 	_beginOffset = 0;
 	_curFrame = -1;
@@ -121,18 +122,14 @@ uint32 QuickTimeDecoder::getFrameDuration() {
 	if (_videoStreamIndex < 0)
 		return 0;
 
-	uint32 curFrameIndex = 0;
-	for (int32 i = 0; i < _streams[_videoStreamIndex]->stts_count; i++) {
-		curFrameIndex += _streams[_videoStreamIndex]->stts_data[i].count;
-		if ((uint32)_curFrame < curFrameIndex) {
-			// Ok, now we have what duration this frame has.
-			return _streams[_videoStreamIndex]->stts_data[i].duration;
-		}
+	MOVStreamContext *st = _streams[_videoStreamIndex];
+
+	if ((uint32)_curFrame >= st->sampleIndexSize) {
+		// This should never occur
+		error ("Cannot find duration for frame %d", _curFrame);
 	}
 
-	// This should never occur
-	error ("Cannot find duration for frame %d", _curFrame);
-	return 0;
+	return st->sampleIndex[_curFrame].duration;
 }
 
 Graphics::PixelFormat QuickTimeDecoder::getPixelFormat() const {
@@ -145,10 +142,23 @@ Graphics::PixelFormat QuickTimeDecoder::getPixelFormat() const {
 }
 
 uint32 QuickTimeDecoder::findKeyFrame(uint32 frame) const {
-	for (int i = _streams[_videoStreamIndex]->keyframe_count - 1; i >= 0; i--)
-		if (_streams[_videoStreamIndex]->keyframes[i] <= frame)
-				return _streams[_videoStreamIndex]->keyframes[i];
-	
+	const uint32 *keyframes = _streams[_videoStreamIndex]->keyframes;
+
+	// The key frames are sorted, find the last one up to the frame
+	uint32 lo = 0, hi = _streams[_videoStreamIndex]->keyframe_count;
+
+	while (lo < hi) {
+		uint32 mid = (lo + hi) / 2;
+
+		if (keyframes[mid] <= frame)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo > 0)
+		return keyframes[lo - 1];
+
 	// If none found, we'll assume the requested frame is a key frame
 	return frame;
 }
@@ -160,21 +170,17 @@ void QuickTimeDecoder::seekToFrame(uint32 frame) {
 	// Stop all audio (for now)
 	stopAudio();
 
-	// Track down the keyframe
-	_curFrame = findKeyFrame(frame) - 1;
+	// Track down the keyframe. If we're already past it, and not past the
+	// frame, just keep on decoding from where we are.
+	int32 keyFrame = findKeyFrame(frame);
+	if (_curFrame < keyFrame || _curFrame >= (int32)frame)
+		_curFrame = keyFrame - 1;
+
 	while (_curFrame < (int32)frame - 1)
 		decodeNextFrame();
 
 	// Map out the starting point
-	_nextFrameStartTime = 0;
-	uint32 curFrame = 0;
-
-	for (int32 i = 0; i < _streams[_videoStreamIndex]->stts_count && curFrame < frame; i++) {
-		for (int32 j = 0; j < _streams[_videoStreamIndex]->stts_data[i].count && curFrame < frame; j++) {
-			curFrame++;
-			_nextFrameStartTime += _streams[_videoStreamIndex]->stts_data[i].duration;
-		}
-	}
+	_nextFrameStartTime = _streams[_videoStreamIndex]->sampleIndex[frame].startTime;
 
 	// Adjust the video starting point
 	const Audio::Timestamp curVideoTime(0, _nextFrameStartTime, _streams[_videoStreamIndex]->time_scale);
@@ -190,31 +196,42 @@ void QuickTimeDecoder::seekToFrame(uint32 frame) {
 		_audStream = Audio::makeQueuingAudioStream(entry->sampleRate, entry->channels == 2);
 
 		// First, we need to track down what audio sample we need
+		// That's the number of samples which end before the video time
 		Audio::Timestamp curAudioTime(0, _streams[_audioStreamIndex]->time_scale);
 		uint sample = 0;
-		bool done = false;
-		for (int32 i = 0; i < _streams[_audioStreamIndex]->stts_count && !done; i++) {
-			for (int32 j = 0; j < _streams[_audioStreamIndex]->stts_data[i].count; j++) {
-				curAudioTime = curAudioTime.addFrames(_streams[_audioStreamIndex]->stts_data[i].duration);
-
-				if (curAudioTime > curVideoTime) {
-					done = true;
-					break;
-				}
+		for (int32 i = 0; i < _streams[_audioStreamIndex]->stts_count; i++) {
+			const MOVstts &stts = _streams[_audioStreamIndex]->stts_data[i];
+			Audio::Timestamp entryEnd = curAudioTime.addFrames(stts.count * stts.duration);
+
+			if (entryEnd <= curVideoTime) {
+				curAudioTime = entryEnd;
+				sample += stts.count;
+				continue;
+			}
+
+			// Binary search for the last sample within this entry
+			int32 lo = 0, hi = stts.count;
+			while (lo < hi) {
+				int32 mid = (lo + hi + 1) / 2;
 
-				sample++;
+				if (curAudioTime.addFrames(mid * stts.duration) <= curVideoTime)
+					lo = mid;
+				else
+					hi = mid - 1;
 			}
+
+			sample += lo;
+			break;
 		}
 
 		// Now to track down what chunk it's in
 		_curAudioChunk = 0;
 		uint32 totalSamples = 0;
+		int sampleToChunkIndex = -1;
 		for (uint32 i = 0; i < _streams[_audioStreamIndex]->chunk_count; i++, _curAudioChunk++) {
-			int sampleToChunkIndex = -1;
-
-			for (uint32 j = 0; j < _streams[_audioStreamIndex]->sample_to_chunk_sz; j++)
-				if (i >= _streams[_audioStreamIndex]->sample_to_chunk[j].first)
-					sampleToChunkIndex = j;
+			// The sample to chunk entries are sorted by their first chunk
+			while (sampleToChunkIndex + 1 < (int)_streams[_audioStreamIndex]->sample_to_chunk_sz && i >= _streams[_audioStreamIndex]->sample_to_chunk[sampleToChunkIndex + 1].first)
+				sampleToChunkIndex++;
 
 			assert(sampleToChunkIndex >= 0);
 
@@ -247,23 +264,22 @@ void QuickTimeDecoder::seekToTime(Audio::Timestamp time) {
 	if (_videoStreamIndex < 0)
 		error("Audio-only seeking not supported");
 
-	// Try to find the last frame that should have been decoded
-	uint32 frame = 0;
-	Audio::Timestamp totalDuration(0, _streams[_videoStreamIndex]->time_scale);
-	bool done = false;
-
-	for (int32 i = 0; i < _streams[_videoStreamIndex]->stts_count && !done; i++) {
-		for (int32 j = 0; j < _streams[_videoStreamIndex]->stts_data[i].count; j++) {
-			totalDuration = totalDuration.addFrames(_streams[_videoStreamIndex]->stts_data[i].duration);
-			if (totalDuration > time) {
-				done = true;
-				break;
-			}
-			frame++;
-		}
+	// Try to find the last frame that should have been decoded, which is
+	// the first one that ends after the time
+	MOVStreamContext *st = _streams[_videoStreamIndex];
+	uint32 lo = 0, hi = st->sampleIndexSize;
+
+	while (lo < hi) {
+		uint32 mid = (lo + hi) / 2;
+		const Audio::Timestamp frameEnd(0, st->sampleIndex[mid].startTime + st->sampleIndex[mid].duration, st->time_scale);
+
+		if (frameEnd > time)
+			hi = mid;
+		else
+			lo = mid + 1;
 	}
 
-	seekToFrame(frame);
+	seekToFrame(lo);
 }
 
 Codec *QuickTimeDecoder::createCodec(uint32 codecTag, byte bitsPerPixel) {
@@ -301,20 +317,20 @@ Codec *QuickTimeDecoder::createCodec(uint32 codecTag, byte bitsPerPixel) {
 void QuickTimeDecoder::startAudio() {
 	if (_audStream) { // No audio/audio not supported
 		updateAudioBuffer();
-		g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, &_audHandle, _audStream);
+		_mixer->playStream(Audio::Mixer::kPlainSoundType, &_audHandle, _audStream);
 	}
 }
 
 void QuickTimeDecoder::stopAudio() {
 	if (_audStream) {
-		g_system->getMixer()->stopHandle(_audHandle);
+		_mixer->stopHandle(_audHandle);
 		_audStream = NULL; // the mixer automatically frees the stream
 	}
 }
 
 void QuickTimeDecoder::pauseVideoIntern(bool pause) {
 	if (_audStream)
-		g_system->getMixer()->pauseHandle(_audHandle, pause);
+		_mixer->pauseHandle(_audHandle, pause);
 }
 
 Codec *QuickTimeDecoder::findDefaultVideoCodec() const {
@@ -392,7 +408,7 @@ bool QuickTimeDecoder::endOfVideo() const {
 
 uint32 QuickTimeDecoder::getElapsedTime() const {
 	if (_audStream)
-		return g_system->getMixer()->getSoundElapsedTime(_audHandle) + _audioStartOffset.msecs();
+		return _mixer->getSoundElapsedTime(_audHandle) + _audioStartOffset.msecs();
 
 	return SeekableVideoDecoder::getElapsedTime();
 }
@@ -518,6 +534,8 @@ void QuickTimeDecoder::init() {
 
 	// Initialize video, if present
 	if (_videoStreamIndex >= 0) {
+		buildSampleIndex(_streams[_videoStreamIndex]);
+
 		for (uint32 i = 0; i < _streams[_videoStreamIndex]->stsdEntryCount; i++) {
 			STSDEntry *entry = &_streams[_videoStreamIndex]->stsdEntries[i];
 			entry->videoCodec = createCodec(entry->codecTag, entry->bitsPerSample & 0x1F);
@@ -1262,58 +1280,77 @@ void QuickTimeDecoder::close() {
 	SeekableVideoDecoder::reset();
 }
 
-Common::SeekableReadStream *QuickTimeDecoder::getNextFramePacket(uint32 &descId) {
-	if (_videoStreamIndex < 0)
-		return NULL;
-
-	// First, we have to track down which chunk holds the sample and which sample in the chunk contains the frame we are looking for.
-	int32 totalSampleCount = 0;
-	int32 sampleInChunk = 0;
-	int32 actualChunk = -1;
+void QuickTimeDecoder::buildSampleIndex(MOVStreamContext *st) {
+	// Flatten the sample tables, so that finding a frame doesn't need to
+	// scan them each time
+	delete[] st->sampleIndex;
+	st->sampleIndex = new MOVsample[st->nb_frames];
+	st->sampleIndexSize = st->nb_frames;
+	memset(st->sampleIndex, 0, st->nb_frames * sizeof(MOVsample));
 
-	for (uint32 i = 0; i < _streams[_videoStreamIndex]->chunk_count; i++) {
-		int32 sampleToChunkIndex = -1;
+	// Frames without a chunk keep a description id of 0
+	uint32 frame = 0;
+	int32 sampleToChunkIndex = -1;
 
-		for (uint32 j = 0; j < _streams[_videoStreamIndex]->sample_to_chunk_sz; j++)
-			if (i >= _streams[_videoStreamIndex]->sample_to_chunk[j].first)
-				sampleToChunkIndex = j;
+	for (uint32 i = 0; i < st->chunk_count && frame < st->nb_frames; i++) {
+		// The sample to chunk entries are sorted by their first chunk
+		while (sampleToChunkIndex + 1 < (int32)st->sample_to_chunk_sz && i >= st->sample_to_chunk[sampleToChunkIndex + 1].first)
+			sampleToChunkIndex++;
 
 		if (sampleToChunkIndex < 0)
 			error("This chunk (%d) is imaginary", sampleToChunkIndex);
 
-		totalSampleCount += _streams[_videoStreamIndex]->sample_to_chunk[sampleToChunkIndex].count;
+		uint32 offset = st->chunk_offsets[i];
 
-		if (totalSampleCount > getCurFrame()) {
-			actualChunk = i;
-			descId = _streams[_videoStreamIndex]->sample_to_chunk[sampleToChunkIndex].id;
-			sampleInChunk = _streams[_videoStreamIndex]->sample_to_chunk[sampleToChunkIndex].count - totalSampleCount + getCurFrame();
-			break;
+		for (uint32 j = 0; j < st->sample_to_chunk[sampleToChunkIndex].count && frame < st->nb_frames; j++, frame++) {
+			MOVsample &sample = st->sampleIndex[frame];
+
+			if (st->sample_size != 0)
+				sample.size = st->sample_size;
+			else if (frame < st->sample_count)
+				sample.size = st->sample_sizes[frame];
+
+			sample.offset = offset;
+			sample.descId = st->sample_to_chunk[sampleToChunkIndex].id;
+			offset += sample.size;
 		}
 	}
 
-	if (actualChunk < 0) {
+	// Then the time of each sample
+	uint32 time = 0;
+	frame = 0;
+
+	for (int32 i = 0; i < st->stts_count; i++) {
+		for (int32 j = 0; j < st->stts_data[i].count && frame < st->nb_frames; j++, frame++) {
+			st->sampleIndex[frame].startTime = time;
+			st->sampleIndex[frame].duration = st->stts_data[i].duration;
+			time += st->stts_data[i].duration;
+		}
+	}
+}
+
+Common::SeekableReadStream *QuickTimeDecoder::getNextFramePacket(uint32 &descId) {
+	if (_videoStreamIndex < 0)
+		return NULL;
+
+	MOVStreamContext *st = _streams[_videoStreamIndex];
+
+	if (getCurFrame() < 0 || getCurFrame() >= (int32)st->sampleIndexSize) {
 		warning ("Could not find data for frame %d", getCurFrame());
 		return NULL;
 	}
 
-	// Next seek to that frame
-	_fd->seek(_streams[_videoStreamIndex]->chunk_offsets[actualChunk]);
+	const MOVsample &sample = st->sampleIndex[getCurFrame()];
 
-	// Then, if the chunk holds more than one frame, seek to where the frame we want is located
-	for (int32 i = getCurFrame() - sampleInChunk; i < getCurFrame(); i++) {
-		if (_streams[_videoStreamIndex]->sample_size != 0)
-			_fd->skip(_streams[_videoStreamIndex]->sample_size);
-		else
-			_fd->skip(_streams[_videoStreamIndex]->sample_sizes[i]);
+	if (!sample.descId) {
+		warning ("Could not find data for frame %d", getCurFrame());
+		return NULL;
 	}
 
-	// Finally, read in the raw data for the frame
-	//printf ("Frame Data[%d]: Offset = %d, Size = %d\n", getCurFrame(), _fd->pos(), _streams[_videoStreamIndex]->sample_sizes[getCurFrame()]);
-
-	if (_streams[_videoStreamIndex]->sample_size != 0)
-		return _fd->readStream(_streams[_videoStreamIndex]->sample_size);
+	descId = sample.descId;
 
-	return _fd->readStream(_streams[_videoStreamIndex]->sample_sizes[getCurFrame()]);
+	_fd->seek(sample.offset);
+	return _fd->readStream(sample.size);
 }
 
 bool QuickTimeDecoder::checkAudioCodecSupport(uint32 tag) {
@@ -1482,6 +1519,8 @@ QuickTimeDecoder::MOVStreamContext::MOVStreamContext() {
 	sample_sizes = 0;
 	keyframe_count = 0;
 	keyframes = 0;
+	sampleIndexSize = 0;
+	sampleIndex = 0;
 	time_scale = 0;
 	time_rate = 0;
 	width = 0;
@@ -1503,6 +1542,7 @@ QuickTimeDecoder::MOVStreamContext::~MOVStreamContext() {
 	delete[] sample_to_chunk;
 	delete[] sample_sizes;
 	delete[] keyframes;
+	delete[] sampleIndex;
 	delete[] stsdEntries;
 	delete[] editList;
 	delete extradata;
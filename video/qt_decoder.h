@@ -60,7 +60,11 @@ namespace Video {
  */
 class QuickTimeDecoder : public SeekableVideoDecoder {
 public:
-	QuickTimeDecoder();
+	/**
+	 * @param mixer  the mixer playing the audio track, or 0 for the mixer
+	 *               of the system
+	 */
+	QuickTimeDecoder(Audio::Mixer *mixer = 0);
 	virtual ~QuickTimeDecoder();
 
 	/**
@@ -150,6 +154,15 @@ private:
 		uint32 id;
 	};
 
+	// One entry of the flattened sample index, built once the movie is parsed
+	struct MOVsample {
+		uint32 offset;
+		uint32 size;
+		uint32 startTime;	///< In the time scale of the stream
+		uint32 duration;
+		uint32 descId;
+	};
+
 	struct EditListEntry {
 		uint32 trackDuration;
 		int32 mediaTime;
@@ -197,6 +210,8 @@ private:
 		uint32 *sample_sizes;
 		uint32 keyframe_count;
 		uint32 *keyframes;
+		uint32 sampleIndexSize;
+		MOVsample *sampleIndex;
 		int32 time_scale;
 		int time_rate;
 
@@ -237,6 +252,7 @@ private:
 	bool checkAudioCodecSupport(uint32 tag);
 	Common::SeekableReadStream *getNextFramePacket(uint32 &descId);
 	uint32 getFrameDuration();
+	void buildSampleIndex(MOVStreamContext *st);
 	void init();
 
 	Audio::QueuingAudioStream *_audStream;
@@ -247,6 +263,7 @@ private:
 	uint32 getAudioChunkSampleCount(uint chunk);
 	int8 _audioStreamIndex;
 	uint _curAudioChunk;
+	Audio::Mixer *_mixer;
 	Audio::SoundHandle _audHandle;
 	Audio::Timestamp _audioStartOffset;
 
@@ -51,72 +51,73 @@ enum SmkBlockTypes {
 /*
  * class BitStream
  * Little-endian bit stream provider.
+ *
+ * Up to 32 bits are buffered, so that Huffman codes can be peeked at and
+ * skipped as a whole. Reading past the end of the buffer returns zeros.
  */
 
 class BitStream {
 public:
 	BitStream(byte *buf, uint32 length)
-		: _buf(buf), _end(buf+length), _bitCount(8) {
-		_curByte = *_buf++;
+		: _buf(buf), _end(buf+length), _bits(0), _bitCount(0) {
+		refill();
 	}
 
-	bool getBit();
-	byte getBits8();
+	bool getBit() {
+		if (_bitCount == 0)
+			refill();
 
-	byte peek8() const;
-	void skip(int n);
+		bool v = _bits & 1;
 
-private:
-	byte *_buf;
-	byte *_end;
-	byte _curByte;
-	byte  _bitCount;
-};
+		_bits >>= 1;
+		--_bitCount;
 
-bool BitStream::getBit() {
-	if (_bitCount == 0) {
-		assert(_buf < _end);
-		_curByte = *_buf++;
-		_bitCount = 8;
+		return v;
 	}
 
-	bool v = _curByte & 1;
+	byte getBits8() {
+		if (_bitCount < 8)
+			refill();
 
-	_curByte >>= 1;
-	--_bitCount;
+		byte v = _bits & 0xFF;
 
-	return v;
-}
+		_bits >>= 8;
+		_bitCount -= 8;
 
-byte BitStream::getBits8() {
-	assert(_buf < _end);
+		return v;
+	}
 
-	byte v = (*_buf << _bitCount) | _curByte;
-	_curByte = *_buf++ >> (8 - _bitCount);
+	/** Return the next n bits (n <= 24), without consuming them. */
+	uint32 peekBits(int n) {
+		if (_bitCount < n)
+			refill();
 
-	return v;
-}
+		return _bits & ((1 << n) - 1);
+	}
 
-byte BitStream::peek8() const {
-	if (_buf == _end)
-		return _curByte;
+	/** Skip n bits, which have to have been peeked at before. */
+	void skip(int n) {
+		assert(n <= _bitCount);
 
-	assert(_buf < _end);
-	return (*_buf << _bitCount) | _curByte;
-}
+		_bits >>= n;
+		_bitCount -= n;
+	}
 
-void BitStream::skip(int n) {
-	assert(n <= 8);
-	_curByte >>= n;
+private:
+	void refill() {
+		while (_bitCount <= 24) {
+			if (_buf < _end)
+				_bits |= (uint32)*_buf++ << _bitCount;
 
-	if (_bitCount >= n) {
-		_bitCount -= n;
-	} else {
-		assert(_buf < _end);
-		_bitCount = _bitCount + 8 - n;
-		_curByte = *_buf++ >> (8 - _bitCount);
+			_bitCount += 8;
+		}
 	}
-}
+
+	byte *_buf;
+	byte *_end;
+	uint32 _bits;
+	int _bitCount;
+};
 
 /*
  * class SmallHuffmanTree
@@ -190,7 +191,7 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 }
 
 uint16 SmallHuffmanTree::getCode(BitStream &bs) {
-	byte peek = bs.peek8();
+	byte peek = bs.peekBits(8);
 	uint16 *p = &_tree[_prefixtree[peek]];
 	bs.skip(_prefixlength[peek]);
 
@@ -220,14 +221,19 @@ private:
 		SMK_NODE = 0x80000000
 	};
 
+	enum {
+		// Codes up to this length are found with a single lookup
+		kLookupBits = 12
+	};
+
 	uint32 decodeTree(uint32 prefix, int length);
 
 	uint32  _treeSize;
 	uint32 *_tree;
 	uint32  _last[3];
 
-	uint32 _prefixtree[256];
-	byte _prefixlength[256];
+	uint32 _prefixtree[1 << kLookupBits];
+	byte _prefixlength[1 << kLookupBits];
 
 	/* Used during construction */
 	BitStream &_bs;
@@ -246,7 +252,7 @@ BigHuffmanTree::BigHuffmanTree(BitStream &bs, int allocSize)
 		return;
 	}
 
-	for (uint32 i = 0; i < 256; ++i)
+	for (uint32 i = 0; i < (1 << kLookupBits); ++i)
 		_prefixtree[i] = _prefixlength[i] = 0;
 
 	_loBytes = new SmallHuffmanTree(_bs);
@@ -298,8 +304,8 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 		_tree[_treeSize] = v;
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
+		if (length <= kLookupBits) {
+			for (int i = 0; i < (1 << kLookupBits); i += (1 << length)) {
 				_prefixtree[prefix | i] = _treeSize;
 				_prefixlength[prefix | i] = length;
 			}
@@ -318,9 +324,9 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint32 t = _treeSize++;
 
-	if (length == 8) {
+	if (length == kLookupBits) {
 		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
+		_prefixlength[prefix] = kLookupBits;
 	}
 
 	uint32 r1 = decodeTree(prefix, length + 1);
@@ -332,7 +338,7 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 }
 
 uint32 BigHuffmanTree::getCode(BitStream &bs) {
-	byte peek = bs.peek8();
+	uint32 peek = bs.peekBits(kLookupBits);
 	uint32 *p = &_tree[_prefixtree[peek]];
 	bs.skip(_prefixlength[peek]);
 
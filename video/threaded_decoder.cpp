@@ -0,0 +1,344 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#include "video/threaded_decoder.h"
+
+#include "common/system.h"
+#include "common/timer.h"
+
+namespace Video {
+
+enum {
+	// How often the timer tries to decode another frame, in microseconds
+	kDecodeInterval = 10000
+};
+
+Common::Array<ThreadedVideoDecoder *> ThreadedVideoDecoder::_instances;
+
+ThreadedVideoDecoder::ThreadedVideoDecoder(VideoDecoder *decoder, uint queueLength) : _decoder(decoder) {
+	assert(_decoder);
+	assert(queueLength > 0);
+
+	// One more slot than queued frames, for the frame being displayed
+	_frames.resize(queueLength + 1);
+	for (uint i = 0; i < _frames.size(); i++) {
+		_frames[i] = new Frame();
+		_frames[i]->frameNum = -1;
+		_frames[i]->time = 0;
+		_frames[i]->dirtyPalette = false;
+	}
+
+	_queueHead = 0;
+	_queueSize = 0;
+	_dirtyPalette = false;
+	memset(_palette, 0, sizeof(_palette));
+	memset(&_stats, 0, sizeof(_stats));
+
+	_instances.push_back(this);
+	g_system->getTimerManager()->installTimerProc(&timerProc, kDecodeInterval, this);
+}
+
+ThreadedVideoDecoder::~ThreadedVideoDecoder() {
+	// Removing a timer proc removes it for all the instances, so the timers
+	// of the other instances have to be installed again.
+	Common::TimerManager *timerManager = g_system->getTimerManager();
+	timerManager->removeTimerProc(&timerProc);
+
+	for (uint i = 0; i < _instances.size(); i++) {
+		if (_instances[i] == this) {
+			_instances.remove_at(i);
+			break;
+		}
+	}
+
+	for (uint i = 0; i < _instances.size(); i++)
+		timerManager->installTimerProc(&timerProc, kDecodeInterval, _instances[i]);
+
+	delete _decoder;
+
+	for (uint i = 0; i < _frames.size(); i++) {
+		_frames[i]->surface.free();
+		delete _frames[i];
+	}
+}
+
+bool ThreadedVideoDecoder::loadFile(const Common::String &filename) {
+	Common::StackLock lock(_mutex);
+
+	_decoder->close();
+	flushQueue();
+	reset();
+	_dirtyPalette = false;
+	memset(&_stats, 0, sizeof(_stats));
+
+	if (!_decoder->loadFile(filename))
+		return false;
+
+	takeInitialPalette();
+	return true;
+}
+
+bool ThreadedVideoDecoder::loadStream(Common::SeekableReadStream *stream) {
+	Common::StackLock lock(_mutex);
+
+	_decoder->close();
+	flushQueue();
+	reset();
+	_dirtyPalette = false;
+	memset(&_stats, 0, sizeof(_stats));
+
+	if (!_decoder->loadStream(stream))
+		return false;
+
+	takeInitialPalette();
+	return true;
+}
+
+void ThreadedVideoDecoder::close() {
+	Common::StackLock lock(_mutex);
+
+	_decoder->close();
+	flushQueue();
+	reset();
+}
+
+bool ThreadedVideoDecoder::isVideoLoaded() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->isVideoLoaded();
+}
+
+uint16 ThreadedVideoDecoder::getWidth() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->getWidth();
+}
+
+uint16 ThreadedVideoDecoder::getHeight() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->getHeight();
+}
+
+Graphics::PixelFormat ThreadedVideoDecoder::getPixelFormat() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->getPixelFormat();
+}
+
+const byte *ThreadedVideoDecoder::getPalette() {
+	Common::StackLock lock(_mutex);
+
+	_dirtyPalette = false;
+	return _palette;
+}
+
+bool ThreadedVideoDecoder::hasDirtyPalette() const {
+	Common::StackLock lock(_mutex);
+	return _dirtyPalette;
+}
+
+uint32 ThreadedVideoDecoder::getFrameCount() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->getFrameCount();
+}
+
+uint32 ThreadedVideoDecoder::getElapsedTime() const {
+	Common::StackLock lock(_mutex);
+	return _decoder->getElapsedTime();
+}
+
+uint32 ThreadedVideoDecoder::getTimeToNextFrame() const {
+	Common::StackLock lock(_mutex);
+
+	// Without queued frames, the wrapped decoder is at the displayed frame
+	if (_queueSize == 0)
+		return _decoder->getTimeToNextFrame();
+
+	const uint32 elapsedTime = _decoder->getElapsedTime();
+	const uint32 nextFrameTime = _frames[_queueHead]->time;
+
+	if (nextFrameTime <= elapsedTime)
+		return 0;
+
+	return nextFrameTime - elapsedTime;
+}
+
+bool ThreadedVideoDecoder::endOfVideo() const {
+	Common::StackLock lock(_mutex);
+	return _queueSize == 0 && _decoder->endOfVideo();
+}
+
+const Graphics::Surface *ThreadedVideoDecoder::decodeNextFrame() {
+	Common::StackLock lock(_mutex);
+
+	Frame *frame = _frames[_queueHead];
+	_queueHead = (_queueHead + 1) % _frames.size();
+
+	if (_queueSize > 0) {
+		_queueSize--;
+	} else {
+		// The queue could not keep up, decode the frame right now. The first
+		// frame is always decoded here, and doesn't count as late.
+		if (_curFrame >= 0)
+			_stats.framesLate++;
+
+		decodeFrame(*frame);
+	}
+
+	_curFrame = frame->frameNum;
+
+	if (frame->dirtyPalette) {
+		memcpy(_palette, frame->palette, sizeof(_palette));
+		_dirtyPalette = true;
+	}
+
+	if (!frame->surface.pixels)
+		return 0;
+
+	return &frame->surface;
+}
+
+uint ThreadedVideoDecoder::getQueueDepth() const {
+	Common::StackLock lock(_mutex);
+	return _queueSize;
+}
+
+ThreadedVideoDecoder::Statistics ThreadedVideoDecoder::getStatistics() const {
+	Common::StackLock lock(_mutex);
+	return _stats;
+}
+
+void ThreadedVideoDecoder::pauseVideoIntern(bool pause) {
+	Common::StackLock lock(_mutex);
+	_decoder->pauseVideo(pause);
+}
+
+bool ThreadedVideoDecoder::decodeFrame(Frame &frame) {
+	// Remember when the frame is due, before the wrapped decoder moves on
+	frame.time = _decoder->getElapsedTime() + _decoder->getTimeToNextFrame();
+
+	const Graphics::Surface *surface = _decoder->decodeNextFrame();
+	frame.frameNum = _decoder->getCurFrame();
+
+	if (surface) {
+		if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.bytesPerPixel != surface->bytesPerPixel)
+			frame.surface.create(surface->w, surface->h, surface->bytesPerPixel);
+
+		const byte *src = (const byte *)surface->pixels;
+		byte *dst = (byte *)frame.surface.pixels;
+		for (uint16 y = 0; y < surface->h; y++) {
+			memcpy(dst, src, surface->w * surface->bytesPerPixel);
+			src += surface->pitch;
+			dst += frame.surface.pitch;
+		}
+	} else {
+		// No new image, the previous frame stays on screen
+		frame.surface.free();
+	}
+
+	// The palette belongs to the frame, it must only change once it's shown
+	frame.dirtyPalette = _decoder->hasDirtyPalette();
+	if (frame.dirtyPalette) {
+		const byte *palette = _decoder->getPalette();
+		if (palette)
+			memcpy(frame.palette, palette, sizeof(frame.palette));
+		else
+			frame.dirtyPalette = false;
+	}
+
+	return surface != 0;
+}
+
+void ThreadedVideoDecoder::takeInitialPalette() {
+	// Some decoders know their palette right after loading, don't hold it
+	// back until the first frame is shown
+	if (!_decoder->hasDirtyPalette())
+		return;
+
+	const byte *palette = _decoder->getPalette();
+	if (palette) {
+		memcpy(_palette, palette, sizeof(_palette));
+		_dirtyPalette = true;
+	}
+}
+
+void ThreadedVideoDecoder::flushQueue() {
+	_queueSize = 0;
+}
+
+void ThreadedVideoDecoder::decodeAhead() {
+	Common::StackLock lock(_mutex);
+
+	// Only start once the first frame has been shown, as many decoders
+	// start their clock then
+	if (_curFrame < 0 || isPaused())
+		return;
+
+	if (_queueSize >= _frames.size() - 1)
+		return;
+
+	if (!_decoder->isVideoLoaded() || _decoder->endOfVideo())
+		return;
+
+	// Decode a single frame each time, so that the other timers don't
+	// have to wait for too long
+	Frame &frame = *_frames[(_queueHead + _queueSize) % _frames.size()];
+	decodeFrame(frame);
+	_queueSize++;
+
+	_stats.framesDecodedAhead++;
+	if (_queueSize > _stats.maxQueueDepth)
+		_stats.maxQueueDepth = _queueSize;
+}
+
+void ThreadedVideoDecoder::timerProc(void *refCon) {
+	((ThreadedVideoDecoder *)refCon)->decodeAhead();
+}
+
+SeekableThreadedVideoDecoder::SeekableThreadedVideoDecoder(SeekableVideoDecoder *decoder, uint queueLength) :
+	ThreadedVideoDecoder(decoder, queueLength), _seekableDecoder(decoder) {
+}
+
+void SeekableThreadedVideoDecoder::seekToTime(Audio::Timestamp time) {
+	Common::StackLock lock(_mutex);
+
+	_seekableDecoder->seekToTime(time);
+	flushQueue();
+	_curFrame = _decoder->getCurFrame();
+	resetPauseStartTime();
+}
+
+void SeekableThreadedVideoDecoder::rewind() {
+	Common::StackLock lock(_mutex);
+
+	_seekableDecoder->rewind();
+	flushQueue();
+	_curFrame = _decoder->getCurFrame();
+	resetPauseStartTime();
+}
+
+uint32 SeekableThreadedVideoDecoder::getDuration() const {
+	Common::StackLock lock(_mutex);
+	return _seekableDecoder->getDuration();
+}
+
+} // End of namespace Video
@@ -0,0 +1,159 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * $URL$
+ * $Id$
+ *
+ */
+
+#ifndef VIDEO_THREADED_DECODER_H
+#define VIDEO_THREADED_DECODER_H
+
+#include "common/array.h"
+#include "common/mutex.h"
+
+#include "video/video_decoder.h"
+
+namespace Video {
+
+/**
+ * A VideoDecoder wrapper which decodes the frames of another decoder
+ * ahead of time, from a timer callback, into a small queue of surfaces.
+ * Any decoder can be wrapped, and will then return its frames from
+ * decodeNextFrame() without the caller having to wait for the decoding,
+ * as long as the timer could keep up.
+ *
+ * Frames are only decoded ahead once the first frame has been requested,
+ * so that decoders which start their clock on the first frame keep the
+ * right timing. If the queue runs empty, the next frame is decoded right
+ * away, as the wrapped decoder would have done, and counted as late.
+ *
+ * The timer callback may run on a different thread, so all access to the
+ * wrapped decoder goes through this class, which serializes it. The
+ * wrapped decoder must not be used directly while it is wrapped.
+ *
+ * Use SeekableThreadedVideoDecoder to wrap a seekable decoder.
+ */
+class ThreadedVideoDecoder : public virtual VideoDecoder {
+public:
+	/**
+	 * Statistics about how well the decoding ahead kept up.
+	 */
+	struct Statistics {
+		uint32 framesDecodedAhead;	///< Frames decoded by the timer
+		uint32 framesLate;			///< Frames decoded on request, because the queue was empty
+		uint32 maxQueueDepth;		///< Highest number of frames queued at once
+	};
+
+	/**
+	 * Wrap the given decoder, taking ownership of it.
+	 * @param decoder      the decoder to wrap
+	 * @param queueLength  the maximum number of frames decoded ahead
+	 */
+	ThreadedVideoDecoder(VideoDecoder *decoder, uint queueLength = 4);
+	virtual ~ThreadedVideoDecoder();
+
+	bool loadFile(const Common::String &filename);
+	bool loadStream(Common::SeekableReadStream *stream);
+	void close();
+
+	bool isVideoLoaded() const;
+	uint16 getWidth() const;
+	uint16 getHeight() const;
+	Graphics::PixelFormat getPixelFormat() const;
+	const byte *getPalette();
+	bool hasDirtyPalette() const;
+	uint32 getFrameCount() const;
+	uint32 getElapsedTime() const;
+	uint32 getTimeToNextFrame() const;
+	bool endOfVideo() const;
+	const Graphics::Surface *decodeNextFrame();
+
+	/**
+	 * Returns the number of frames currently decoded ahead.
+	 */
+	uint getQueueDepth() const;
+
+	/**
+	 * Returns the statistics gathered since the video was loaded.
+	 */
+	Statistics getStatistics() const;
+
+protected:
+	void pauseVideoIntern(bool pause);
+	void addPauseTime(uint32 ms) {}
+
+	/** Drops the frames decoded ahead, e.g. after seeking the wrapped decoder */
+	void flushQueue();
+
+	VideoDecoder *_decoder;
+	mutable Common::Mutex _mutex;
+
+private:
+	struct Frame {
+		Graphics::Surface surface;
+		int32 frameNum;			///< The frame number reported by the wrapped decoder
+		uint32 time;			///< The elapsed time at which the frame is due
+		bool dirtyPalette;
+		byte palette[256 * 3];
+	};
+
+	bool decodeFrame(Frame &frame);
+	void takeInitialPalette();
+	void decodeAhead();
+
+	static void timerProc(void *refCon);
+	static Common::Array<ThreadedVideoDecoder *> _instances;
+
+	// Ring of frames: the queue holds _queueSize frames from _queueHead on,
+	// the one slot left over is the frame last returned by decodeNextFrame().
+	Common::Array<Frame *> _frames;
+	uint _queueHead;
+	uint _queueSize;
+
+	bool _dirtyPalette;
+	byte _palette[256 * 3];
+
+	Statistics _stats;
+};
+
+/**
+ * A ThreadedVideoDecoder for seekable decoders. Seeking and rewinding is
+ * passed on to the wrapped decoder, and flushes the queued frames.
+ */
+class SeekableThreadedVideoDecoder : public ThreadedVideoDecoder, public SeekableVideoDecoder {
+public:
+	/**
+	 * Wrap the given seekable decoder, taking ownership of it.
+	 * @see ThreadedVideoDecoder::ThreadedVideoDecoder
+	 */
+	SeekableThreadedVideoDecoder(SeekableVideoDecoder *decoder, uint queueLength = 4);
+
+	void seekToTime(Audio::Timestamp time);
+	void rewind();
+	uint32 getDuration() const;
+
+private:
+	SeekableVideoDecoder *_seekableDecoder;
+};
+
+} // End of namespace Video
+
+#endif